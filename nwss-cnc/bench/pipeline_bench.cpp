@@ -0,0 +1,962 @@
+// pipeline_bench.cpp
+//
+// Benchmark suite for the nwss-cnc-core pipeline stages. Every stage of the
+// SVG -> G-code conversion is timed over the bundled example files and a set
+// of synthetic scaled-up inputs, self-intersection detection is timed on
+// generated outlines of 10k to 1M segments, the medial axis is timed on
+// generated font-like outlines of 10k contours, and the results are written
+// as a Google-Benchmark style JSON report that can be diffed between
+// releases.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "core/cam_processor.h"
+#include "core/config.h"
+#include "core/discretizer.h"
+#include "core/gcode_generator.h"
+#include "core/geometry.h"
+#include "core/log.h"
+#include "core/medial_axis.h"
+#include "core/metrics.h"
+#include "core/path_set.h"
+#include "core/segment_intersector.h"
+#include "core/svg_parser.h"
+#include "core/tool.h"
+#include "core/tool_offset.h"
+#include "core/toolpath_optimizer.h"
+#include "core/transform.h"
+#include "nanosvg.h"
+
+#ifndef NWSS_CNC_EXAMPLES_DIR
+#define NWSS_CNC_EXAMPLES_DIR "examples"
+#endif
+
+#ifndef NWSS_CNC_VERSION
+#define NWSS_CNC_VERSION "unknown"
+#endif
+
+using namespace nwss::cnc;
+
+namespace {
+
+// Tool from the default registry used for offset and CAM stages (1/8" end
+// mill)
+const int kBenchToolId = 1;
+
+// Adaptive sampling tolerance for the flattening benchmarks (GUI default)
+const double kBenchAdaptiveTolerance = 0.1;
+
+// Samples per curve for the dense fixed-sampling benchmark
+const int kBenchDenseSamples = 64;
+
+// Offset rings for the multi-offset benchmark (half a tool apart)
+const int kBenchOffsetRings = 8;
+
+// V-bit from the default registry used for the V-carve stages (60 degrees)
+const int kBenchVBitId = 4;
+
+// Points per contour of the generated glyph outlines (a 5 mm glyph
+// flattened at about 0.05 mm)
+const int kBenchGlyphPoints = 48;
+
+/**
+ * Command line options for the benchmark runner
+ */
+struct BenchOptions {
+  std::string examplesDir = NWSS_CNC_EXAMPLES_DIR;
+  std::string outputFile = "nwss-cnc-bench.json";
+  std::string filter;             // Only run benchmarks containing this text
+  double minTime = 0.5;           // Minimum measured time per benchmark (s)
+  int maxIterations = 1000;       // Upper bound on iterations per benchmark
+  std::vector<int> syntheticScales = {4, 12};  // Grid sizes for synthetic SVGs
+  // Segment counts of the generated self-intersection scaling inputs
+  std::vector<size_t> segmentCounts = {10000, 100000, 1000000};
+  // Contour counts of the generated glyph inputs for the medial axis
+  std::vector<size_t> contourCounts = {10000};
+};
+
+/**
+ * A single benchmark input file
+ */
+struct BenchInput {
+  std::string name;
+  std::string filename;
+  bool temporary = false;  // Generated file, removed after the run
+};
+
+/**
+ * Measured result of one benchmark (stage x input)
+ */
+struct BenchResult {
+  std::string name;
+  std::string stage;
+  std::string input;
+  int iterations = 0;
+  double realTimeNs = 0.0;  // Mean wall time per iteration
+  double cpuTimeNs = 0.0;   // Mean process CPU time per iteration
+  double minTimeNs = 0.0;   // Fastest iteration
+  size_t itemsPerIteration = 0;
+  size_t outputsPerIteration = 0;
+  PipelineStats counters;  // Core library counters of the last iteration
+};
+
+// Peak resident set size of the process so far. The peak never goes down,
+// so it is reported once for the whole run rather than per benchmark.
+long long peakRssBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return static_cast<long long>(counters.PeakWorkingSetSize);
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<long long>(usage.ru_maxrss);  // bytes on macOS
+#else
+  return static_cast<long long>(usage.ru_maxrss) * 1024;  // kilobytes on Linux
+#endif
+#endif
+}
+
+std::string jsonEscape(const std::string &text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+size_t countPoints(const std::vector<Path> &paths) {
+  size_t count = 0;
+  for (const auto &path : paths) {
+    count += path.size();
+  }
+  return count;
+}
+
+size_t countControlPoints(NSVGimage *image) {
+  size_t count = 0;
+  if (!image) return count;
+  for (NSVGshape *shape = image->shapes; shape; shape = shape->next) {
+    for (NSVGpath *path = shape->paths; path; path = path->next) {
+      count += static_cast<size_t>(path->npts);
+    }
+  }
+  return count;
+}
+
+// Append a circle made of four cubic segments to an SVG path string
+void appendCircle(std::ostream &out, double cx, double cy, double r,
+                  bool clockwise) {
+  const double k = 0.5522847498 * r;
+  double s = clockwise ? -1.0 : 1.0;
+  out << "M" << cx + r << "," << cy << " ";
+  out << "C" << cx + r << "," << cy + s * k << " " << cx + k << ","
+      << cy + s * r << " " << cx << "," << cy + s * r << " ";
+  out << "C" << cx - k << "," << cy + s * r << " " << cx - r << ","
+      << cy + s * k << " " << cx - r << "," << cy << " ";
+  out << "C" << cx - r << "," << cy - s * k << " " << cx - k << ","
+      << cy - s * r << " " << cx << "," << cy - s * r << " ";
+  out << "C" << cx + k << "," << cy - s * r << " " << cx + r << ","
+      << cy - s * k << " " << cx + r << "," << cy << " Z ";
+}
+
+/**
+ * Write a synthetic SVG with a grid x grid array of glyph-like cells. Each
+ * cell has a ring (outer circle plus counter) and a concave L-shaped polygon,
+ * which exercises curves, straight segments and hole detection.
+ */
+bool writeSyntheticSvg(const std::string &filename, int grid) {
+  std::ofstream out(filename);
+  if (!out.is_open()) {
+    return false;
+  }
+
+  const double cell = 10.0;
+  const double size = cell * grid;
+  out << std::fixed << std::setprecision(3);
+  out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << size
+      << "mm\" height=\"" << size << "mm\" viewBox=\"0 0 " << size << " "
+      << size << "\">\n";
+
+  for (int row = 0; row < grid; ++row) {
+    for (int col = 0; col < grid; ++col) {
+      double x = col * cell;
+      double y = row * cell;
+
+      out << "<path fill-rule=\"evenodd\" d=\"";
+      appendCircle(out, x + 3.0, y + 3.0, 2.5, false);
+      appendCircle(out, x + 3.0, y + 3.0, 1.2, true);
+      out << "\"/>\n";
+
+      out << "<path d=\"M" << x + 6.2 << "," << y + 1.0 << " L" << x + 9.0
+          << "," << y + 1.0 << " L" << x + 9.0 << "," << y + 3.0 << " L"
+          << x + 7.6 << "," << y + 3.0 << " L" << x + 7.6 << "," << y + 9.0
+          << " L" << x + 6.2 << "," << y + 9.0 << " Z\"/>\n";
+    }
+  }
+
+  out << "</svg>\n";
+  return out.good();
+}
+
+/**
+ * Build a closed outline of the given number of segments with a wavy edge.
+ * The outline does not cross itself unless crossingSpacing is non-zero, in
+ * which case every crossingSpacing-th pair of points is swapped to tie a
+ * small bow-tie into the edge.
+ */
+Path makeWavyOutline(size_t segments, size_t crossingSpacing) {
+  Path path;
+  Point2D *points = path.appendPoints(segments);
+  const double twoPi = 2.0 * 3.14159265358979323846;
+  for (size_t i = 0; i < segments; ++i) {
+    double angle = twoPi * i / segments;
+    double radius = 500.0 + 5.0 * std::sin(angle * 400.0);
+    points[i] = Point2D(radius * std::cos(angle), radius * std::sin(angle));
+  }
+  if (crossingSpacing > 0) {
+    for (size_t i = 1; i + 2 < segments; i += crossingSpacing) {
+      std::swap(points[i], points[i + 1]);
+    }
+  }
+  return path;
+}
+
+/**
+ * Build letter-like regions with the given total number of contours: a
+ * row-major grid of 5 mm "o" glyphs, each an outline with a counter (hole)
+ * of different stroke widths, as text set in a flattened font would give.
+ * The outline of every region comes first, then its hole.
+ */
+std::vector<std::vector<Path>> makeGlyphRegions(size_t contours) {
+  const double twoPi = 2.0 * 3.14159265358979323846;
+  const double cell = 6.0;
+  size_t glyphs = (contours + 1) / 2;
+  size_t columns = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(glyphs))));
+
+  auto ellipse = [twoPi](double cx, double cy, double rx, double ry,
+                         bool clockwise) {
+    Path ring;
+    Point2D *points = ring.appendPoints(kBenchGlyphPoints);
+    for (int i = 0; i < kBenchGlyphPoints; ++i) {
+      double angle = twoPi * i / kBenchGlyphPoints;
+      points[i] = Point2D(cx + rx * std::cos(angle),
+                          cy + (clockwise ? -ry : ry) * std::sin(angle));
+    }
+    return ring;
+  };
+
+  std::vector<std::vector<Path>> regions;
+  regions.reserve(glyphs);
+  for (size_t i = 0; i < glyphs; ++i) {
+    double cx = cell * (i % columns) + cell / 2.0;
+    double cy = cell * (i / columns) + cell / 2.0;
+    double stroke = 0.4 + 0.1 * (i % 7);
+    std::vector<Path> region;
+    region.push_back(ellipse(cx, cy, 2.0, 2.5, false));
+    if (2 * i + 1 < contours) {
+      region.push_back(ellipse(cx, cy, 2.0 - stroke, 2.5 - stroke, true));
+    }
+    regions.push_back(std::move(region));
+  }
+  return regions;
+}
+
+/**
+ * Runs a stage repeatedly and records timing. The setup callback prepares a
+ * fresh input for every iteration outside the timed region; the run callback
+ * performs the measured work and returns the number of output items.
+ */
+template <typename State>
+BenchResult measure(const BenchOptions &options, const std::string &stage,
+                    const std::string &input, size_t itemsPerIteration,
+                    const std::function<State()> &setup,
+                    const std::function<size_t(State &)> &run) {
+  using Clock = std::chrono::steady_clock;
+
+  BenchResult result;
+  result.stage = stage;
+  result.input = input;
+  result.name = stage + "/" + input;
+  result.itemsPerIteration = itemsPerIteration;
+
+  double totalNs = 0.0;
+  double totalCpuNs = 0.0;
+  double fastestNs = 0.0;
+  PipelineProfiler profiler;
+
+  while (result.iterations < options.maxIterations) {
+    State state = setup();
+
+    profiler.reset();
+    profiler.start();
+    std::clock_t cpuStart = std::clock();
+    Clock::time_point start = Clock::now();
+    result.outputsPerIteration = run(state);
+    Clock::time_point end = Clock::now();
+    std::clock_t cpuEnd = std::clock();
+    profiler.stop();
+
+    double elapsedNs =
+        std::chrono::duration<double, std::nano>(end - start).count();
+    totalNs += elapsedNs;
+    totalCpuNs += 1e9 * static_cast<double>(cpuEnd - cpuStart) /
+                  static_cast<double>(CLOCKS_PER_SEC);
+    if (result.iterations == 0 || elapsedNs < fastestNs) {
+      fastestNs = elapsedNs;
+    }
+    result.iterations++;
+
+    if (totalNs >= options.minTime * 1e9) {
+      break;
+    }
+  }
+
+  result.realTimeNs = totalNs / result.iterations;
+  result.cpuTimeNs = totalCpuNs / result.iterations;
+  result.minTimeNs = fastestNs;
+  result.counters = profiler.stats();
+  return result;
+}
+
+CNConfig makeBenchConfig() {
+  // Large material so inputs are translated but never rescaled, keeping the
+  // geometry identical between runs and releases
+  CNConfig config;
+  config.setBedWidth(2000.0);
+  config.setBedHeight(2000.0);
+  config.setMaterialWidth(2000.0);
+  config.setMaterialHeight(2000.0);
+  config.setMaterialThickness(10.0);
+  config.setCutDepth(1.0);
+  config.setPassCount(1);
+  return config;
+}
+
+const char *cutoutModeName(CutoutMode mode) {
+  switch (mode) {
+    case CutoutMode::PERIMETER:
+      return "perimeter";
+    case CutoutMode::PUNCHOUT:
+      return "punchout";
+    case CutoutMode::POCKET:
+      return "pocket";
+    case CutoutMode::ENGRAVE:
+      return "engrave";
+    case CutoutMode::ADAPTIVE:
+      return "adaptive";
+  }
+  return "unknown";
+}
+
+class BenchRunner {
+ public:
+  explicit BenchRunner(const BenchOptions &options) : m_options(options) {
+    m_config = makeBenchConfig();
+    m_registry.loadDefaultTools();
+  }
+
+  void runInput(const BenchInput &input) {
+    std::cerr << "Benchmarking " << input.name << " (" << input.filename
+              << ")" << std::endl;
+
+    // Load once to gather reference data for the later stages
+    SVGParser parser;
+    if (!parser.loadFromFile(input.filename, "mm", 96.0f)) {
+      std::cerr << "  Skipping: failed to parse " << input.filename
+                << std::endl;
+      return;
+    }
+    size_t controlPoints = countControlPoints(parser.getRawImage());
+
+    Discretizer discretizer;
+    std::vector<Path> rawPaths =
+        discretizer.discretizeImage(parser.getRawImage());
+    size_t rawPoints = countPoints(rawPaths);
+
+    std::vector<Path> fittedPaths = rawPaths;
+    Transform::fitToMaterial(fittedPaths, m_config);
+    size_t fittedPoints = countPoints(fittedPaths);
+
+    // SVG parse
+    add(measure<int>(
+        m_options, "parse", input.name, controlPoints, [] { return 0; },
+        [&input](int &) -> size_t {
+          SVGParser local;
+          local.loadFromFile(input.filename, "mm", 96.0f);
+          return static_cast<size_t>(local.getShapeCount());
+        }));
+
+    // Discretization (points/s measured on emitted points)
+    add(measure<int>(
+        m_options, "discretize", input.name, rawPoints, [] { return 0; },
+        [&discretizer, &parser](int &) -> size_t {
+          return discretizer.discretizeImage(parser.getRawImage()).size();
+        }));
+
+    // Serial discretization, to track the parallel speedup
+    Discretizer serialDiscretizer;
+    DiscretizerConfig serialConfig;
+    serialConfig.threadCount = 1;
+    serialDiscretizer.setConfig(serialConfig);
+    add(measure<int>(
+        m_options, "discretize_serial", input.name, rawPoints,
+        [] { return 0; },
+        [&serialDiscretizer, &parser](int &) -> size_t {
+          return serialDiscretizer.discretizeImage(parser.getRawImage())
+              .size();
+        }));
+
+    // Discretization into a structure-of-arrays PathSet, reused between
+    // runs the way a caller converting several files would
+    PathSet reusedSet;
+    add(measure<int>(
+        m_options, "discretize_pathset", input.name, rawPoints,
+        [] { return 0; },
+        [&discretizer, &parser, &reusedSet](int &) -> size_t {
+          discretizer.discretizeImage(parser.getRawImage(), reusedSet);
+          return reusedSet.size();
+        }));
+
+    // Dense fixed sampling as used for smooth fonts (batch evaluator path)
+    Discretizer denseDiscretizer;
+    DiscretizerConfig denseConfig;
+    denseConfig.bezierSamples = kBenchDenseSamples;
+    denseConfig.maxPointDistance = 0.0;
+    denseDiscretizer.setConfig(denseConfig);
+    size_t densePoints =
+        countPoints(denseDiscretizer.discretizeImage(parser.getRawImage()));
+    add(measure<int>(
+        m_options, "discretize_dense", input.name, densePoints,
+        [] { return 0; },
+        [&denseDiscretizer, &parser](int &) -> size_t {
+          return denseDiscretizer.discretizeImage(parser.getRawImage()).size();
+        }));
+
+    // Adaptive flattening with each method (points/s on emitted points)
+    const FlatteningMethod methods[] = {FlatteningMethod::SUBDIVISION,
+                                        FlatteningMethod::WANG};
+    for (FlatteningMethod method : methods) {
+      Discretizer adaptiveDiscretizer;
+      DiscretizerConfig adaptiveConfig;
+      adaptiveConfig.adaptiveSampling = kBenchAdaptiveTolerance;
+      adaptiveConfig.flatteningMethod = method;
+      adaptiveDiscretizer.setConfig(adaptiveConfig);
+      size_t adaptivePoints = countPoints(
+          adaptiveDiscretizer.discretizeImage(parser.getRawImage()));
+      std::string name = method == FlatteningMethod::WANG
+                             ? "discretize_wang"
+                             : "discretize_subdivision";
+      add(measure<int>(
+          m_options, name, input.name, adaptivePoints, [] { return 0; },
+          [&adaptiveDiscretizer, &parser](int &) -> size_t {
+            return adaptiveDiscretizer.discretizeImage(parser.getRawImage())
+                .size();
+          }));
+    }
+
+    // Transform to material
+    add(measure<std::vector<Path>>(
+        m_options, "fit_to_material", input.name, rawPoints,
+        [&rawPaths] { return rawPaths; },
+        [this](std::vector<Path> &paths) -> size_t {
+          Transform::fitToMaterial(paths, m_config);
+          return paths.size();
+        }));
+
+    // Transform to material on a PathSet
+    PathSet rawSet(rawPaths);
+    add(measure<PathSet>(
+        m_options, "fit_to_material_pathset", input.name, rawPoints,
+        [&rawSet] { return rawSet; },
+        [this](PathSet &paths) -> size_t {
+          Transform::fitToMaterial(paths, m_config);
+          return paths.size();
+        }));
+
+    // Tool offset over the whole design
+    const Tool *tool = m_registry.getTool(kBenchToolId);
+    double toolDiameter = tool ? tool->diameter : 3.175;
+    add(measure<int>(
+        m_options, "tool_offset", input.name, fittedPoints, [] { return 0; },
+        [&fittedPaths, toolDiameter](int &) -> size_t {
+          ToolOffset::OffsetResult result = ToolOffset::calculateToolOffset(
+              fittedPaths, toolDiameter, ToolOffsetDirection::OUTSIDE);
+          return result.paths.size();
+        }));
+
+    // A family of roughing offsets from one prepared input, across the pool
+    // and on one thread
+    std::vector<double> ringDistances;
+    for (int i = 0; i < kBenchOffsetRings; ++i) {
+      ringDistances.push_back(toolDiameter * (0.5 + 0.5 * i));
+    }
+    for (int threads : {0, 1}) {
+      ToolOffset::OffsetOptions ringOptions;
+      ringOptions.validateResults = false;
+      ringOptions.threadCount = threads;
+      add(measure<int>(
+          m_options, threads == 1 ? "multi_offsets_serial" : "multi_offsets",
+          input.name, fittedPoints, [] { return 0; },
+          [&fittedPaths, &ringDistances, toolDiameter,
+           ringOptions](int &) -> size_t {
+            auto results = ToolOffset::calculateMultipleOffsets(
+                fittedPaths, toolDiameter, ringDistances, ringOptions);
+            size_t rings = 0;
+            for (const auto &result : results) {
+              rings += result.paths.size();
+            }
+            return rings;
+          }));
+    }
+
+    // Minimum feature size (clearance between facing walls)
+    add(measure<int>(
+        m_options, "feature_size", input.name, fittedPoints, [] { return 0; },
+        [&fittedPaths](int &) -> size_t {
+          return ToolOffset::calculateMinimumFeatureSize(fittedPaths) > 0.0;
+        }));
+
+    // Tool offsets as applied by the G-code generator: one ToolOffset call
+    // per path, then all paths in a single batched call
+    for (bool batch : {false, true}) {
+      add(measure<int>(
+          m_options, batch ? "gcode_offsets_batch" : "gcode_offsets",
+          input.name, fittedPoints, [] { return 0; },
+          [this, &fittedPaths, batch](int &) -> size_t {
+            GCodeGenerator generator;
+            GCodeOptions gcodeOptions;
+            gcodeOptions.selectedToolId = kBenchToolId;
+            gcodeOptions.validateFeatureSizes = false;
+            gcodeOptions.batchToolOffsets = batch;
+            generator.setConfig(m_config);
+            generator.setToolRegistry(m_registry);
+            generator.setOptions(gcodeOptions);
+            return generator.generateGCodeString(fittedPaths).size();
+          }));
+    }
+
+    // CAM processing for every cutout mode
+    const CutoutMode modes[] = {CutoutMode::PERIMETER, CutoutMode::PUNCHOUT,
+                                CutoutMode::POCKET, CutoutMode::ENGRAVE,
+                                CutoutMode::ADAPTIVE};
+    for (CutoutMode mode : modes) {
+      std::string stage = std::string("cam_") + cutoutModeName(mode);
+      add(measure<int>(
+          m_options, stage, input.name, fittedPoints, [] { return 0; },
+          [this, &fittedPaths, mode](int &) -> size_t {
+            CAMProcessor processor;
+            processor.setConfig(m_config);
+            processor.setToolRegistry(m_registry);
+            CutoutParams params;
+            params.mode = mode;
+            CAMOperationResult result =
+                processor.processForCAM(fittedPaths, params, kBenchToolId);
+            return result.toolpaths.size();
+          }));
+    }
+
+    // G-code emission (perimeter, no offsets: the GUI conversion default)
+    add(measure<int>(
+        m_options, "gcode_string", input.name, fittedPoints, [] { return 0; },
+        [this, &fittedPaths](int &) -> size_t {
+          GCodeGenerator generator;
+          GCodeOptions gcodeOptions;
+          gcodeOptions.enableToolOffsets = false;
+          gcodeOptions.validateFeatureSizes = false;
+          generator.setConfig(m_config);
+          generator.setToolRegistry(m_registry);
+          generator.setOptions(gcodeOptions);
+          return generator.generateGCodeString(fittedPaths).size();
+        }));
+
+    // Same, streamed from a PathSet
+    PathSet fittedSet(fittedPaths);
+    add(measure<int>(
+        m_options, "gcode_pathset", input.name, fittedPoints, [] { return 0; },
+        [this, &fittedSet](int &) -> size_t {
+          GCodeGenerator generator;
+          GCodeOptions gcodeOptions;
+          gcodeOptions.enableToolOffsets = false;
+          gcodeOptions.validateFeatureSizes = false;
+          generator.setConfig(m_config);
+          generator.setToolRegistry(m_registry);
+          generator.setOptions(gcodeOptions);
+          std::ostringstream out;
+          generator.generateGCode(fittedSet, out);
+          return out.str().size();
+        }));
+
+    // V-carving with the V-bit
+    add(measure<int>(
+        m_options, "cam_vcarve", input.name, fittedPoints, [] { return 0; },
+        [this, &fittedPaths](int &) -> size_t {
+          CAMProcessor processor;
+          processor.setConfig(m_config);
+          processor.setToolRegistry(m_registry);
+          CutoutParams params;
+          params.mode = CutoutMode::ENGRAVE;
+          CAMOperationResult result =
+              processor.processForCAM(fittedPaths, params, kBenchVBitId);
+          return result.toolpaths.size();
+        }));
+
+    // Travel ordering of the design's paths
+    add(measure<std::vector<Path>>(
+        m_options, "path_order", input.name, fittedPoints,
+        [&fittedPaths] { return fittedPaths; },
+        [](std::vector<Path> &paths) -> size_t {
+          ToolpathOptimizer().optimize(paths);
+          return paths.size();
+        }));
+  }
+
+  // Self-intersection detection over one large outline
+  void runIntersectionScaling(size_t segments) {
+    std::string input = "segments_" + std::to_string(segments);
+    std::cerr << "Benchmarking " << input << std::endl;
+
+    // A simple outline has to be swept completely
+    Path outline = makeWavyOutline(segments, 0);
+    add(measure<int>(
+        m_options, "self_intersections", input, segments, [] { return 0; },
+        [&outline](int &) -> size_t {
+          return SegmentIntersector::hasSelfIntersections(outline, true);
+        }));
+
+    // Report every crossing (one per thousand segments)
+    Path crossing = makeWavyOutline(segments, 1000);
+    add(measure<int>(
+        m_options, "self_intersections_all", input, segments,
+        [] { return 0; },
+        [&crossing](int &) -> size_t {
+          return SegmentIntersector::findSelfIntersections(crossing, true)
+              .size();
+        }));
+  }
+
+  // Medial axis over many small regions, as for V-carving text
+  void runMedialAxisScaling(size_t contours) {
+    std::string input = "contours_" + std::to_string(contours);
+    std::cerr << "Benchmarking " << input << std::endl;
+
+    std::vector<std::vector<Path>> regions = makeGlyphRegions(contours);
+    std::vector<Path> rings;
+    for (const auto &region : regions) {
+      rings.insert(rings.end(), region.begin(), region.end());
+    }
+    size_t points = countPoints(rings);
+
+    // Narrowest feature width of every glyph (one sample per edge), on one
+    // thread and across the pool
+    std::vector<std::vector<PathView>> regionRings;
+    std::vector<std::vector<char>> regionHoles;
+    for (const auto &region : regions) {
+      regionRings.emplace_back(region.begin(), region.end());
+      std::vector<char> holes(region.size(), 1);
+      holes[0] = 0;
+      regionHoles.push_back(std::move(holes));
+    }
+    for (int threads : {1, 0}) {
+      MedialAxis::Options axisOptions;
+      axisOptions.threadCount = threads;
+      add(measure<int>(
+          m_options, threads == 1 ? "medial_axis_serial" : "medial_axis",
+          input, points, [] { return 0; },
+          [&regionRings, &regionHoles, axisOptions](int &) -> size_t {
+            MedialAxis axis(axisOptions);
+            size_t features = 0;
+            for (size_t i = 0; i < regionRings.size(); ++i) {
+              double width = 0.0;
+              features +=
+                  axis.narrowestWidth(regionRings[i], regionHoles[i], width);
+            }
+            return features;
+          }));
+    }
+
+    // Full V-carve of the glyphs: hierarchy, medial axis and toolpaths
+    add(measure<int>(
+        m_options, "cam_vcarve", input, points, [] { return 0; },
+        [this, &rings](int &) -> size_t {
+          CAMProcessor processor;
+          processor.setConfig(m_config);
+          processor.setToolRegistry(m_registry);
+          CutoutParams params;
+          params.mode = CutoutMode::ENGRAVE;
+          CAMOperationResult result =
+              processor.processForCAM(rings, params, kBenchVBitId);
+          return result.toolpaths.size();
+        }));
+  }
+
+  bool writeReport(const std::string &filename) const {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+      std::cerr << "Error: Could not open report file for writing: "
+                << filename << std::endl;
+      return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char dateBuffer[64];
+    std::strftime(dateBuffer, sizeof(dateBuffer), "%Y-%m-%dT%H:%M:%S",
+                  std::localtime(&now));
+
+    out << std::setprecision(15);
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << dateBuffer << "\",\n";
+    out << "    \"version\": \"" << jsonEscape(NWSS_CNC_VERSION) << "\",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\",\n";
+#else
+    out << "    \"library_build_type\": \"debug\",\n";
+#endif
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ",\n";
+    out << "    \"min_time_s\": " << m_options.minTime << ",\n";
+    out << "    \"max_iterations\": " << m_options.maxIterations << ",\n";
+    out << "    \"run_peak_rss_bytes\": " << peakRssBytes() << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < m_results.size(); ++i) {
+      const BenchResult &r = m_results[i];
+      double seconds = r.realTimeNs * 1e-9;
+      double pointsPerSecond =
+          seconds > 0.0 ? static_cast<double>(r.itemsPerIteration) / seconds
+                        : 0.0;
+
+      out << "    {\n";
+      out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+      out << "      \"stage\": \"" << jsonEscape(r.stage) << "\",\n";
+      out << "      \"input\": \"" << jsonEscape(r.input) << "\",\n";
+      out << "      \"iterations\": " << r.iterations << ",\n";
+      out << "      \"real_time\": " << r.realTimeNs << ",\n";
+      out << "      \"cpu_time\": " << r.cpuTimeNs << ",\n";
+      out << "      \"min_time\": " << r.minTimeNs << ",\n";
+      out << "      \"time_unit\": \"ns\",\n";
+      out << "      \"points\": " << r.itemsPerIteration << ",\n";
+      out << "      \"points_per_second\": " << pointsPerSecond << ",\n";
+      out << "      \"outputs\": " << r.outputsPerIteration << ",\n";
+      out << "      \"counters\": {\"bezier_segments\": "
+          << r.counters.bezierSegments
+          << ", \"emitted_points\": " << r.counters.emittedPoints
+          << ", \"clipper_calls\": " << r.counters.clipperCalls
+          << ", \"offset_passes\": " << r.counters.offsetPasses
+          << ", \"toolpaths\": " << r.counters.toolpaths
+          << ", \"gcode_bytes\": " << r.counters.gcodeBytes
+          << ", \"rapid_before_mm\": " << r.counters.rapidBefore
+          << ", \"rapid_after_mm\": " << r.counters.rapidAfter << "}\n";
+      out << "    }" << (i + 1 < m_results.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n";
+    out << "}\n";
+    return out.good();
+  }
+
+  size_t resultCount() const { return m_results.size(); }
+
+ private:
+  BenchOptions m_options;
+  CNConfig m_config;
+  ToolRegistry m_registry;
+  std::vector<BenchResult> m_results;
+
+  void add(const BenchResult &result) {
+    std::cerr << "  " << std::left << std::setw(36) << result.name
+              << std::right << std::setw(16) << std::fixed
+              << std::setprecision(0) << result.realTimeNs << " ns/op "
+              << std::setw(8) << result.iterations << " it" << std::endl;
+    m_results.push_back(result);
+  }
+};
+
+void printUsage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options]\n"
+      << "  --examples <dir>       Directory containing the example SVGs\n"
+      << "  --output <file>        JSON report file (default: "
+         "nwss-cnc-bench.json)\n"
+      << "  --min-time <seconds>   Minimum measured time per benchmark\n"
+      << "  --max-iterations <n>   Maximum iterations per benchmark\n"
+      << "  --scale <n>            Synthetic grid size (repeatable)\n"
+      << "  --no-synthetic         Skip the synthetic inputs\n"
+      << "  --segments <n>         Self-intersection input size (repeatable)\n"
+      << "  --no-segments          Skip the self-intersection scaling inputs\n"
+      << "  --contours <n>         Medial-axis glyph input size (repeatable)\n"
+      << "  --no-contours          Skip the medial-axis scaling inputs\n"
+      << "  --filter <text>        Only run inputs whose name contains text\n"
+      << "  --help                 Show this message\n";
+}
+
+bool parseArguments(int argc, char *argv[], BenchOptions &options) {
+  bool scalesGiven = false;
+  bool segmentsGiven = false;
+  bool contoursGiven = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--examples" && hasValue) {
+      options.examplesDir = argv[++i];
+    } else if (arg == "--output" && hasValue) {
+      options.outputFile = argv[++i];
+    } else if (arg == "--min-time" && hasValue) {
+      options.minTime = std::atof(argv[++i]);
+    } else if (arg == "--max-iterations" && hasValue) {
+      options.maxIterations = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--scale" && hasValue) {
+      if (!scalesGiven) {
+        options.syntheticScales.clear();
+        scalesGiven = true;
+      }
+      int scale = std::atoi(argv[++i]);
+      if (scale > 0) {
+        options.syntheticScales.push_back(scale);
+      }
+    } else if (arg == "--no-synthetic") {
+      options.syntheticScales.clear();
+      scalesGiven = true;
+    } else if (arg == "--segments" && hasValue) {
+      if (!segmentsGiven) {
+        options.segmentCounts.clear();
+        segmentsGiven = true;
+      }
+      long segments = std::atol(argv[++i]);
+      if (segments >= 3) {
+        options.segmentCounts.push_back(static_cast<size_t>(segments));
+      }
+    } else if (arg == "--no-segments") {
+      options.segmentCounts.clear();
+      segmentsGiven = true;
+    } else if (arg == "--contours" && hasValue) {
+      if (!contoursGiven) {
+        options.contourCounts.clear();
+        contoursGiven = true;
+      }
+      long contours = std::atol(argv[++i]);
+      if (contours > 0) {
+        options.contourCounts.push_back(static_cast<size_t>(contours));
+      }
+    } else if (arg == "--no-contours") {
+      options.contourCounts.clear();
+      contoursGiven = true;
+    } else if (arg == "--filter" && hasValue) {
+      options.filter = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  BenchOptions options;
+  if (!parseArguments(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Keep per-path diagnostics out of the timed regions
+  Log::setLevel(LogLevel::WARN);
+
+  std::vector<BenchInput> inputs;
+  const char *examples[] = {"circle", "nameplate", "tiger"};
+  for (const char *name : examples) {
+    inputs.push_back({name, options.examplesDir + "/" + name + ".svg", false});
+  }
+  for (int scale : options.syntheticScales) {
+    std::string name =
+        "synthetic_" + std::to_string(scale) + "x" + std::to_string(scale);
+    std::string filename = options.outputFile + "." + name + ".svg";
+    if (!writeSyntheticSvg(filename, scale)) {
+      std::cerr << "Warning: Could not write synthetic input " << filename
+                << std::endl;
+      continue;
+    }
+    inputs.push_back({name, filename, true});
+  }
+
+  BenchRunner runner(options);
+  for (const auto &input : inputs) {
+    if (options.filter.empty() ||
+        input.name.find(options.filter) != std::string::npos) {
+      runner.runInput(input);
+    }
+  }
+
+  for (size_t segments : options.segmentCounts) {
+    std::string name = "segments_" + std::to_string(segments);
+    if (options.filter.empty() ||
+        name.find(options.filter) != std::string::npos) {
+      runner.runIntersectionScaling(segments);
+    }
+  }
+
+  for (size_t contours : options.contourCounts) {
+    std::string name = "contours_" + std::to_string(contours);
+    if (options.filter.empty() ||
+        name.find(options.filter) != std::string::npos) {
+      runner.runMedialAxisScaling(contours);
+    }
+  }
+
+  for (const auto &input : inputs) {
+    if (input.temporary) {
+      std::remove(input.filename.c_str());
+    }
+  }
+
+  if (!runner.writeReport(options.outputFile)) {
+    return 1;
+  }
+  std::cerr << "Wrote " << runner.resultCount() << " results to "
+            << options.outputFile << std::endl;
+  return 0;
+}
@@ -20,11 +20,16 @@ class CAMProcessor;
  */
 struct AreaCutterResult {
   std::vector<Path> toolpaths;
+  std::vector<int> toolpathToolIds;  // Tool of each toolpath when more than
+                                     // one tool is used (empty = all use
+                                     // the selected tool)
   bool success = false;
   std::vector<std::string> warnings;
   std::vector<std::string> errors;
   double estimatedTime = 0.0;
   double totalDistance = 0.0;
+  double rapidDistance = 0.0;       // Travel between toolpaths (mm)
+  double rapidDistanceSaved = 0.0;  // Travel removed by ordering (mm)
 
   bool hasWarnings() const { return !warnings.empty(); }
   bool hasErrors() const { return !errors.empty(); }
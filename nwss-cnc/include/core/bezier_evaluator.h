@@ -0,0 +1,62 @@
+#ifndef NWSS_CNC_BEZIER_EVALUATOR_H
+#define NWSS_CNC_BEZIER_EVALUATOR_H
+
+#include <vector>
+
+#include "core/geometry.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Evaluates a cubic bezier curve at a fixed set of evenly spaced parameters.
+ *
+ * The Bernstein weights of every sample are computed once, so evaluating a
+ * curve is four multiply-adds per coordinate. Samples are processed eight
+ * (AVX2) or four (SSE2) at a time when the build targets those instruction
+ * sets, with a scalar loop for the remainder and other architectures. The
+ * arithmetic matches Discretizer's scalar evaluation step for step, so every
+ * code path produces the same points.
+ */
+class BezierBatchEvaluator {
+ public:
+  /**
+   * Create an evaluator for t = 1/samples, 2/samples, ..., 1
+   * @param samples Number of samples per curve (0 or less = none)
+   */
+  explicit BezierBatchEvaluator(int samples = 0);
+
+  /**
+   * Get the number of samples per curve
+   * @return The sample count
+   */
+  int samples() const { return m_samples; }
+
+  /**
+   * Evaluate one curve at every sample parameter
+   * @param p The curve's control points (x0, y0, x1, y1, x2, y2, x3, y3)
+   * @param out Destination with room for samples() points
+   */
+  void evaluate(const float *p, Point2D *out) const;
+
+  /**
+   * Evaluate one curve and append the samples to a path
+   * @param p The curve's control points (x0, y0, x1, y1, x2, y2, x3, y3)
+   * @param path The path to append to
+   */
+  void append(const float *p, Path &path) const;
+
+ private:
+  int m_samples;
+
+  // Bernstein weights per sample: (1-t)^3, 3(1-t)^2 t, 3(1-t) t^2, t^3
+  std::vector<float> m_b0;
+  std::vector<float> m_b1;
+  std::vector<float> m_b2;
+  std::vector<float> m_b3;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_BEZIER_EVALUATOR_H
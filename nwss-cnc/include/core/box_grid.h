@@ -0,0 +1,112 @@
+#ifndef NWSS_CNC_BOX_GRID_H
+#define NWSS_CNC_BOX_GRID_H
+
+#include <clipper2/clipper.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Uniform grid over the bounding boxes of a set of closed paths. A path can
+ * only lie inside another whose box covers its own box, and such a box
+ * covers every point of it, so the containers of a path are among the
+ * boxes registered in the cell of any one of its points. Cells keep boxes
+ * in index order.
+ */
+class BoxGrid {
+ public:
+  explicit BoxGrid(const std::vector<Clipper2Lib::Rect64> &boxes) {
+    if (boxes.empty()) {
+      return;
+    }
+    m_bounds = boxes[0];
+    for (const auto &box : boxes) {
+      m_bounds.left = std::min(m_bounds.left, box.left);
+      m_bounds.top = std::min(m_bounds.top, box.top);
+      m_bounds.right = std::max(m_bounds.right, box.right);
+      m_bounds.bottom = std::max(m_bounds.bottom, box.bottom);
+    }
+
+    // About one cell per box
+    m_cellsPerAxis = static_cast<size_t>(
+        std::ceil(std::sqrt(static_cast<double>(boxes.size()))));
+    m_cellWidth = cellSize(m_bounds.right - m_bounds.left);
+    m_cellHeight = cellSize(m_bounds.bottom - m_bounds.top);
+    m_cells.resize(m_cellsPerAxis * m_cellsPerAxis);
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      size_t x0 = column(boxes[i].left), x1 = column(boxes[i].right);
+      size_t y0 = row(boxes[i].top), y1 = row(boxes[i].bottom);
+      for (size_t y = y0; y <= y1; ++y) {
+        for (size_t x = x0; x <= x1; ++x) {
+          m_cells[y * m_cellsPerAxis + x].push_back(i);
+        }
+      }
+    }
+  }
+
+  // Boxes registered in the cell holding a point of the grid
+  const std::vector<size_t> &candidates(
+      const Clipper2Lib::Point64 &point) const {
+    return m_cells[row(point.y) * m_cellsPerAxis + column(point.x)];
+  }
+
+  // Visit the boxes registered in the cells a box of the grid spans; every
+  // box overlapping it is visited at least once
+  template <typename Visit>
+  void forEachNear(const Clipper2Lib::Rect64 &box, Visit visit) const {
+    size_t x0 = column(box.left), x1 = column(box.right);
+    size_t y0 = row(box.top), y1 = row(box.bottom);
+    for (size_t y = y0; y <= y1; ++y) {
+      for (size_t x = x0; x <= x1; ++x) {
+        for (size_t index : m_cells[y * m_cellsPerAxis + x]) {
+          visit(index);
+        }
+      }
+    }
+  }
+
+  // Check if boxes a and b share more than an edge
+  static bool overlaps(const Clipper2Lib::Rect64 &a,
+                       const Clipper2Lib::Rect64 &b) {
+    return a.left < b.right && b.left < a.right && a.top < b.bottom &&
+           b.top < a.bottom;
+  }
+
+  // Check if box a covers box b
+  static bool covers(const Clipper2Lib::Rect64 &a,
+                     const Clipper2Lib::Rect64 &b) {
+    return a.left <= b.left && a.top <= b.top && a.right >= b.right &&
+           a.bottom >= b.bottom;
+  }
+
+ private:
+  double cellSize(int64_t extent) const {
+    return std::max(1.0, static_cast<double>(extent) / m_cellsPerAxis);
+  }
+  size_t column(int64_t x) const {
+    return std::min(m_cellsPerAxis - 1,
+                    static_cast<size_t>((x - m_bounds.left) / m_cellWidth));
+  }
+  size_t row(int64_t y) const {
+    return std::min(m_cellsPerAxis - 1,
+                    static_cast<size_t>((y - m_bounds.top) / m_cellHeight));
+  }
+
+  Clipper2Lib::Rect64 m_bounds;
+  size_t m_cellsPerAxis = 1;
+  double m_cellWidth = 1.0;
+  double m_cellHeight = 1.0;
+  std::vector<std::vector<size_t>> m_cells;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_BOX_GRID_H
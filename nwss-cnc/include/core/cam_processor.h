@@ -8,8 +8,10 @@
 #include <vector>
 
 #include "core/config.h"
+#include "core/fixed_point.h"
 #include "core/geometry.h"
 #include "core/tool.h"
+#include "core/toolpath_optimizer.h"
 
 namespace nwss {
 namespace cnc {
@@ -19,11 +21,16 @@ namespace cnc {
  */
 struct CAMOperationResult {
   std::vector<Path> toolpaths;
+  std::vector<int> toolpathToolIds;  // Tool of each toolpath when more than
+                                     // one tool is used (empty = all use
+                                     // the selected tool)
   bool success = false;
   std::vector<std::string> warnings;
   std::vector<std::string> errors;
   double estimatedMachiningTime = 0.0;
   double totalCuttingDistance = 0.0;
+  double totalRapidDistance = 0.0;  // Travel between toolpaths (mm)
+  double rapidDistanceSaved = 0.0;  // Travel removed by ordering (mm)
 
   bool hasWarnings() const { return !warnings.empty(); }
   bool hasErrors() const { return !errors.empty(); }
@@ -35,6 +42,7 @@ struct CAMOperationResult {
  */
 struct PolygonHierarchy {
   Polygon polygon;
+  Clipper2Lib::Path64 fixedPath;  // The polygon in fixed-point coordinates
   std::vector<std::shared_ptr<PolygonHierarchy>>
       children;                              // Inner polygons (holes)
   std::shared_ptr<PolygonHierarchy> parent;  // Outer polygon
@@ -42,7 +50,8 @@ struct PolygonHierarchy {
   bool isHole = false;                       // True if this is a hole
 
   PolygonHierarchy() = default;
-  PolygonHierarchy(const Polygon &poly) : polygon(poly) {}
+  PolygonHierarchy(const Polygon &poly)
+      : polygon(poly), fixedPath(FixedPoint::toPath64(poly)) {}
 };
 
 /**
@@ -87,11 +96,12 @@ class CAMProcessor {
    * @param hierarchy Polygon hierarchy
    * @param toolDiameter Tool diameter
    * @param stepover Stepover distance
+   * @param threadCount Threads for the per-feature passes (0 = all cores)
    * @return CAM operation result
    */
   CAMOperationResult generatePunchoutToolpaths(
       const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-      double toolDiameter, double stepover);
+      double toolDiameter, double stepover, int threadCount = 1);
 
   /**
    * Generate professional pocket toolpaths
@@ -99,22 +109,79 @@ class CAMProcessor {
    * @param toolDiameter Tool diameter
    * @param stepover Stepover distance
    * @param spiralIn Whether to spiral inward
+   * @param threadCount Threads for the per-feature passes (0 = all cores)
+   * @param skipNarrowFeatures Skip features narrower than the tool anywhere
+   *                           instead of clearing the parts it reaches
+   *                           (false when a rest tool follows)
    * @return CAM operation result
    */
   CAMOperationResult generatePocketToolpaths(
       const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-      double toolDiameter, double stepover, bool spiralIn);
+      double toolDiameter, double stepover, bool spiralIn,
+      int threadCount = 1, bool skipNarrowFeatures = true);
 
   /**
    * Generate professional engrave toolpaths
    * @param hierarchy Polygon hierarchy
    * @param toolDiameter Tool diameter
    * @param stepover Stepover distance
+   * @param threadCount Threads for the per-feature passes (0 = all cores)
    * @return CAM operation result
    */
   CAMOperationResult generateEngraveToolpaths(
       const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-      double toolDiameter, double stepover);
+      double toolDiameter, double stepover, int threadCount = 1);
+
+  /**
+   * Generate V-carve toolpaths: a V-bit follows the medial axis of each
+   * shape, cutting deeper where the shape is wider so that its flanks just
+   * reach the walls. Shapes whose bounding boxes do not overlap are
+   * batched, each batch's medial axis using one spatial index of its walls.
+   * @param hierarchy Polygon hierarchy
+   * @param tool The V-bit (diameter is the flat tip diameter)
+   * @param maxDepth Deepest cut below the stock surface (mm)
+   * @param threadCount Threads for the medial axis samples (0 = all cores)
+   * @return CAM operation result; the toolpaths carry per-point depths
+   */
+  CAMOperationResult generateVCarveToolpaths(
+      const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+      const Tool &tool, double maxDepth, int threadCount = 1);
+
+  /**
+   * Generate adaptive clearing toolpaths: the pocket area is cleared from
+   * its deepest point outward, one stepover of engagement at a time
+   * @param hierarchy Polygon hierarchy
+   * @param toolDiameter Tool diameter
+   * @param stepover Largest radial engagement of the tool
+   * @param threadCount Threads for the per-feature passes (0 = all cores)
+   * @param skipNarrowFeatures Skip features narrower than the tool anywhere
+   *                           instead of clearing the parts it reaches
+   *                           (false when a rest tool follows)
+   * @return CAM operation result
+   */
+  CAMOperationResult generateAdaptiveToolpaths(
+      const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+      double toolDiameter, double stepover, int threadCount = 1,
+      bool skipNarrowFeatures = true);
+
+  /**
+   * Generate rest machining toolpaths: the material a larger tool leaves in
+   * the corners and narrow parts of each area, cleared with a smaller tool.
+   * The larger tool is assumed to have cleared every part of the areas it
+   * fits into (skipNarrowFeatures off).
+   * @param hierarchy Polygon hierarchy
+   * @param toolDiameter Diameter of the tool that cleared the areas
+   * @param restToolDiameter Diameter of the smaller tool
+   * @param stepover Stepover distance of the smaller tool
+   * @param mode Clearing mode of both tools (POCKET or ADAPTIVE)
+   * @param spiralIn Whether pockets without islands are spiralled
+   * @param threadCount Threads for the per-feature passes (0 = all cores)
+   * @return CAM operation result with the smaller tool's toolpaths
+   */
+  CAMOperationResult generateRestToolpaths(
+      const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+      double toolDiameter, double restToolDiameter, double stepover,
+      CutoutMode mode, bool spiralIn, int threadCount = 1);
 
   /**
    * Validate toolpath feasibility
@@ -141,36 +208,57 @@ class CAMProcessor {
   std::vector<Path> generateRasterToolpath(const Polygon &polygon,
                                            double toolDiameter, double stepover,
                                            double angle = 0.0);
+  std::vector<Path> generateAdaptiveToolpath(const Polygon &polygon,
+                                             double toolDiameter,
+                                             double stepover);
+  std::vector<Path> generateVCarveToolpath(const Polygon &polygon,
+                                           const std::vector<Polygon> &holes,
+                                           double tipDiameter, double tipAngle,
+                                           double maxDepth);
 
  private:
   CNConfig m_config;
   ToolRegistry m_toolRegistry;
 
-  // Clipper2 conversion utilities
-  Clipper2Lib::Paths64 polygonToClipperPaths(const Polygon &polygon);
-  Clipper2Lib::Paths64 polygonsToClipperPaths(
-      const std::vector<Polygon> &polygons);
-  std::vector<Polygon> clipperPathsToPolygons(
-      const Clipper2Lib::Paths64 &paths);
-  Polygon clipperPathToPolygon(const Clipper2Lib::Path64 &path);
-
-  // Advanced polygon operations using Clipper2
-  std::vector<Polygon> offsetPolygon(const Polygon &polygon, double offset);
-  std::vector<Polygon> unionPolygons(const std::vector<Polygon> &polygons);
-  std::vector<Polygon> intersectPolygons(const std::vector<Polygon> &polygons1,
-                                         const std::vector<Polygon> &polygons2);
-  std::vector<Polygon> differencePolygons(const std::vector<Polygon> &subject,
-                                          const std::vector<Polygon> &clip);
+  // Offset a fixed-point polygon by firstOffset, firstOffset + step, ...
+  // until no polygon above minArea is left (the collapsed ring is included)
+  std::vector<Clipper2Lib::Paths64> offsetRings(
+      const Clipper2Lib::Path64 &path, double firstOffset, double step,
+      size_t maxRings, double minArea);
+
+  // Spiral and contour passes of a polygon already in fixed point; only the
+  // emitted toolpaths are converted back
+  std::vector<Path> generateSpiralToolpath(const Clipper2Lib::Path64 &polygon,
+                                           double toolDiameter, double stepover,
+                                           bool inward);
+  std::vector<Path> generateContourToolpath(
+      const Clipper2Lib::Path64 &polygon, double toolDiameter,
+      double stepover);
+  // Zig-zag raster of a fixed-point outline minus its holes, kept one tool
+  // radius away from every edge
+  std::vector<Path> generateRasterToolpath(const Clipper2Lib::Path64 &outline,
+                                           const Clipper2Lib::Paths64 &holes,
+                                           double toolDiameter, double stepover,
+                                           double angle);
+  // Adaptive clearing of a fixed-point outline minus its holes: each pass
+  // cuts only the front where the cleared area grows by one stepover, and a
+  // last pass follows the walls
+  std::vector<Path> generateAdaptiveToolpath(
+      const Clipper2Lib::Path64 &outline, const Clipper2Lib::Paths64 &holes,
+      double toolDiameter, double stepover);
 
   // Validation and analysis
   bool isPolygonTooSmallForTool(const Polygon &polygon, double toolDiameter);
   bool hasInvalidGeometry(const Polygon &polygon);
   double calculateMinimumFeatureSize(const Polygon &polygon);
   bool checkForSelfIntersections(const Polygon &polygon);
-  bool isPolygonInsidePolygon(const Polygon &inner, const Polygon &outer);
+  bool isPolygonInsidePolygon(const PolygonHierarchy &inner,
+                              const PolygonHierarchy &outer);
 
   // Toolpath optimization
-  std::vector<Path> optimizeToolpathOrder(const std::vector<Path> &toolpaths);
+  ToolpathOrderReport optimizeToolpathOrder(
+      std::vector<Path> &toolpaths, const std::vector<int> &toolIds,
+      ToolpathOptimizer::Nesting nesting);
   std::vector<Path> removeRedundantMoves(const std::vector<Path> &toolpaths);
 
   // Error handling and reporting
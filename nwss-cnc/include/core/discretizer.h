@@ -1,7 +1,9 @@
 #ifndef NWSS_CNC_DISCRETIZER_HPP
 #define NWSS_CNC_DISCRETIZER_HPP
 
+#include "core/bezier_evaluator.h"
 #include "core/geometry.h"
+#include "core/path_set.h"
 
 struct NSVGimage;
 struct NSVGshape;
@@ -10,6 +12,14 @@ struct NSVGpath;
 namespace nwss {
 namespace cnc {
 
+/**
+ * Curve flattening algorithm used when adaptive sampling is enabled
+ */
+enum class FlatteningMethod {
+  SUBDIVISION,  // Midpoint subdivision until every piece is flat enough
+  WANG          // Uniform steps, count from Wang's formula (no subdivision)
+};
+
 /**
  * Configuration for path discretization
  */
@@ -23,8 +33,22 @@ struct DiscretizerConfig {
   // Adaptive sampling based on curvature (0 to disable)
   double adaptiveSampling = 0.0;
 
-  // Maximum distance between points when using adaptive sampling
+  // How curves are flattened when adaptive sampling is enabled. Both methods
+  // honor the same tolerance; WANG emits evenly spaced parameters and usually
+  // a few more points, SUBDIVISION places points where the curvature is.
+  FlatteningMethod flatteningMethod = FlatteningMethod::SUBDIVISION;
+
+  // Maximum distance between consecutive points on a curve, in document
+  // units (0 to disable). Applied on top of the sample count or flatness
+  // tolerance in every sampling mode, so long straight segments are split
+  // evenly too. The bound holds before Transform::fitToMaterial, so it
+  // scales with the design; GCodeOptions::maxSegmentLength bounds the G01
+  // moves after scaling.
   double maxPointDistance = 1.0;
+
+  // Threads used to discretize shapes in parallel (0 = hardware concurrency,
+  // 1 = serial). Output order does not depend on this setting.
+  int threadCount = 0;
 };
 
 /**
@@ -50,12 +74,28 @@ class Discretizer {
   // Discretize all paths in an SVG shape
   std::vector<Path> discretizeShape(NSVGshape *shape) const;
 
-  // Discretize all shapes in an SVG image
+  // Discretize all shapes in an SVG image, in document order. Shapes are
+  // processed in parallel according to DiscretizerConfig::threadCount.
   std::vector<Path> discretizeImage(NSVGimage *image) const;
 
+  // Discretize all shapes in an SVG image into a PathSet (replacing its
+  // contents), in document order. Same output as the vector version, but the
+  // points end up in two contiguous arrays instead of one vector per path.
+  void discretizeImage(NSVGimage *image, PathSet &paths) const;
+
  private:
   DiscretizerConfig m_config;
 
+  // Precomputed weights for fixed sampling with m_config.bezierSamples
+  BezierBatchEvaluator m_fixedEvaluator;
+
+  // Append the flattened points of a bezier path to result (no
+  // simplification)
+  void flattenBezier(float *points, int numPoints, Path &result) const;
+
+  // Flatten a path into a reusable buffer, simplified if configured
+  void flattenPath(NSVGpath *path, Path &scratch, PathSet &out) const;
+
   // Evaluate a point on a cubic bezier curve at parameter t
   Point2D evaluateBezier(float x0, float y0, float x1, float y1, float x2,
                          float y2, float x3, float y3, float t) const;
@@ -64,10 +104,26 @@ class Discretizer {
   double calculateFlatness(float x0, float y0, float x1, float y1, float x2,
                            float y2, float x3, float y3) const;
 
-  // Adaptively sample a bezier curve based on curvature
+  // Adaptively sample a bezier curve based on curvature (appends every point
+  // after the start point)
   void adaptiveSample(float x0, float y0, float x1, float y1, float x2,
                       float y2, float x3, float y3, Path &path,
                       double flatnessTolerance) const;
+
+  // Number of uniform steps that keep a bezier curve within the flatness
+  // tolerance (Wang's formula)
+  int wangSegmentCount(float x0, float y0, float x1, float y1, float x2,
+                       float y2, float x3, float y3,
+                       double flatnessTolerance) const;
+
+  // Number of uniform steps that keep every chord of a bezier curve within
+  // maxPointDistance (0 if the bound is disabled)
+  int chordSegmentCount(float x0, float y0, float x1, float y1, float x2,
+                        float y2, float x3, float y3) const;
+
+  // Number of points appended for one bezier curve, or -1 if not known
+  // before sampling
+  int curveSampleCount(const float *p) const;
 };
 
 }  // namespace cnc
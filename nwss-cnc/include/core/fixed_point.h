@@ -0,0 +1,81 @@
+#ifndef NWSS_CNC_FIXED_POINT_H
+#define NWSS_CNC_FIXED_POINT_H
+
+#include <clipper2/clipper.h>
+
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/path_set.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Conversion between geometry in millimetres and the fixed-point integer
+ * coordinates Clipper2 works in.
+ *
+ * A coordinate in mm is stored as round(value * scale), so the default
+ * scale of 1000 keeps a resolution of 0.001mm. Offsetting and clipping
+ * stages convert their input once, keep every intermediate result as
+ * Paths64 and only convert back the paths they hand on; areas and closure
+ * checks can be answered on the fixed-point data directly.
+ */
+class FixedPoint {
+ public:
+  // Default units per mm (0.001mm resolution)
+  static constexpr int kDefaultScale = 1000;
+
+  /**
+   * Convert a path to fixed point (non-finite points are dropped)
+   * @param path The path in mm
+   * @param scale Units per mm
+   * @return The fixed-point path
+   */
+  static Clipper2Lib::Path64 toPath64(const PathView &path,
+                                      int scale = kDefaultScale);
+
+  // Convert a polygon to fixed point
+  static Clipper2Lib::Path64 toPath64(const Polygon &polygon,
+                                      int scale = kDefaultScale);
+
+  // Convert paths to fixed point, leaving out paths without finite points
+  static Clipper2Lib::Paths64 toPaths64(const std::vector<Path> &paths,
+                                        int scale = kDefaultScale);
+
+  // Convert a fixed-point path back to mm
+  static Path toPath(const Clipper2Lib::Path64 &path,
+                     int scale = kDefaultScale);
+
+  // Convert fixed-point paths back to mm, leaving out empty paths
+  static std::vector<Path> toPaths(const Clipper2Lib::Paths64 &paths,
+                                   int scale = kDefaultScale);
+
+  // Convert a fixed-point path back to a polygon in mm
+  static Polygon toPolygon(const Clipper2Lib::Path64 &path,
+                           int scale = kDefaultScale);
+
+  /**
+   * Get the unsigned area of a fixed-point path
+   * @param path The path (treated as closed)
+   * @param scale Units per mm
+   * @return Area in mm^2
+   */
+  static double area(const Clipper2Lib::Path64 &path,
+                     int scale = kDefaultScale);
+
+  /**
+   * Check if a fixed-point path ends where it starts
+   * @param path The path
+   * @param tolerance Largest gap between the end points, in mm
+   * @param scale Units per mm
+   * @return true if the path has at least 3 points and closes
+   */
+  static bool isClosed(const Clipper2Lib::Path64 &path, double tolerance,
+                       int scale = kDefaultScale);
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_FIXED_POINT_H
@@ -1,13 +1,16 @@
 #ifndef NWSS_CNC_GCODE_GENERATOR_H
 #define NWSS_CNC_GCODE_GENERATOR_H
 
+#include <ostream>
 #include <string>
 #include <vector>
 
 #include "core/area_cutter.h"
 #include "core/config.h"
 #include "core/geometry.h"
+#include "core/path_set.h"
 #include "core/tool.h"
+#include "core/toolpath_optimizer.h"
 
 namespace nwss {
 namespace cnc {
@@ -24,16 +27,23 @@ struct GCodeOptions {
   bool returnToOrigin;   // Whether to return to origin at the end
 
   // Path processing options
-  bool optimizePaths;    // Optimize path ordering to minimize travel
+  bool optimizePaths;    // Order perimeter cuts to minimize travel (area
+                         // toolpaths are always ordered)
   bool closeLoops;       // Ensure paths that should be closed are closed
   bool separateRetract;  // Add a retract between each path
   bool linearizePaths;   // Combine consecutive points that form straight lines
   double linearizeTolerance;  // Maximum deviation allowed for linearization
+  double maxSegmentLength;    // Split longer G01 moves evenly, in output
+                              // units after scaling (0 = no limit)
 
   // Tool options
   int selectedToolId;                   // ID of the selected tool from registry
+  int restToolId;  // Smaller tool that clears what the selected tool cannot
+                   // reach in pocket and adaptive modes (0 = none)
   ToolOffsetDirection offsetDirection;  // Tool offset direction
   bool enableToolOffsets;               // Whether to apply tool offsets
+  bool batchToolOffsets;  // Offset all paths in one pass (holes and merged
+                          // neighbours resolved as a region)
   bool validateFeatureSizes;  // Whether to validate feature sizes against tool
   std::string materialType;   // Material type for optimized cutting parameters
 
@@ -44,6 +54,7 @@ struct GCodeOptions {
   double overlap;   // Overlap between passes (as fraction of stepover)
   bool spiralIn;    // Whether to spiral inward for pocketing
   double maxStepover;  // Maximum stepover in absolute units (mm)
+  int threadCount;  // Threads for per-feature CAM toolpaths (0 = all cores)
 
   // Constructor with default values
   GCodeOptions()
@@ -56,16 +67,20 @@ struct GCodeOptions {
         separateRetract(true),
         linearizePaths(true),      // Enable linearization by default
         linearizeTolerance(0.01),  // Default tolerance (adjust as needed)
+        maxSegmentLength(0.0),
         selectedToolId(0),
+        restToolId(0),
         offsetDirection(ToolOffsetDirection::AUTO),
         enableToolOffsets(true),
+        batchToolOffsets(false),
         validateFeatureSizes(true),
         materialType("Unknown"),
         cutoutMode(CutoutMode::PERIMETER),
         stepover(0.5),
         overlap(0.1),
         spiralIn(true),
-        maxStepover(2.0) {}
+        maxStepover(2.0),
+        threadCount(0) {}
 };
 
 /**
@@ -112,6 +127,33 @@ class GCodeGenerator {
   bool generateGCode(const std::vector<Path> &paths,
                      const std::string &outputFile) const;
 
+  /**
+   * Generate G-code and stream it to an output stream
+   * @param paths The discretized paths to convert to G-code
+   * @param out The stream to write the G-code to (e.g. std::cout)
+   * @return True if G-code was successfully written
+   */
+  bool generateGCode(const std::vector<Path> &paths, std::ostream &out) const;
+
+  /**
+   * Generate G-code from a path set and write it to a file
+   * @param paths The discretized paths to convert to G-code
+   * @param outputFile Path to the output G-code file
+   * @return True if G-code was successfully generated
+   */
+  bool generateGCode(const PathSet &paths,
+                     const std::string &outputFile) const;
+
+  /**
+   * Generate G-code from a path set and stream it to an output stream.
+   * Perimeter toolpaths (with or without tool offsets) stay in PathSet form
+   * from input to output; area cutting modes convert at the CAM boundary.
+   * @param paths The discretized paths to convert to G-code
+   * @param out The stream to write the G-code to (e.g. std::cout)
+   * @return True if G-code was successfully written
+   */
+  bool generateGCode(const PathSet &paths, std::ostream &out) const;
+
   /**
    * Generate G-code as a string without writing to a file
    * @param paths The discretized paths to convert to G-code
@@ -141,12 +183,90 @@ class GCodeGenerator {
   ToolRegistry m_toolRegistry;  // Tool registry
   AreaCutter m_areaCutter;      // Area cutting operations
 
+  /**
+   * Apply tool offsets and area cutting to produce the final toolpaths
+   * @param paths The input paths
+   * @param toolIds Output tool of each toolpath (empty = all use the
+   *                selected tool)
+   * @return The toolpaths to emit
+   */
+  std::vector<Path> prepareToolpaths(const std::vector<Path> &paths,
+                                     std::vector<int> &toolIds) const;
+
+  /**
+   * Apply tool offsets to a path set for perimeter cutting. Area modes go
+   * through prepareToolpaths(), which also returns the tool of each
+   * toolpath.
+   * @param paths The input paths
+   * @return The toolpaths to emit
+   */
+  PathSet preparePerimeterToolpaths(const PathSet &paths) const;
+
+  /**
+   * Reorder perimeter cuts to shorten the rapid travel between them
+   * @param toolpaths The toolpaths, reordered in place
+   */
+  void orderToolpaths(std::vector<Path> &toolpaths) const;
+
+  /**
+   * Copy perimeter cuts in the order that shortens the rapid travel
+   * between them
+   * @param toolpaths The toolpaths
+   * @return The reordered toolpaths
+   */
+  PathSet orderToolpaths(const PathSet &toolpaths) const;
+
+  // Ordering options for perimeter cuts
+  ToolpathOptimizer::Options orderOptions() const;
+
+  /**
+   * Log feature size warnings for the selected tool, if enabled
+   * @param paths The input paths
+   */
+  void validateInput(const std::vector<Path> &paths) const;
+
+  /**
+   * Write the program to a stream, counting the bytes while profiling
+   * @param out The output stream
+   * @param toolpaths The final toolpaths (std::vector<Path> or PathSet)
+   * @param toolIds Tool of each toolpath (empty = all use the selected tool)
+   * @return True if the stream is still good
+   */
+  template <typename Paths>
+  bool emitProgram(std::ostream &out, const Paths &toolpaths,
+                   const std::vector<int> &toolIds) const;
+
+  /**
+   * Write header, toolpaths and footer to the output stream, changing tools
+   * where the tool of the toolpaths changes
+   * @param out The output stream
+   * @param toolpaths The final toolpaths (std::vector<Path> or PathSet)
+   * @param toolIds Tool of each toolpath (empty = all use the selected tool)
+   */
+  template <typename Paths>
+  void writeProgram(std::ostream &out, const Paths &toolpaths,
+                    const std::vector<int> &toolIds) const;
+
   /**
    * Generate the G-code header
    * @param out The output stream
    */
   void writeHeader(std::ostream &out) const;
 
+  /**
+   * Select a tool (and its length compensation, if offsets are enabled)
+   * @param out The output stream
+   * @param tool The tool
+   */
+  void writeToolSelection(std::ostream &out, const Tool &tool) const;
+
+  /**
+   * Stop the spindle at safe height, change to another tool and restart
+   * @param out The output stream
+   * @param toolId ID of the new tool
+   */
+  void writeToolChange(std::ostream &out, int toolId) const;
+
   /**
    * Generate the G-code footer
    * @param out The output stream
@@ -159,7 +279,8 @@ class GCodeGenerator {
    * @param path The path to process
    * @param pathIndex The index of the path
    */
-  void writePath(std::ostream &out, const Path &path, size_t pathIndex) const;
+  void writePath(std::ostream &out, const PathView &path,
+                 size_t pathIndex) const;
 
   /**
    * Linearize a path to reduce the number of points
@@ -167,9 +288,35 @@ class GCodeGenerator {
    * @param points The points to linearize
    * @param feedRate The feed rate for the path
    */
-  void linearizePath(std::ostream &out, const std::vector<Point2D> &points,
+  void linearizePath(std::ostream &out, const PathView &points,
                      double feedRate) const;
 
+  /**
+   * Write a G01 move, split into equal moves no longer than
+   * GCodeOptions::maxSegmentLength. The final move is left unterminated so
+   * the caller can append a comment.
+   * @param out The output stream
+   * @param from The current position
+   * @param to The target position
+   * @param feedRate The feed rate for the move
+   */
+  void writeLinearMove(std::ostream &out, const Point2D &from,
+                       const Point2D &to, double feedRate) const;
+
+  /**
+   * Write one pass of a V-carve path: a plunge to the depth of its first
+   * point, then a G01 move with its own Z to every further point
+   * @param out The output stream
+   * @param points The path, with per-point depths
+   * @param depthLimit Deepest cut of this pass below the surface
+   * @param feedRate The feed rate for the moves
+   * @param plungeRate The feed rate for the plunge
+   * @param pass Index of the pass, for comments
+   */
+  void writeCarvePath(std::ostream &out, const PathView &points,
+                      double depthLimit, double feedRate, double plungeRate,
+                      int pass) const;
+
   /**
    * Check if three points are collinear
    * @param p1 First point
@@ -187,6 +334,41 @@ class GCodeGenerator {
    */
   std::vector<Path> applyToolOffsets(const std::vector<Path> &paths) const;
 
+  /**
+   * Apply tool offset to every path of a set
+   * @param paths The input paths
+   * @return The offset paths
+   */
+  PathSet applyToolOffsets(const PathSet &paths) const;
+
+  /**
+   * Offset all paths with a single batched ToolOffset call. Paths whose
+   * offset merged into a neighbour's ring are dropped; paths that produced
+   * no ring are kept unchanged.
+   * @param paths The input paths
+   * @param tool The selected tool
+   * @return The offset paths, in input order
+   */
+  std::vector<Path> applyBatchToolOffsets(const std::vector<Path> &paths,
+                                          const Tool &tool) const;
+
+  /**
+   * Get the tool used for offsets
+   * @return The selected tool, or nullptr if none with a valid diameter
+   */
+  const Tool *selectedOffsetTool() const;
+
+  /**
+   * Offset a single path with the given tool
+   * @param path The input path (not empty)
+   * @param pathIndex Index of the path, for log messages
+   * @param tool The selected tool
+   * @param offsetPath Output for the offset path
+   * @return True if the offset succeeded and should replace the path
+   */
+  bool offsetToolpath(const PathView &path, size_t pathIndex,
+                      const Tool &tool, Path &offsetPath) const;
+
   /**
    * Convert paths to polygons for area operations
    * @param paths The input paths
@@ -197,10 +379,12 @@ class GCodeGenerator {
   /**
    * Generate area cutting paths based on cutout mode
    * @param polygons The input polygons
+   * @param toolIds Output tool of each path (empty = all use the selected
+   *                tool)
    * @return Vector of area cutting paths
    */
   std::vector<Path> generateAreaCuttingPaths(
-      const std::vector<Polygon> &polygons) const;
+      const std::vector<Polygon> &polygons, std::vector<int> &toolIds) const;
 };
 
 }  // namespace cnc
@@ -14,7 +14,8 @@ enum class CutoutMode {
   PERIMETER,  // Cut only along the perimeter/paths (current behavior)
   PUNCHOUT,   // Cut out the entire area (punch through)
   POCKET,     // Pocket the area (cut inside the shape)
-  ENGRAVE     // Engrave the area (shallow cuts)
+  ENGRAVE,    // Engrave the area (shallow cuts)
+  ADAPTIVE    // Clear the pocket area with bounded tool engagement
 };
 
 /**
@@ -27,6 +28,9 @@ struct CutoutParams {
   double overlap = 0.1;      // Overlap between passes (as fraction of stepover)
   bool spiralIn = true;      // Whether to spiral inward for pocketing
   double maxStepover = 2.0;  // Maximum stepover in absolute units (mm)
+  int threadCount = 0;  // Threads for per-feature toolpaths (0 = all cores)
+  int restToolId = 0;   // Smaller tool that clears what the selected tool
+                        // cannot reach (0 = no rest machining)
 
   CutoutParams() = default;
   CutoutParams(CutoutMode m, double so = 0.5, double ol = 0.1, bool si = true,
@@ -70,16 +74,139 @@ struct Point2D {
   }
 };
 
+/**
+ * A 2D affine transform stored as a 2x3 matrix:
+ *
+ *   x' = a * x + b * y + tx
+ *   y' = c * x + d * y + ty
+ *
+ * Chains of scales, translations and flips are composed into a single matrix
+ * with then(), so transforming a design is one pass over its points no matter
+ * how many steps the chain has.
+ */
+struct AffineTransform {
+  double a = 1.0;
+  double b = 0.0;
+  double c = 0.0;
+  double d = 1.0;
+  double tx = 0.0;
+  double ty = 0.0;
+
+  // Create a translation
+  static AffineTransform translation(double dx, double dy) {
+    AffineTransform t;
+    t.tx = dx;
+    t.ty = dy;
+    return t;
+  }
+
+  // Create a scale about the origin
+  static AffineTransform scaling(double sx, double sy) {
+    AffineTransform t;
+    t.a = sx;
+    t.d = sy;
+    return t;
+  }
+
+  // Create a mirror of the Y axis about the horizontal line y = height / 2
+  static AffineTransform flipY(double height) {
+    AffineTransform t;
+    t.d = -1.0;
+    t.ty = height;
+    return t;
+  }
+
+  // Get the transform that applies this one, then next
+  AffineTransform then(const AffineTransform &next) const {
+    AffineTransform t;
+    t.a = next.a * a + next.b * c;
+    t.b = next.a * b + next.b * d;
+    t.c = next.c * a + next.d * c;
+    t.d = next.c * b + next.d * d;
+    t.tx = next.a * tx + next.b * ty + next.tx;
+    t.ty = next.c * tx + next.d * ty + next.ty;
+    return t;
+  }
+
+  // Transform a point
+  Point2D apply(const Point2D &point) const {
+    return Point2D(a * point.x + b * point.y + tx,
+                   c * point.x + d * point.y + ty);
+  }
+
+  // Transform separate x and y coordinate arrays in place
+  void apply(double *xs, double *ys, size_t count) const;
+
+  // Check if the transform leaves every point unchanged
+  bool isIdentity() const {
+    return a == 1.0 && b == 0.0 && c == 0.0 && d == 1.0 && tx == 0.0 &&
+           ty == 0.0;
+  }
+};
+
 /**
  * Represents a path as a sequence of 2D points
+ *
+ * The length is computed on first use and kept until the points change.
+ * Like the other const members, length() may then be called from several
+ * threads at once; the first call on a shared path should happen before
+ * the path is shared.
+ *
+ * Toolpaths cut at a varying depth (V-carving) also carry a depth below the
+ * stock surface for every point; all other paths have no depths and are cut
+ * at the configured depth. A path has either a depth for every point or
+ * none.
  */
 class Path {
  public:
   Path() = default;
   explicit Path(const std::vector<Point2D> &points) : m_points(points) {}
 
-  // Add a point to the path
-  void addPoint(const Point2D &point) { m_points.push_back(point); }
+  // Add a point to the path (at the depth of the last point if the path
+  // has depths)
+  void addPoint(const Point2D &point) {
+    m_points.push_back(point);
+    if (hasDepths()) {
+      m_depths.push_back(m_depths.back());
+    }
+    m_hasLength = false;
+  }
+
+  // Add a point cut at its own depth below the stock surface (mm). Points
+  // added before without a depth take this one.
+  void addPoint(const Point2D &point, double depth) {
+    m_points.push_back(point);
+    m_depths.resize(m_points.size(), depth);
+    m_hasLength = false;
+  }
+
+  // Reserve capacity for a number of points (and their depths)
+  void reserve(size_t count) {
+    m_points.reserve(count);
+    if (hasDepths()) {
+      m_depths.reserve(count);
+    }
+  }
+
+  // Remove all points and depths (keeps the capacity)
+  void clear() {
+    m_points.clear();
+    m_depths.clear();
+    m_hasLength = false;
+  }
+
+  // Append count points (at the origin) and return a pointer to the first of
+  // them so they can be filled in place. On a path with depths they take
+  // the depth of the last point.
+  Point2D *appendPoints(size_t count) {
+    size_t start = m_points.size();
+    m_points.resize(start + count);
+    if (hasDepths()) {
+      m_depths.resize(m_points.size(), m_depths.back());
+    }
+    m_hasLength = false;
+    return m_points.data() + start;
+  }
 
   // Get all points
   const std::vector<Point2D> &getPoints() const { return m_points; }
@@ -93,18 +220,41 @@ class Path {
   // Check if path is empty
   bool empty() const { return m_points.empty(); }
 
+  // Check if the points carry their own depths
+  bool hasDepths() const { return !m_depths.empty(); }
+
+  // Get the depths of all points (empty without depths)
+  const std::vector<double> &getDepths() const { return m_depths; }
+
+  // Get the depth of a specific point
+  double getDepth(size_t index) const { return m_depths.at(index); }
+
+  // Transform every point in place (depths are kept)
+  void transform(const AffineTransform &transform);
+
   // Calculate the total length of the path
   double length() const;
 
   // Simplify the path by removing points that are too close together
+  // (paths with depths are returned unchanged)
   Path simplify(double tolerance) const;
 
  private:
   std::vector<Point2D> m_points;
+  std::vector<double> m_depths;  // Per-point depths, or empty
+
+  // Cached length, valid while m_hasLength is set
+  mutable double m_length = 0.0;
+  mutable bool m_hasLength = false;
 };
 
 /**
  * Represents a closed polygon for area operations
+ *
+ * Area, orientation and bounds are computed on first use (area and
+ * orientation in one pass) and kept until the points change, so CAM loops
+ * can query them repeatedly. As with Path, query a polygon once before
+ * sharing it between threads.
  */
 class Polygon {
  public:
@@ -112,7 +262,10 @@ class Polygon {
   explicit Polygon(const std::vector<Point2D> &points) : m_points(points) {}
 
   // Add a point to the polygon
-  void addPoint(const Point2D &point) { m_points.push_back(point); }
+  void addPoint(const Point2D &point) {
+    m_points.push_back(point);
+    invalidate();
+  }
 
   // Get all points
   const std::vector<Point2D> &getPoints() const { return m_points; }
@@ -142,7 +295,28 @@ class Polygon {
   void getBounds(double &minX, double &minY, double &maxX, double &maxY) const;
 
  private:
+  // Drop the cached properties after a change
+  void invalidate() {
+    m_hasArea = false;
+    m_hasBounds = false;
+  }
+
+  // Compute the cached area and orientation
+  void computeArea() const;
+
   std::vector<Point2D> m_points;
+
+  // Cached area and orientation, valid while m_hasArea is set
+  mutable double m_area = 0.0;
+  mutable bool m_clockwise = false;
+  mutable bool m_hasArea = false;
+
+  // Cached bounding box, valid while m_hasBounds is set
+  mutable double m_minX = 0.0;
+  mutable double m_minY = 0.0;
+  mutable double m_maxX = 0.0;
+  mutable double m_maxY = 0.0;
+  mutable bool m_hasBounds = false;
 };
 
 }  // namespace cnc
@@ -0,0 +1,111 @@
+#ifndef NWSS_CNC_LOG_H
+#define NWSS_CNC_LOG_H
+
+#include <functional>
+#include <sstream>
+#include <string>
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Severity of a log message, in increasing order of importance
+ */
+enum class LogLevel {
+  DEBUG,  // Per-path / per-pass diagnostics (compiled out in Release)
+  INFO,   // High-level progress messages
+  WARN,   // Recoverable problems
+  ERR,    // Failures (named ERR to avoid the Windows ERROR macro)
+  OFF     // Suppress all messages
+};
+
+/**
+ * Leveled logging facility for the core library.
+ *
+ * Messages below the current level are discarded before they are formatted.
+ * By default messages are written to std::cerr; applications can install a
+ * sink to route them elsewhere (e.g. the Qt message handler).
+ */
+class Log {
+ public:
+  using Sink = std::function<void(LogLevel, const std::string &)>;
+
+  /**
+   * Set the minimum level that will be emitted
+   * @param level The new minimum level
+   */
+  static void setLevel(LogLevel level);
+
+  /**
+   * Get the minimum level that will be emitted
+   * @return The current minimum level
+   */
+  static LogLevel getLevel();
+
+  /**
+   * Check whether messages of the given level are currently emitted
+   * @param level The level to check
+   * @return True if a message at this level would reach the sink
+   */
+  static bool isEnabled(LogLevel level);
+
+  /**
+   * Install a sink that receives every emitted message
+   * @param sink The sink callback, or nullptr to restore the default sink
+   */
+  static void setSink(Sink sink);
+
+  /**
+   * Emit a message at the given level
+   * @param level The message level
+   * @param message The message text (without trailing newline)
+   */
+  static void write(LogLevel level, const std::string &message);
+
+  /**
+   * Get a human-readable name for a level
+   * @param level The level
+   * @return The level name (e.g. "Warning")
+   */
+  static const char *levelName(LogLevel level);
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+/**
+ * Log a streamed expression at the given level, e.g.
+ *   NWSS_LOG(LogLevel::INFO, "Processed " << count << " paths");
+ * The expression is only evaluated when the level is enabled.
+ */
+#define NWSS_LOG(level, expr)                               \
+  do {                                                      \
+    if (::nwss::cnc::Log::isEnabled(level)) {               \
+      std::ostringstream nwssLogStream_;                    \
+      nwssLogStream_ << expr;                               \
+      ::nwss::cnc::Log::write(level, nwssLogStream_.str()); \
+    }                                                       \
+  } while (0)
+
+// Debug messages are compiled out of Release builds unless explicitly
+// requested with NWSS_CNC_ENABLE_DEBUG_LOG (see the NWSS_CNC_DEBUG_LOGGING
+// CMake option).
+#if !defined(NDEBUG) || defined(NWSS_CNC_ENABLE_DEBUG_LOG)
+#define NWSS_LOG_DEBUG(expr) NWSS_LOG(::nwss::cnc::LogLevel::DEBUG, expr)
+#else
+// The expression is still type-checked so that variables only used for
+// logging do not trigger warnings, but the optimizer removes it entirely.
+#define NWSS_LOG_DEBUG(expr)             \
+  do {                                   \
+    if (false) {                         \
+      std::ostringstream nwssLogStream_; \
+      nwssLogStream_ << expr;            \
+    }                                    \
+  } while (0)
+#endif
+
+#define NWSS_LOG_INFO(expr) NWSS_LOG(::nwss::cnc::LogLevel::INFO, expr)
+#define NWSS_LOG_WARN(expr) NWSS_LOG(::nwss::cnc::LogLevel::WARN, expr)
+#define NWSS_LOG_ERROR(expr) NWSS_LOG(::nwss::cnc::LogLevel::ERR, expr)
+
+#endif  // NWSS_CNC_LOG_H
@@ -0,0 +1,177 @@
+#ifndef NWSS_CNC_MEDIAL_AXIS_H
+#define NWSS_CNC_MEDIAL_AXIS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/path_set.h"
+#include "core/segment_grid.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * The largest empty disc touching the boundary at one sample
+ */
+struct MedialBall {
+  Point2D boundary;          // Boundary sample the disc is tangent to
+  Point2D center;            // Centre of the disc, on the medial axis
+  double radius = 0.0;       // Radius of the disc (0 at convex corners)
+  double objectAngle = 0.0;  // Angle at the centre between the two walls
+                             // the disc touches, in degrees (180 = walls
+                             // facing each other, 0 = convex corner)
+  size_t edge = 0;           // Edge of its ring the sample lies on (the one
+                             // starting at it for corner samples)
+  bool touchesEdge = false;  // Whether the disc touches a wall edge away
+                             // from the sample inside the edge, not at one
+                             // of its corners
+  size_t contactRing = 0;    // Ring and edge of that wall
+  size_t contactEdge = 0;
+  bool duplicate = false;    // Whether the samples of that wall, which has
+                             // the lower (ring, edge), find the disc again:
+                             // they touch this disc's wall back and the
+                             // contact is not next to a sharp corner
+};
+
+/**
+ * Samples the medial axis of a region bounded by closed rings.
+ *
+ * Every ring is sampled along its edges, at its convex corners and in a
+ * fan of normals around its reflex corners. For each sample the largest
+ * disc inside the region that touches the boundary there is found with the
+ * shrinking-ball method: a ray cast along the inward normal bounds the
+ * disc, then the nearest wall to its centre (from a SegmentGrid) shrinks it
+ * until no wall is inside. The disc centres lie on the medial axis (the
+ * inner segment Voronoi edges of the boundary) and follow the boundary in
+ * order, so a ring's centres form a path along the axis with the disc
+ * radius as the local half width. Samples are independent and are spread
+ * over the shared thread pool.
+ *
+ * Each disc is first bounded by the wall the previous sample's disc
+ * touched (the smallest disc tangent at the sample that reaches it), so
+ * usually one nearest-wall query confirms it; the ray cast is only needed
+ * when that wall is not ahead of the sample. Where the discs at both ends
+ * of an edge touch the inside of the same wall edge and no other wall
+ * reaches into the discs between them, those discs lie on the straight
+ * bisector of the two edges; they are not fitted and are left out of the
+ * ring's discs.
+ */
+class MedialAxis {
+ public:
+  /**
+   * Sampling options
+   */
+  struct Options {
+    // Largest distance between samples along an edge (mm); 0 = one sample
+    // in the middle of each edge
+    double sampleSpacing = 0.0;
+    // Largest turn between the samples around a reflex corner (degrees)
+    double fanAngle = 15.0;
+    // Smallest object angle of a disc that measures the width of a
+    // feature; discs squeezed into a corner have smaller angles (degrees)
+    double minObjectAngle = 160.0;
+    // Discs at or below this diameter (slivers and flattening noise) are
+    // not features (mm)
+    double tolerance = 0.001;
+    // Threads for the samples (0 = all cores)
+    int threadCount = 1;
+  };
+
+  MedialAxis() = default;
+  explicit MedialAxis(const Options &options) : m_options(options) {}
+
+  /**
+   * Compute the medial discs of a region
+   * @param rings Closed rings of the region: the outline first, then its
+   *              holes. Either orientation; a closing point equal to the
+   *              first point is allowed.
+   * @return false if the outline has fewer than 3 points
+   */
+  bool compute(const std::vector<Path> &rings);
+
+  /**
+   * Compute the medial discs of several regions at once, with one spatial
+   * index over all of their walls. The regions must not overlap.
+   * @param rings Closed rings of the regions, in any order
+   * @param holes Whether each ring is a hole (the region lies outside it)
+   * @return false if no ring has 3 points
+   */
+  bool compute(const std::vector<PathView> &rings,
+               const std::vector<char> &holes);
+
+  // Get the number of rings of the last computed region
+  size_t ringCount() const { return m_balls.size(); }
+
+  /**
+   * Get the discs of one ring, in the order of the ring's points
+   * @param ring Index of the ring as passed to compute()
+   * @return The discs
+   */
+  const std::vector<MedialBall> &balls(size_t ring) const {
+    return m_balls[ring];
+  }
+
+  /**
+   * Find the narrowest feature of a region: the smallest disc that touches
+   * walls facing each other (object angle of at least
+   * Options::minObjectAngle) and is wider than Options::tolerance. Only
+   * samples where a narrower disc than the narrowest so far fits are
+   * fitted, and no discs are kept (ringCount() is 0 afterwards).
+   * @param rings Closed rings of the regions, as for compute()
+   * @param holes Whether each ring is a hole
+   * @param width On input, only discs narrower than this are looked for
+   *              (0 = any); output diameter of the narrowest disc (mm)
+   * @return false if no such disc touches facing walls
+   */
+  bool narrowestWidth(const std::vector<PathView> &rings,
+                      const std::vector<char> &holes, double &width);
+
+  // Get the sampling options
+  const Options &getOptions() const { return m_options; }
+
+ private:
+  // A run of boundary points with their unit normal into the region: point,
+  // point + step, ... (run points in all)
+  struct Sample {
+    Point2D point;
+    Point2D normal;
+    Point2D step;
+    size_t ring;
+    size_t edge;
+    size_t run;
+    bool convexCorner;
+  };
+
+  // Index the walls of the rings and sample them; sampleStart[i] is the
+  // first sample of ring i. Returns false if no ring has 3 points.
+  bool prepare(const std::vector<PathView> &rings,
+               const std::vector<char> &holes, std::vector<Sample> &samples,
+               std::vector<size_t> &sampleStart);
+
+  // Sample one ring (without repeated points) in the order of its points
+  void sampleRing(const Point2D *points, size_t count, size_t ring,
+                  bool interiorLeft, std::vector<Sample> &samples) const;
+
+  // Find the largest disc inside the region tangent at point k of a sample,
+  // bounding it first by a wall segment (if any); segment is replaced by
+  // the wall the disc touches
+  MedialBall fitBall(const Sample &sample, size_t k, size_t &segment) const;
+
+  // Check that no wall other than the sample's edge and the wall both discs
+  // touch reaches into the discs swept from one to the other (nearby is
+  // scratch space)
+  bool sweepIsClear(const Sample &sample, const MedialBall &from,
+                    const MedialBall &to, std::vector<size_t> &nearby) const;
+
+  Options m_options;
+  SegmentGrid m_grid;
+  std::vector<size_t> m_ringSegments;  // First grid segment of each ring
+  double m_maxRadius = 0.0;
+  std::vector<std::vector<MedialBall>> m_balls;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_MEDIAL_AXIS_H
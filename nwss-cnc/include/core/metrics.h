@@ -0,0 +1,164 @@
+#ifndef NWSS_CNC_METRICS_H
+#define NWSS_CNC_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Counters collected while a PipelineProfiler is active
+ */
+enum class PipelineCounter {
+  BEZIER_SEGMENTS,  // Cubic segments read from the SVG
+  EMITTED_POINTS,   // Points produced by the discretizer
+  CLIPPER_CALLS,    // Clipper2 boolean / offset operations executed
+  OFFSET_PASSES,    // Offset distances applied (tool offsets and CAM passes)
+  TOOLPATHS,        // Toolpaths written to G-code
+  GCODE_BYTES,      // Bytes of G-code written
+  RAPID_BEFORE,     // Rapid travel between toolpaths before ordering (um)
+  RAPID_AFTER,      // Rapid travel between toolpaths after ordering (um)
+  COUNT
+};
+
+/**
+ * Accumulated wall time of one named pipeline stage
+ */
+struct StageTiming {
+  std::string name;
+  double milliseconds = 0.0;  // Total wall time over all calls
+  int calls = 0;              // Number of times the stage ran
+};
+
+/**
+ * Snapshot of the timings and counters of a pipeline run
+ */
+struct PipelineStats {
+  // Stages in the order they first ran. Stages may nest: "tool_offset",
+  // "cam" and "path_order" run inside "toolpaths".
+  std::vector<StageTiming> stages;
+
+  // Wall time while the profiler was active (including uninstrumented code)
+  double totalMilliseconds = 0.0;
+
+  uint64_t bezierSegments = 0;
+  uint64_t emittedPoints = 0;
+  uint64_t clipperCalls = 0;
+  uint64_t offsetPasses = 0;
+  uint64_t toolpaths = 0;
+  uint64_t gcodeBytes = 0;
+
+  // Rapid travel between the toolpaths that were ordered, before and after
+  // ordering them (mm)
+  double rapidBefore = 0.0;
+  double rapidAfter = 0.0;
+
+  /**
+   * Get the total time spent in a stage
+   * @param name The stage name
+   * @return The accumulated milliseconds, or 0 if the stage did not run
+   */
+  double stageMilliseconds(const std::string &name) const;
+
+  /**
+   * Format the stats as human-readable text, one stage or counter per line
+   * @return The formatted summary
+   */
+  std::string summary() const;
+};
+
+/**
+ * Collects stage timings and counters from the core library.
+ *
+ * Instrumented code reports to the process-wide active profiler through the
+ * static count() and ScopedStageTimer helpers; when no profiler is active
+ * these are no-ops. Counters may be updated from any thread, but only one
+ * profiler can be active at a time and it must outlive the work it measures.
+ */
+class PipelineProfiler {
+ public:
+  PipelineProfiler();
+  ~PipelineProfiler();
+
+  PipelineProfiler(const PipelineProfiler &) = delete;
+  PipelineProfiler &operator=(const PipelineProfiler &) = delete;
+
+  /**
+   * Make this the active profiler and start its wall clock. Replaces any
+   * other active profiler.
+   */
+  void start();
+
+  /**
+   * Stop collecting (if this is the active profiler)
+   */
+  void stop();
+
+  /**
+   * Clear all collected timings and counters
+   */
+  void reset();
+
+  /**
+   * Get a snapshot of the collected timings and counters
+   * @return The collected stats
+   */
+  PipelineStats stats() const;
+
+  /**
+   * Add to a counter of the active profiler
+   * @param counter The counter to increment
+   * @param amount The amount to add
+   */
+  static void count(PipelineCounter counter, uint64_t amount = 1);
+
+  /**
+   * Record a stage timing on the active profiler
+   * @param name The stage name
+   * @param milliseconds The elapsed wall time
+   */
+  static void recordStage(const char *name, double milliseconds);
+
+  /**
+   * Check whether a profiler is currently collecting
+   * @return True if a profiler is active
+   */
+  static bool isActive();
+
+ private:
+  std::atomic<uint64_t> m_counters[static_cast<int>(PipelineCounter::COUNT)];
+  mutable std::mutex m_stageMutex;
+  std::vector<StageTiming> m_stages;
+  double m_activeMilliseconds = 0.0;  // Wall time of completed start/stop runs
+  bool m_running = false;
+  std::chrono::steady_clock::time_point m_startTime;
+
+  static std::atomic<PipelineProfiler *> s_active;
+};
+
+/**
+ * Times the enclosing scope and records it as a stage on the active profiler
+ */
+class ScopedStageTimer {
+ public:
+  explicit ScopedStageTimer(const char *name);
+  ~ScopedStageTimer();
+
+  ScopedStageTimer(const ScopedStageTimer &) = delete;
+  ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+ private:
+  const char *m_name;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_METRICS_H
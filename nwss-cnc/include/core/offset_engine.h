@@ -0,0 +1,129 @@
+#ifndef NWSS_CNC_OFFSET_ENGINE_H
+#define NWSS_CNC_OFFSET_ENGINE_H
+
+#include <clipper2/clipper.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Computes a family of offsets of one prepared input.
+ *
+ * The input is converted to Clipper2 coordinates and added once; each
+ * requested distance is then a single Execute on a ClipperOffset that
+ * already holds the paths. Rings of different distances are independent,
+ * so with more than one thread they are spread over the shared pool (one
+ * prepared ClipperOffset per worker). Results always come back in the order
+ * of the distances.
+ *
+ * Offsetting the original input by k * step gives the exact k-th ring of a
+ * stepover sequence, instead of compounding the arc approximation of every
+ * previous ring.
+ */
+class OffsetEngine {
+ public:
+  /**
+   * Offset options
+   */
+  struct Options {
+    double scale = 1000.0;      // Clipper2 units per mm
+    double miterLimit = 2.0;    // Miter limit for sharp corners
+    // Arc approximation tolerance in mm (0 = Clipper2 default, which
+    // scales with the distance)
+    double arcTolerance = 0.0;
+    Clipper2Lib::JoinType joinType = Clipper2Lib::JoinType::Round;
+    Clipper2Lib::EndType openEndType = Clipper2Lib::EndType::Round;
+    int threadCount = 1;  // Threads for independent rings (0 = all cores)
+  };
+
+  OffsetEngine() = default;
+  explicit OffsetEngine(const Options &options) : m_options(options) {}
+
+  /**
+   * Add input paths (already in Clipper2 coordinates) as one group.
+   * Clipper2 resolves orientation per group: holes added together with their
+   * outline are offset the opposite way, a path added on its own always
+   * grows outward for positive distances.
+   * @param paths The paths
+   * @param closed Whether they are closed outlines or open polylines
+   */
+  void addPaths(const Clipper2Lib::Paths64 &paths, bool closed);
+
+  /**
+   * Add one input path as its own group
+   * @param path The path (Clipper2 coordinates)
+   * @param closed Whether it is a closed outline or an open polyline
+   */
+  void addPath(const Clipper2Lib::Path64 &path, bool closed) {
+    addPaths(Clipper2Lib::Paths64{path}, closed);
+  }
+
+  // Remove all input paths
+  void clear() { m_groups.clear(); }
+
+  // Check if there is no input
+  bool empty() const { return m_groups.empty(); }
+
+  // Get the offset options
+  const Options &getOptions() const { return m_options; }
+
+  /**
+   * Offset the input by every distance
+   * @param distances Offset distances in mm (positive = outward)
+   * @param results Output rings, one entry per distance
+   * @param error Output message if Clipper2 failed
+   * @return true on success
+   */
+  bool offset(const std::vector<double> &distances,
+              std::vector<Clipper2Lib::Paths64> &results,
+              std::string &error) const;
+
+  /**
+   * Offset the input by firstDistance, firstDistance + step, ... until the
+   * rings collapse. The last ring returned is the first one that is empty
+   * or has no polygon with an area above minArea.
+   * @param firstDistance Distance of the first ring in mm
+   * @param step Distance between rings in mm (negative = inward)
+   * @param maxRings Maximum number of rings
+   * @param minArea Polygons at or below this area (mm^2) count as collapsed
+   * @param results Output rings, nearest first
+   * @param error Output message if Clipper2 failed
+   * @return true on success
+   */
+  bool offsetUntilCollapse(double firstDistance, double step, size_t maxRings,
+                           double minArea,
+                           std::vector<Clipper2Lib::Paths64> &results,
+                           std::string &error) const;
+
+ private:
+  // Add the input to a fresh ClipperOffset
+  void prepare(Clipper2Lib::ClipperOffset &clipperOffset) const;
+
+  // Run one offset on a prepared ClipperOffset
+  void execute(Clipper2Lib::ClipperOffset &clipperOffset, double distance,
+               Clipper2Lib::Paths64 &result) const;
+
+  // Check if a ring has no polygon above minArea (in Clipper2 units)
+  static bool isCollapsed(const Clipper2Lib::Paths64 &ring,
+                          double scaledMinArea);
+
+  /**
+   * Input paths added together
+   */
+  struct Group {
+    Clipper2Lib::Paths64 paths;
+    bool closed;
+  };
+
+  Options m_options;
+  std::vector<Group> m_groups;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_OFFSET_ENGINE_H
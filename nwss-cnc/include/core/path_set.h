@@ -0,0 +1,228 @@
+#ifndef NWSS_CNC_PATH_SET_H
+#define NWSS_CNC_PATH_SET_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "core/geometry.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Read-only view of the points of one path.
+ *
+ * The coordinates may be stored as separate x/y arrays (PathSet) or
+ * interleaved (Path), so code written against views accepts both without
+ * copying. A view is only valid while the underlying container is unchanged.
+ * Views of a Path with per-point depths also expose the depths.
+ */
+class PathView {
+ public:
+  /**
+   * Iterates the points of a view by value
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Point2D;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Point2D *;
+    using reference = Point2D;
+
+    Iterator(const PathView *view, size_t index)
+        : m_view(view), m_index(index) {}
+
+    Point2D operator*() const { return (*m_view)[m_index]; }
+    Iterator &operator++() {
+      ++m_index;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const {
+      return m_index == other.m_index;
+    }
+    bool operator!=(const Iterator &other) const {
+      return m_index != other.m_index;
+    }
+
+   private:
+    const PathView *m_view;
+    size_t m_index;
+  };
+
+  PathView() = default;
+
+  /**
+   * View strided coordinate arrays
+   * @param x Pointer to the first x coordinate
+   * @param y Pointer to the first y coordinate
+   * @param size Number of points
+   * @param stride Distance between consecutive coordinates, in doubles
+   */
+  PathView(const double *x, const double *y, size_t size, size_t stride = 1)
+      : m_x(x), m_y(y), m_size(size), m_stride(stride) {}
+
+  // Implicit so that a Path can be passed wherever a view is expected
+  PathView(const Path &path);
+
+  // Get number of points
+  size_t size() const { return m_size; }
+
+  // Check if the view is empty
+  bool empty() const { return m_size == 0; }
+
+  // Get the coordinates of a point
+  double x(size_t index) const { return m_x[index * m_stride]; }
+  double y(size_t index) const { return m_y[index * m_stride]; }
+
+  // Check if the points carry their own depths
+  bool hasDepths() const { return m_depth != nullptr; }
+
+  // Get the depth of a point (only if hasDepths())
+  double depth(size_t index) const { return m_depth[index]; }
+
+  // Get a point
+  Point2D operator[](size_t index) const {
+    return Point2D(x(index), y(index));
+  }
+  Point2D front() const { return (*this)[0]; }
+  Point2D back() const { return (*this)[m_size - 1]; }
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, m_size); }
+
+  // Copy the points (and depths) into a Path
+  Path toPath() const;
+
+  // Calculate the total length of the path
+  double length() const;
+
+ private:
+  const double *m_x = nullptr;
+  const double *m_y = nullptr;
+  const double *m_depth = nullptr;
+  size_t m_size = 0;
+  size_t m_stride = 1;
+};
+
+/**
+ * A set of paths stored as structure-of-arrays.
+ *
+ * All x coordinates live in one contiguous array, all y coordinates in
+ * another, and an offsets table records where each path starts. Building a
+ * set of many short paths therefore costs a handful of allocations instead
+ * of one per path, and whole-set passes (bounds, transforms) are linear
+ * scans over two arrays. Individual paths are accessed through PathView.
+ */
+class PathSet {
+ public:
+  /**
+   * Iterates the paths of a set as views
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = PathView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PathView *;
+    using reference = PathView;
+
+    Iterator(const PathSet *set, size_t index) : m_set(set), m_index(index) {}
+
+    PathView operator*() const { return m_set->path(m_index); }
+    Iterator &operator++() {
+      ++m_index;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const {
+      return m_index == other.m_index;
+    }
+    bool operator!=(const Iterator &other) const {
+      return m_index != other.m_index;
+    }
+
+   private:
+    const PathSet *m_set;
+    size_t m_index;
+  };
+
+  PathSet() = default;
+
+  // Copy a list of paths into a set
+  explicit PathSet(const std::vector<Path> &paths);
+
+  // Get number of paths
+  size_t size() const { return m_offsets.size(); }
+
+  // Check if the set has no paths
+  bool empty() const { return m_offsets.empty(); }
+
+  // Get the total number of points over all paths
+  size_t pointCount() const { return m_x.size(); }
+
+  // Reserve capacity for paths and points
+  void reserve(size_t pathCount, size_t pointCount);
+
+  // Remove all paths (keeps the capacity)
+  void clear();
+
+  // Start a new, empty path
+  void beginPath() { m_offsets.push_back(m_x.size()); }
+
+  // Add a point to the last path (starts one if the set is empty)
+  void addPoint(double x, double y) {
+    if (m_offsets.empty()) {
+      beginPath();
+    }
+    m_x.push_back(x);
+    m_y.push_back(y);
+  }
+  void addPoint(const Point2D &point) { addPoint(point.x, point.y); }
+
+  // Add a copy of a path (a Path or any other view); depths are not kept
+  void addPath(const PathView &path);
+
+  // Add copies of all paths of another set
+  void append(const PathSet &other);
+
+  // Transform every point in place
+  void transform(const AffineTransform &transform) {
+    transform.apply(m_x.data(), m_y.data(), m_x.size());
+  }
+
+  // Get a view of one path
+  PathView path(size_t index) const {
+    size_t start = m_offsets[index];
+    size_t end = index + 1 < m_offsets.size() ? m_offsets[index + 1]
+                                               : m_x.size();
+    return PathView(m_x.data() + start, m_y.data() + start, end - start);
+  }
+  PathView operator[](size_t index) const { return path(index); }
+
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, size()); }
+
+  // Coordinate arrays (pointCount() entries each); the mutable versions allow
+  // in-place transforms of every point
+  const double *xData() const { return m_x.data(); }
+  const double *yData() const { return m_y.data(); }
+  double *xData() { return m_x.data(); }
+  double *yData() { return m_y.data(); }
+
+  // Index of the first point of each path
+  const std::vector<size_t> &offsets() const { return m_offsets; }
+
+  // Copy the paths into a list of Path objects
+  std::vector<Path> toPaths() const;
+
+ private:
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::vector<size_t> m_offsets;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_PATH_SET_H
@@ -0,0 +1,45 @@
+#ifndef NWSS_CNC_SCANLINE_FILL_H
+#define NWSS_CNC_SCANLINE_FILL_H
+
+#include <clipper2/clipper.h>
+
+#include <vector>
+
+#include "core/fixed_point.h"
+#include "core/geometry.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Fills a region with parallel scanlines, clipped to its inside.
+ *
+ * The region's rings are rotated so the scanlines run along the x axis and
+ * their edges are put into an edge table sorted by their lower end. The
+ * scanlines are swept upwards with an active edge list: each line only
+ * intersects the edges it currently crosses, and the sorted crossings are
+ * paired into the spans inside the region (even-odd, so holes are left
+ * out). Spans on neighbouring lines that overlap are then linked into
+ * zig-zag paths, as long as the link between them stays inside the region,
+ * so a convex or gently curved area is cut without lifting the tool.
+ */
+class ScanlineFill {
+ public:
+  /**
+   * Fill a region with zig-zag paths
+   * @param region Closed rings in fixed point; outlines and holes are told
+   *               apart by the even-odd rule
+   * @param spacing Largest distance between scanlines in mm
+   * @param angle Scanline direction in degrees (0 = along the x axis)
+   * @param scale Fixed-point units per mm
+   * @return Zig-zag paths in mm, starting from the lowest scanline
+   */
+  static std::vector<Path> zigZag(const Clipper2Lib::Paths64 &region,
+                                  double spacing, double angle,
+                                  int scale = FixedPoint::kDefaultScale);
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_SCANLINE_FILL_H
@@ -0,0 +1,165 @@
+#ifndef NWSS_CNC_SEGMENT_GRID_H
+#define NWSS_CNC_SEGMENT_GRID_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/path_set.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Uniform grid spatial index over the line segments of a set of paths.
+ *
+ * Segments are collected with addPath() and bucketed into square cells by
+ * build(); afterwards queries only look at the segments in the cells a
+ * search box touches instead of every segment. The cells are stored as one
+ * flat index array (counting sort), so building is two linear passes and
+ * queries allocate nothing beyond the caller's output vector. A built grid
+ * is read-only and safe to query from several threads.
+ */
+class SegmentGrid {
+ public:
+  /**
+   * One indexed segment
+   */
+  struct Segment {
+    Point2D start;
+    Point2D end;
+    size_t pathIndex;     // Caller's index of the path
+    size_t segmentIndex;  // Index of the segment within its path
+  };
+
+  /**
+   * Result of a nearest-segment query
+   */
+  struct Match {
+    size_t segment = 0;     // Index into segment()
+    double distance = 0.0;  // Distance from the query point
+  };
+
+  SegmentGrid() = default;
+
+  /**
+   * Add the segments of a path
+   * @param path The path (a Path or a path of a PathSet)
+   * @param pathIndex Index reported back for these segments
+   * @param closed Whether to add the segment from the last point to the first
+   */
+  void addPath(const PathView &path, size_t pathIndex, bool closed = false);
+
+  /**
+   * Bucket the added segments into cells. Must be called before querying
+   * and again after adding more paths.
+   * @param cellSize Cell edge length (0 or less = derive from the average
+   *                 segment length). Grown automatically if it would create
+   *                 far more cells than segments.
+   */
+  void build(double cellSize = 0.0);
+
+  // Remove all segments and cells
+  void clear();
+
+  // Get number of indexed segments
+  size_t size() const { return m_segments.size(); }
+
+  // Check if there are no segments
+  bool empty() const { return m_segments.empty(); }
+
+  // Get an indexed segment
+  const Segment &segment(size_t index) const { return m_segments[index]; }
+
+  // Get the cell edge length chosen by build()
+  double cellSize() const { return m_cellSize; }
+
+  /**
+   * Collect the segments whose cells overlap a box
+   * @param minX Box minimum X
+   * @param minY Box minimum Y
+   * @param maxX Box maximum X
+   * @param maxY Box maximum Y
+   * @param result Output segment indices, sorted and without duplicates
+   *               (cleared first)
+   */
+  void query(double minX, double minY, double maxX, double maxY,
+             std::vector<size_t> &result) const;
+
+  /**
+   * Find the segment closest to a point
+   * @param point The query point
+   * @param maxDistance Only segments within this distance are considered
+   *                    (may be infinite)
+   * @param match Output nearest segment and its distance
+   * @return true if a segment was found within maxDistance
+   */
+  bool findNearest(const Point2D &point, double maxDistance,
+                   Match &match) const;
+
+  /**
+   * Find the first segment hit by a ray
+   * @param origin Start of the ray
+   * @param direction Unit direction of the ray
+   * @param maxDistance Ignore hits farther along the ray than this
+   * @param accept Returns false for segments the ray should pass through
+   *               (e.g. the segment the ray starts on)
+   * @param hit Output segment and distance along the ray
+   * @return true if a segment was hit within maxDistance
+   */
+  bool castRay(const Point2D &origin, const Point2D &direction,
+               double maxDistance, const std::function<bool(size_t)> &accept,
+               Match &hit) const;
+
+  /**
+   * Distance from a point to a segment
+   * @param point The point
+   * @param start Segment start
+   * @param end Segment end
+   * @return The shortest distance
+   */
+  static double pointSegmentDistance(const Point2D &point,
+                                     const Point2D &start, const Point2D &end);
+
+  // Squared distance from a point to a segment (no square root)
+  static double pointSegmentDistanceSquared(const Point2D &point,
+                                            const Point2D &start,
+                                            const Point2D &end);
+
+  /**
+   * Shortest distance between two segments
+   * @param a0 First segment start
+   * @param a1 First segment end
+   * @param b0 Second segment start
+   * @param b1 Second segment end
+   * @param onA Output closest point on the first segment
+   * @param onB Output closest point on the second segment
+   * @return The distance (0 if the segments cross)
+   */
+  static double segmentDistance(const Point2D &a0, const Point2D &a1,
+                                const Point2D &b0, const Point2D &b1,
+                                Point2D &onA, Point2D &onB);
+
+ private:
+  // Cell range covered by a box, clamped to the grid
+  void cellRange(double minX, double minY, double maxX, double maxY,
+                 size_t &x0, size_t &y0, size_t &x1, size_t &y1) const;
+
+  std::vector<Segment> m_segments;
+
+  double m_minX = 0.0;
+  double m_minY = 0.0;
+  double m_cellSize = 0.0;
+  size_t m_columns = 0;
+  size_t m_rows = 0;
+
+  // Segments of cell c are m_cellItems[m_cellStart[c] .. m_cellStart[c + 1])
+  std::vector<size_t> m_cellStart;
+  std::vector<size_t> m_cellItems;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_SEGMENT_GRID_H
@@ -0,0 +1,65 @@
+#ifndef NWSS_CNC_SEGMENT_INTERSECTOR_H
+#define NWSS_CNC_SEGMENT_INTERSECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/path_set.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Finds the points where a path crosses or touches itself.
+ *
+ * Segments are sorted by their extent along the longer axis of the path and
+ * swept in that order; each segment is only tested against the segments
+ * whose extent is still open when it starts and that overlap it on the
+ * other axis. Flattened outlines made of many short segments therefore need
+ * close to O(n log n) work instead of testing every pair, and a query that
+ * only asks whether any intersection exists stops at the first one.
+ *
+ * Segment i runs from point i to point i + 1; for closed paths the last
+ * segment runs from the last point back to the first. Neighbouring
+ * segments (i and i + 1, and the last and first segment of a closed path or
+ * of one ending on its first point) meeting at their shared point do not
+ * count as an intersection. Any other two segments sharing a point do (a
+ * figure-8 pinch, a contour touching itself), as does a path that doubles
+ * back over itself.
+ */
+class SegmentIntersector {
+ public:
+  /**
+   * One intersection between two segments of a path
+   */
+  struct Intersection {
+    Point2D point;  // A point common to both segments
+    size_t first;   // Lower segment index
+    size_t second;  // Higher segment index
+  };
+
+  /**
+   * Find the self-intersections of a path
+   * @param path The path (a Path, a path of a PathSet or a polygon view)
+   * @param closed Whether to include the segment from the last point back
+   *               to the first
+   * @param maxResults Stop after this many intersections (0 = find all)
+   * @return Intersections ordered by segment indices
+   */
+  static std::vector<Intersection> findSelfIntersections(
+      const PathView &path, bool closed, size_t maxResults = 0);
+
+  /**
+   * Check if a path intersects itself (stops at the first intersection)
+   * @param path The path
+   * @param closed Whether to include the closing segment
+   * @return true if the path crosses or touches itself
+   */
+  static bool hasSelfIntersections(const PathView &path, bool closed);
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_SEGMENT_INTERSECTOR_H
@@ -0,0 +1,78 @@
+#ifndef NWSS_CNC_THREAD_POOL_H
+#define NWSS_CNC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Fixed-size pool of worker threads for data-parallel loops.
+ *
+ * parallelFor() hands out loop indices dynamically (one atomic counter per
+ * loop), so uneven work items balance across threads. The calling thread
+ * takes part in the loop, which keeps nested or concurrent calls from
+ * deadlocking when every worker is busy.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Create a pool
+   * @param workerCount Number of worker threads (in addition to callers)
+   */
+  explicit ThreadPool(size_t workerCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * Get the process-wide pool, sized to the hardware concurrency
+   * @return The shared pool
+   */
+  static ThreadPool &shared();
+
+  /**
+   * Resolve a user-facing thread count setting
+   * @param requested Requested thread count (0 or less = hardware concurrency)
+   * @return The number of threads to use (at least 1)
+   */
+  static size_t resolveThreadCount(int requested);
+
+  /**
+   * Get the number of worker threads
+   * @return The worker count
+   */
+  size_t workerCount() const { return m_workers.size(); }
+
+  /**
+   * Run task(i) for every i in [0, count) and wait for completion. The first
+   * exception thrown by a task is rethrown on the calling thread.
+   * @param count Number of loop iterations
+   * @param maxThreads Maximum number of threads working on the loop,
+   *                   including the caller
+   * @param task The loop body; must be safe to call concurrently
+   */
+  void parallelFor(size_t count, size_t maxThreads,
+                   const std::function<void(size_t)> &task);
+
+ private:
+  std::vector<std::thread> m_workers;
+  std::deque<std::function<void()>> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping = false;
+
+  void workerLoop();
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_THREAD_POOL_H
@@ -73,6 +73,7 @@ struct Tool {
   double length;           // Tool length in mm
   double fluteLength;      // Flute length in mm
   int fluteCount;          // Number of flutes
+  double tipAngle;         // Included angle of the tip in degrees (V-bits)
   ToolMaterial material;   // Tool material
   ToolCoating coating;     // Tool coating
   double maxDepthOfCut;    // Maximum depth of cut per pass
@@ -92,6 +93,7 @@ struct Tool {
         length(0.0),
         fluteLength(0.0),
         fluteCount(2),
+        tipAngle(0.0),
         material(ToolMaterial::HSS),
         coating(ToolCoating::NONE),
         maxDepthOfCut(0.0),
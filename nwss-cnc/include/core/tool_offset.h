@@ -7,6 +7,8 @@
 #include <vector>
 
 #include "core/geometry.h"
+#include "core/offset_engine.h"
+#include "core/path_set.h"
 #include "core/tool.h"
 
 namespace nwss {
@@ -36,6 +38,9 @@ class ToolOffset {
     double precision;  // Coordinate precision (mm)
     int scaleFactor;   // Internal scaling factor for Clipper2
 
+    // Threads for independent offset distances (0 = all cores)
+    int threadCount;
+
     // Constructor with default values
     OffsetOptions()
         : arcTolerance(0.25),
@@ -46,7 +51,30 @@ class ToolOffset {
           maxOffsetRatio(0.8),
           validateResults(true),
           precision(0.001),
-          scaleFactor(1000) {}
+          scaleFactor(1000),
+          threadCount(1) {}
+  };
+
+  /**
+   * Offset accuracy ("offset QA"): how far the points of the offset paths
+   * are from the nearest segment of the original paths. For a correct
+   * offset every distance equals the tool radius.
+   */
+  struct OffsetQualityReport {
+    size_t samples;           // Offset points measured
+    double expectedDistance;  // Requested offset (tool radius, mm)
+    double minDistance;       // Closest offset point to the original (mm)
+    double maxDistance;       // Farthest offset point from the original (mm)
+    double meanDistance;      // Mean distance (mm)
+    double maxDeviation;      // Largest |distance - expected| (mm)
+
+    OffsetQualityReport()
+        : samples(0),
+          expectedDistance(0.0),
+          minDistance(0.0),
+          maxDistance(0.0),
+          meanDistance(0.0),
+          maxDeviation(0.0) {}
   };
 
   /**
@@ -63,13 +91,15 @@ class ToolOffset {
     size_t resultPathCount;
     double originalTotalLength;
     double resultTotalLength;
-    double actualOffsetDistance;
+    double actualOffsetDistance;  // Mean distance from the original
+    OffsetQualityReport quality;   // Offset accuracy (when offset)
 
     // Validation metrics
     double minFeatureSize;
     double maxFeatureSize;
     bool hasDegenerate;
     bool hasSelfIntersections;
+    std::vector<Point2D> selfIntersectionPoints;  // Crossings (first 1000)
 
     // Constructor with default values
     OffsetResult()
@@ -85,6 +115,29 @@ class ToolOffset {
           hasSelfIntersections(false) {}
   };
 
+  /**
+   * Result of a batched offset over many independent contours
+   */
+  struct BatchOffsetResult {
+    std::vector<Path> paths;          // Offset rings
+    std::vector<size_t> sourceIndex;  // Input path each ring was traced from
+
+    // Per input path: index of the input whose ring absorbed this path's
+    // offset (the offsets overlapped and were merged), or -1
+    std::vector<int> mergedInto;
+
+    bool success;                       // Whether the offset ran
+    std::vector<std::string> warnings;  // Non-fatal issues
+    std::vector<std::string> errors;    // Fatal errors
+    size_t clipperCalls;                // Offset executions performed
+    ToolOffsetDirection direction;      // Direction after resolving AUTO
+
+    BatchOffsetResult()
+        : success(false),
+          clipperCalls(0),
+          direction(ToolOffsetDirection::ON_PATH) {}
+  };
+
   /**
    * Calculate tool offset using Clipper2 (primary method)
    * @param originalPaths The original paths to offset
@@ -100,22 +153,53 @@ class ToolOffset {
 
   /**
    * Calculate tool offset for a single path (convenience method)
-   * @param originalPath The original path to offset
+   * @param originalPath The original path to offset (a Path or a path of a
+   *                     PathSet)
    * @param toolDiameter The diameter of the cutting tool
    * @param offsetDirection Direction to offset the path
    * @param options Advanced offsetting options
    * @return Complete offset result with validation
    */
   static OffsetResult calculateToolOffset(
-      const Path &originalPath, double toolDiameter,
+      const PathView &originalPath, double toolDiameter,
       ToolOffsetDirection offsetDirection,
       const OffsetOptions &options = OffsetOptions{});
 
   /**
-   * Calculate multiple offset passes (for roughing/finishing operations)
-   * @param originalPaths The original paths to offset
+   * Offset all contours of a design in one Clipper2 execution.
+   *
+   * The closed contours are first merged into one region (even-odd), so
+   * contours nested inside others are treated as holes and offset the
+   * opposite way: OUTSIDE grows the outlines and shrinks the holes. Open
+   * paths are offset along both sides with round ends. Each resulting ring
+   * is attributed to the input contours that produced it, found through a
+   * SegmentGrid lookup of the nearest input segment for each ring vertex.
+   * Inputs without a ring of their own either merged into a neighbour's
+   * (mergedInto) or collapsed.
+   *
+   * @param originalPaths The contours to offset
    * @param toolDiameter The diameter of the cutting tool
-   * @param offsetDistances List of offset distances to apply
+   * @param offsetDirection Direction to offset (AUTO uses the winding of the
+   *                        whole set, as calculateToolOffset does)
+   * @param options Advanced offsetting options (result validation is not
+   *                run per contour)
+   * @return Offset rings mapped back to their inputs
+   */
+  static BatchOffsetResult calculateBatchToolOffset(
+      const std::vector<Path> &originalPaths, double toolDiameter,
+      ToolOffsetDirection offsetDirection,
+      const OffsetOptions &options = OffsetOptions{});
+
+  /**
+   * Calculate multiple offset passes (for roughing/finishing operations).
+   * The paths are cleaned, checked and converted once; every distance is
+   * then one execution of an OffsetEngine holding them, spread over
+   * options.threadCount threads.
+   * @param originalPaths The original paths to offset
+   * @param toolDiameter The diameter of the cutting tool (checked against
+   *                     the minimum feature size; 0 skips the check)
+   * @param offsetDistances Offset distances to apply (positive = outside,
+   *                        negative = inside, 0 = on the path)
    * @param options Advanced offsetting options
    * @return Vector of offset results, one per distance
    */
@@ -144,9 +228,23 @@ class ToolOffset {
       const std::vector<Path> &paths);
 
   /**
-   * Calculate minimum feature size in a set of paths
+   * Measure the accuracy of an offset: the distance from every offset point
+   * to the nearest original segment, found through a SegmentGrid
+   * @param originalPaths The paths that were offset
+   * @param offsetPaths The offset result
+   * @param expectedOffset The requested offset distance (mm)
+   * @return The accuracy report (no samples if either side is empty)
+   */
+  static OffsetQualityReport measureOffsetQuality(
+      const std::vector<Path> &originalPaths,
+      const std::vector<Path> &offsetPaths, double expectedOffset);
+
+  /**
+   * Calculate minimum feature size in a set of paths (narrowest gap between
+   * facing walls of each closed path, inside or outside it, measured on
+   * its medial axis, see MedialAxis::narrowestWidth)
    * @param paths The paths to analyze
-   * @return Minimum feature size found (mm)
+   * @return Minimum feature size found (mm), 0 if none was measured
    */
   static double calculateMinimumFeatureSize(const std::vector<Path> &paths);
 
@@ -178,31 +276,44 @@ class ToolOffset {
                                          double tolerance = 0.01);
 
  private:
-  // Core Clipper2 operations
-  static Clipper2Lib::Paths64 pathsToClipper(const std::vector<Path> &paths,
-                                             int scaleFactor);
-  static std::vector<Path> clipperToPaths(
-      const Clipper2Lib::Paths64 &clipperPaths, int scaleFactor);
-  static Clipper2Lib::Path64 pathToClipper(const Path &path, int scaleFactor);
-  static Path clipperToPath(const Clipper2Lib::Path64 &clipperPath,
-                            int scaleFactor);
-
   // Offset calculation helpers
   static double calculateOffsetAmount(double toolDiameter,
                                       ToolOffsetDirection direction,
                                       bool isClockwise);
   static Clipper2Lib::JoinType getJoinType(const OffsetOptions &options);
   static Clipper2Lib::EndType getEndType(bool isClosedPath);
+  static OffsetEngine::Options getEngineOptions(const OffsetOptions &options);
   static bool isPathClosed(const Path &path, double tolerance = 0.001);
   static bool isClockwise(const Path &path);
 
+  // Remove near-duplicate points; false if the path is degenerate
+  static bool cleanupPath(const Path &path, double tolerance, Path &cleaned);
+
+  // Check if an offset ring is large enough to keep
+  static bool isUsableOffsetPath(const Path &path,
+                                 const OffsetOptions &options);
+
+  // Clean, check and convert the input of an offset into an engine
+  static bool prepareOffsetInput(const std::vector<Path> &originalPaths,
+                                 double toolDiameter,
+                                 const OffsetOptions &options,
+                                 OffsetResult &result,
+                                 std::vector<Path> &cleanedPaths,
+                                 OffsetEngine &engine);
+
+  // Filter, measure and validate the rings of one offset distance
+  static void finishOffsetResult(const Clipper2Lib::Paths64 &offsetPaths,
+                                 const std::vector<Path> &cleanedPaths,
+                                 double offsetAmount,
+                                 const OffsetOptions &options,
+                                 OffsetResult &result);
+
   // Validation and analysis
   static OffsetResult validateOffsetResult(
       const std::vector<Path> &originalPaths,
       const std::vector<Path> &offsetPaths, double expectedOffset,
       const OffsetOptions &options);
   static double calculatePathLength(const Path &path);
-  static double calculateActualOffset(const Path &original, const Path &offset);
   static bool hasValidGeometry(const Path &path);
   static bool hasSelfIntersections(const Path &path);
 
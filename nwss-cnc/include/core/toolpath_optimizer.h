@@ -0,0 +1,151 @@
+#ifndef NWSS_CNC_TOOLPATH_OPTIMIZER_H
+#define NWSS_CNC_TOOLPATH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "core/geometry.h"
+#include "core/path_set.h"
+
+namespace nwss {
+namespace cnc {
+
+/**
+ * Rapid travel between toolpaths before and after ordering them
+ */
+struct ToolpathOrderReport {
+  double rapidBefore = 0.0;  // Travel in the given order (mm)
+  double rapidAfter = 0.0;   // Travel in the optimized order (mm)
+  size_t reversedPaths = 0;  // Open toolpaths now cut from their last point
+  size_t rotatedLoops = 0;   // Closed toolpaths now entered at another vertex
+
+  // Get the travel saved (mm)
+  double saved() const { return rapidBefore - rapidAfter; }
+};
+
+/**
+ * Orders toolpaths to shorten the rapid travel between them.
+ *
+ * A first tour is built greedily: from the end of each toolpath the nearest
+ * entry of a remaining toolpath (either end of an open toolpath, any vertex
+ * of a closed one) is looked up in a uniform grid of the entries. The tour
+ * is then improved with 2-opt moves, which reverse a stretch of the tour
+ * and every toolpath in it, and Or-opt moves, which move a run of up to
+ * three toolpaths elsewhere in either direction. Both only try tour
+ * positions within a window of each other, so a pass is linear in the
+ * number of toolpaths; passes repeat until one finds no improvement.
+ * Finally the seam of every closed toolpath is moved to the vertex closest
+ * to both of its neighbours, except on toolpaths cut at varying depths.
+ *
+ * By default closed toolpaths lying inside another closed toolpath are cut
+ * before it, so inner contours are cut while the part is still held by the
+ * stock around its outline; nested toolpaths can also keep the order they
+ * were generated in instead (Options::nesting). Travel is the straight-line
+ * distance from the end of one toolpath to the start of the next, beginning
+ * at Options::start.
+ */
+class ToolpathOptimizer {
+ public:
+  /**
+   * Order of toolpaths lying inside other toolpaths
+   */
+  enum class Nesting {
+    ANY,          // No constraint
+    INNER_FIRST,  // Inside first, so a part stays held while its holes are
+                  // cut
+    KEEP          // Toolpaths within the bounding box of another keep
+                  // their given order to it (pocket rings and spirals
+                  // keep their direction)
+  };
+
+  /**
+   * Ordering options
+   */
+  struct Options {
+    // Open toolpaths may be cut from either end. Off where the direction
+    // matters (climb milling, spiral direction).
+    bool reverseOpenPaths = true;
+    // Closed toolpaths may start at any of their vertices (except those
+    // cut at varying depths, which keep their start)
+    bool rotateLoops = true;
+    // Order of nested closed toolpaths
+    Nesting nesting = Nesting::INNER_FIRST;
+    // Tour positions apart that a 2-opt or Or-opt move may connect
+    int window = 32;
+    // Most improvement passes (0 = greedy tour only)
+    int maxPasses = 16;
+    // Largest gap between the ends of a closed toolpath (mm)
+    double closedTolerance = 0.001;
+    // Tool position before the first toolpath
+    Point2D start;
+  };
+
+  /**
+   * One toolpath of a cutting order
+   */
+  struct Step {
+    size_t index = 0;       // Toolpath to cut
+    bool reversed = false;  // Open toolpath cut from its last point
+    size_t seam = 0;        // Vertex a closed toolpath starts and ends at
+  };
+
+  ToolpathOptimizer() = default;
+  explicit ToolpathOptimizer(const Options &options) : m_options(options) {}
+
+  /**
+   * Reorder toolpaths in place
+   * @param toolpaths The toolpaths
+   * @param groups Group of each toolpath (e.g. its tool), or empty for one
+   *               group. Only runs of consecutive toolpaths in the same
+   *               group are reordered, so groups keep their order.
+   * @return The travel before and after
+   */
+  ToolpathOrderReport optimize(
+      std::vector<Path> &toolpaths,
+      const std::vector<int> &groups = std::vector<int>()) const;
+
+  /**
+   * Find a cutting order for a set of toolpaths without moving them. Empty
+   * toolpaths are not cut and get no step.
+   * @param toolpaths The toolpaths
+   * @param steps Output toolpaths in cutting order, each with its entry
+   * @return The travel before and after
+   */
+  ToolpathOrderReport order(const PathSet &toolpaths,
+                            std::vector<Step> &steps) const;
+
+  /**
+   * Copy toolpaths in a cutting order, each turned to its entry
+   * @param toolpaths The toolpaths the order was found for
+   * @param steps The cutting order
+   * @param output Output toolpaths (replaced)
+   */
+  static void applyOrder(const PathSet &toolpaths,
+                         const std::vector<Step> &steps, PathSet &output);
+
+  /**
+   * Measure the rapid travel between toolpaths in their current order
+   * @param toolpaths The toolpaths
+   * @param start Tool position before the first toolpath
+   * @return The travel (mm)
+   */
+  static double rapidDistance(const std::vector<Path> &toolpaths,
+                              const Point2D &start = Point2D());
+
+  // Get the ordering options
+  const Options &getOptions() const { return m_options; }
+
+ private:
+  // Order one run of toolpaths, starting from a tool position, adding
+  // their steps
+  void orderRun(const std::vector<PathView> &toolpaths, size_t begin,
+                size_t end, const Point2D &start, std::vector<Step> &steps,
+                ToolpathOrderReport &report) const;
+
+  Options m_options;
+};
+
+}  // namespace cnc
+}  // namespace nwss
+
+#endif  // NWSS_CNC_TOOLPATH_OPTIMIZER_H
@@ -6,6 +6,7 @@
 
 #include "core/config.h"
 #include "core/geometry.h"
+#include "core/path_set.h"
 
 namespace nwss {
 namespace cnc {
@@ -57,6 +58,36 @@ class Transform {
   static bool getBounds(const std::vector<Path> &paths, double &minX,
                         double &minY, double &maxX, double &maxY);
 
+  /**
+   * Get the bounding box of a path set
+   *
+   * @param paths The paths to analyze
+   * @param minX Output parameter for minimum X coordinate
+   * @param minY Output parameter for minimum Y coordinate
+   * @param maxX Output parameter for maximum X coordinate
+   * @param maxY Output parameter for maximum Y coordinate
+   * @return true if the set has at least one point
+   */
+  static bool getBounds(const PathSet &paths, double &minX, double &minY,
+                        double &maxX, double &maxY);
+
+  /**
+   * Apply an affine transform to every point of a set of paths, in place
+   *
+   * @param paths The paths to transform
+   * @param transform The composed transform to apply
+   */
+  static void applyTransform(std::vector<Path> &paths,
+                             const AffineTransform &transform);
+
+  /**
+   * Apply an affine transform to every point of a path set, in place
+   *
+   * @param paths The paths to transform
+   * @param transform The composed transform to apply
+   */
+  static void applyTransform(PathSet &paths, const AffineTransform &transform);
+
   /**
    * Scale and translate paths to fit within material bounds
    *
@@ -75,6 +106,16 @@ class Transform {
                             bool centerX = true, bool centerY = true,
                             bool flipY = true, TransformInfo *info = nullptr);
 
+  /**
+   * Scale and translate a path set to fit within material bounds. Same
+   * behavior as the std::vector<Path> overload, applied directly to the
+   * set's coordinate arrays.
+   */
+  static bool fitToMaterial(PathSet &paths, const CNConfig &config,
+                            bool preserveAspectRatio = true,
+                            bool centerX = true, bool centerY = true,
+                            bool flipY = true, TransformInfo *info = nullptr);
+
   /**
    * Format the transform information into a human-readable string
    *
@@ -16,6 +16,7 @@
 #include <QToolBar>
 #include <QtWidgets>
 
+#include "core/metrics.h"
 #include "core/tool.h"
 #include "gcodeeditor.h"
 #include "gcodeoptionspanel.h"
@@ -70,6 +71,9 @@ class MainWindow : public QMainWindow {
   QString currentFile;
   bool isUntitled;
 
+  // Stage timings and counters of the last G-code conversion
+  nwss::cnc::PipelineStats lastPipelineStats;
+
   QTabWidget *tabWidget;
   GCodeOptionsPanel *gcodeOptionsPanel;
   GCodeEditor *gCodeEditor;
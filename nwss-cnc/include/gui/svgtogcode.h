@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QString>
 
+#include "core/metrics.h"
+
 // Forward declarations for nwss-cnc library types
 namespace nwss {
 namespace cnc {
@@ -50,9 +52,15 @@ class SvgToGCode : public QObject {
 
   TimeEstimate getTimeEstimate() const { return m_timeEstimate; }
 
+  // Get stage timings and counters of the last conversion
+  const nwss::cnc::PipelineStats &getPipelineStats() const {
+    return m_pipelineStats;
+  }
+
  private:
   QString m_lastError;
   TimeEstimate m_timeEstimate;
+  nwss::cnc::PipelineStats m_pipelineStats;
 };
 
 #endif  // SVGTOGCODE_H
\ No newline at end of file
@@ -100,6 +100,7 @@ class ToolManager : public QDialog {
   QDoubleSpinBox *m_lengthSpin;
   QDoubleSpinBox *m_fluteLengthSpin;
   QSpinBox *m_fluteCountSpin;
+  QDoubleSpinBox *m_tipAngleSpin;
   QComboBox *m_materialCombo;
   QComboBox *m_coatingCombo;
   QDoubleSpinBox *m_maxDepthSpin;
@@ -0,0 +1,431 @@
+// main.cpp - nwss-cnc-cli
+//
+// Headless SVG to G-code converter built on nwss-cnc-core. Runs the same
+// pipeline as the desktop application (parse, discretize, fit to material,
+// tool offsets / CAM, G-code emission) without Qt, so batches of files can be
+// converted on build machines in parallel processes.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/config.h"
+#include "core/discretizer.h"
+#include "core/gcode_generator.h"
+#include "core/geometry.h"
+#include "core/log.h"
+#include "core/metrics.h"
+#include "core/path_set.h"
+#include "core/svg_parser.h"
+#include "core/tool.h"
+#include "core/transform.h"
+
+using namespace nwss::cnc;
+
+namespace {
+
+// Process exit codes
+const int kExitSuccess = 0;
+const int kExitUsage = 1;
+const int kExitInputError = 2;
+const int kExitGenerationError = 3;
+
+/**
+ * Options collected from the command line
+ */
+struct CliOptions {
+  std::string inputFile;
+  std::string outputFile;  // Empty = stdout
+  std::string toolsFile;   // Empty = default tool registry location
+  std::string configFile;  // Empty = built-in machine defaults
+  float dpi = 96.0f;
+
+  DiscretizerConfig discretizer;
+
+  bool preserveAspectRatio = true;
+  bool center = true;
+  bool flipY = true;
+
+  int toolId = 0;  // 0 = no tool (no offsets, perimeter only)
+  int restToolId = 0;  // 0 = no rest machining
+  ToolOffsetDirection offsetDirection = ToolOffsetDirection::AUTO;
+  bool enableToolOffsets = true;
+  bool batchToolOffsets = false;
+  CutoutMode cutoutMode = CutoutMode::PERIMETER;
+  double stepover = 0.5;
+  double maxStepover = 2.0;
+  bool spiralIn = true;
+  bool optimizePaths = false;
+  bool includeComments = false;
+  bool linearizePaths = true;
+  bool quiet = false;
+  bool verbose = false;
+  bool stats = false;  // Print stage timings and counters to stderr
+};
+
+void printUsage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options] <input.svg>\n"
+      << "\n"
+      << "Converts an SVG file to G-code and writes it to stdout (or -o).\n"
+      << "\n"
+      << "Input / output:\n"
+      << "  -o, --output <file>      Write G-code to file instead of stdout\n"
+      << "  -c, --config <file>      Machine/material config (CNConfig INI)\n"
+      << "  -t, --tools <file>       Tool registry file\n"
+      << "      --dpi <value>        DPI used for px units (default 96)\n"
+      << "\n"
+      << "Discretization:\n"
+      << "      --bezier-samples <n> Samples per bezier curve (default 10)\n"
+      << "      --adaptive <value>   Adaptive sampling tolerance (0 = off)\n"
+      << "      --flattening <method>\n"
+      << "                           subdivision | wang (with --adaptive)\n"
+      << "      --simplify <value>   Path simplification tolerance (0 = off)\n"
+      << "      --max-point-distance <value>\n"
+      << "                           Maximum distance between points (SVG\n"
+      << "                           units, before scaling) and G01 move\n"
+      << "                           length (mm) (default 1, 0 = off)\n"
+      << "      --threads <n>        Worker threads (default 0 = all cores)\n"
+      << "\n"
+      << "Placement:\n"
+      << "      --stretch            Do not preserve the aspect ratio\n"
+      << "      --no-center          Do not center the design on the material\n"
+      << "      --no-flip            Do not flip the Y axis\n"
+      << "\n"
+      << "Cutting:\n"
+      << "      --tool <id>          Tool ID from the registry\n"
+      << "      --rest-tool <id>     Smaller tool that clears what --tool\n"
+      << "                           cannot reach (pocket, adaptive)\n"
+      << "      --offset <dir>       auto | inside | outside | on\n"
+      << "      --no-offsets         Disable tool offset compensation\n"
+      << "      --batch-offsets      Offset all paths in one pass (holes and\n"
+      << "                           overlapping offsets merged)\n"
+      << "      --mode <mode>        perimeter | punchout | pocket | engrave |\n"
+      << "                           adaptive\n"
+      << "      --stepover <value>   Stepover as fraction of tool diameter\n"
+      << "      --max-stepover <mm>  Maximum stepover in mm\n"
+      << "      --spiral-out         Pocket from the inside out\n"
+      << "      --optimize           Order perimeter cuts to shorten travel\n"
+      << "      --comments           Include comments in the G-code\n"
+      << "      --no-linearize       Emit every point as its own G01 move\n"
+      << "\n"
+      << "  -q, --quiet              Only report errors and warnings\n"
+      << "  -v, --verbose            Print core library debug messages\n"
+      << "      --stats              Print stage timings and counters\n"
+      << "  -h, --help               Show this message\n";
+}
+
+bool parseCutoutMode(const std::string &value, CutoutMode &mode) {
+  if (value == "perimeter") {
+    mode = CutoutMode::PERIMETER;
+  } else if (value == "punchout") {
+    mode = CutoutMode::PUNCHOUT;
+  } else if (value == "pocket") {
+    mode = CutoutMode::POCKET;
+  } else if (value == "engrave") {
+    mode = CutoutMode::ENGRAVE;
+  } else if (value == "adaptive") {
+    mode = CutoutMode::ADAPTIVE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseFlatteningMethod(const std::string &value,
+                           FlatteningMethod &method) {
+  if (value == "subdivision") {
+    method = FlatteningMethod::SUBDIVISION;
+  } else if (value == "wang") {
+    method = FlatteningMethod::WANG;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseOffsetDirection(const std::string &value,
+                          ToolOffsetDirection &direction) {
+  if (value == "auto") {
+    direction = ToolOffsetDirection::AUTO;
+  } else if (value == "inside") {
+    direction = ToolOffsetDirection::INSIDE;
+  } else if (value == "outside") {
+    direction = ToolOffsetDirection::OUTSIDE;
+  } else if (value == "on") {
+    direction = ToolOffsetDirection::ON_PATH;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Parse the command line
+ * @return False on a usage error (message already printed)
+ */
+bool parseArguments(int argc, char *argv[], CliOptions &options,
+                    bool &showHelp) {
+  showHelp = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+
+    // Options that take a value
+    auto value = [&](std::string &out) -> bool {
+      if (i + 1 >= argc) {
+        std::cerr << "Error: Missing value for " << arg << std::endl;
+        return false;
+      }
+      out = argv[++i];
+      return true;
+    };
+
+    std::string v;
+    if (arg == "-h" || arg == "--help") {
+      showHelp = true;
+      return true;
+    } else if (arg == "-o" || arg == "--output") {
+      if (!value(options.outputFile)) return false;
+    } else if (arg == "-c" || arg == "--config") {
+      if (!value(options.configFile)) return false;
+    } else if (arg == "-t" || arg == "--tools") {
+      if (!value(options.toolsFile)) return false;
+    } else if (arg == "--dpi") {
+      if (!value(v)) return false;
+      options.dpi = static_cast<float>(std::atof(v.c_str()));
+    } else if (arg == "--bezier-samples") {
+      if (!value(v)) return false;
+      options.discretizer.bezierSamples = std::atoi(v.c_str());
+    } else if (arg == "--adaptive") {
+      if (!value(v)) return false;
+      options.discretizer.adaptiveSampling = std::atof(v.c_str());
+    } else if (arg == "--flattening") {
+      if (!value(v)) return false;
+      if (!parseFlatteningMethod(v, options.discretizer.flatteningMethod)) {
+        std::cerr << "Error: Unknown flattening method: " << v << std::endl;
+        return false;
+      }
+    } else if (arg == "--simplify") {
+      if (!value(v)) return false;
+      options.discretizer.simplifyTolerance = std::atof(v.c_str());
+    } else if (arg == "--max-point-distance") {
+      if (!value(v)) return false;
+      options.discretizer.maxPointDistance = std::atof(v.c_str());
+    } else if (arg == "--threads") {
+      if (!value(v)) return false;
+      options.discretizer.threadCount = std::atoi(v.c_str());
+    } else if (arg == "--stretch") {
+      options.preserveAspectRatio = false;
+    } else if (arg == "--no-center") {
+      options.center = false;
+    } else if (arg == "--no-flip") {
+      options.flipY = false;
+    } else if (arg == "--tool") {
+      if (!value(v)) return false;
+      options.toolId = std::atoi(v.c_str());
+    } else if (arg == "--rest-tool") {
+      if (!value(v)) return false;
+      options.restToolId = std::atoi(v.c_str());
+    } else if (arg == "--offset") {
+      if (!value(v)) return false;
+      if (!parseOffsetDirection(v, options.offsetDirection)) {
+        std::cerr << "Error: Unknown offset direction: " << v << std::endl;
+        return false;
+      }
+    } else if (arg == "--no-offsets") {
+      options.enableToolOffsets = false;
+    } else if (arg == "--batch-offsets") {
+      options.batchToolOffsets = true;
+    } else if (arg == "--mode") {
+      if (!value(v)) return false;
+      if (!parseCutoutMode(v, options.cutoutMode)) {
+        std::cerr << "Error: Unknown cutout mode: " << v << std::endl;
+        return false;
+      }
+    } else if (arg == "--stepover") {
+      if (!value(v)) return false;
+      options.stepover = std::atof(v.c_str());
+    } else if (arg == "--max-stepover") {
+      if (!value(v)) return false;
+      options.maxStepover = std::atof(v.c_str());
+    } else if (arg == "--spiral-out") {
+      options.spiralIn = false;
+    } else if (arg == "--optimize") {
+      options.optimizePaths = true;
+    } else if (arg == "--comments") {
+      options.includeComments = true;
+    } else if (arg == "--no-linearize") {
+      options.linearizePaths = false;
+    } else if (arg == "-q" || arg == "--quiet") {
+      options.quiet = true;
+    } else if (arg == "-v" || arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg == "--stats") {
+      options.stats = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Error: Unknown option: " << arg << std::endl;
+      return false;
+    } else if (options.inputFile.empty()) {
+      options.inputFile = arg;
+    } else {
+      std::cerr << "Error: Only one input file may be given" << std::endl;
+      return false;
+    }
+  }
+
+  if (options.inputFile.empty()) {
+    std::cerr << "Error: No input SVG file given" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int run(const CliOptions &options, std::ostream &gcodeOut) {
+  std::ostream &log = std::cerr;
+
+  // Machine and material configuration
+  CNConfig config;
+  if (!options.configFile.empty() && !config.loadFromFile(options.configFile)) {
+    log << "Error: Could not load config file: " << options.configFile
+        << std::endl;
+    return kExitInputError;
+  }
+
+  // Tool registry
+  ToolRegistry registry;
+  if (!options.toolsFile.empty() && !registry.loadFromFile(options.toolsFile)) {
+    log << "Error: Could not load tool registry: " << options.toolsFile
+        << std::endl;
+    return kExitInputError;
+  }
+
+  const Tool *tool = nullptr;
+  if (options.toolId != 0) {
+    tool = registry.getTool(options.toolId);
+    if (!tool) {
+      log << "Error: Tool " << options.toolId << " not found in registry"
+          << std::endl;
+      return kExitInputError;
+    }
+  } else if (options.cutoutMode != CutoutMode::PERIMETER) {
+    log << "Error: --mode requires a tool (--tool <id>)" << std::endl;
+    return kExitUsage;
+  }
+  if (options.restToolId != 0 && !registry.getTool(options.restToolId)) {
+    log << "Error: Tool " << options.restToolId << " not found in registry"
+        << std::endl;
+    return kExitInputError;
+  }
+
+  // Parse and discretize
+  SVGParser parser;
+  if (!parser.loadFromFile(options.inputFile, "mm", options.dpi)) {
+    log << "Error: Failed to load SVG file: " << options.inputFile
+        << std::endl;
+    return kExitInputError;
+  }
+
+  Discretizer discretizer;
+  discretizer.setConfig(options.discretizer);
+  PathSet paths;
+  discretizer.discretizeImage(parser.getRawImage(), paths);
+  if (paths.empty()) {
+    log << "Error: No paths found in " << options.inputFile << std::endl;
+    return kExitInputError;
+  }
+
+  // Fit to material
+  TransformInfo transformInfo;
+  if (!Transform::fitToMaterial(paths, config, options.preserveAspectRatio,
+                                options.center, options.center, options.flipY,
+                                &transformInfo)) {
+    log << "Error: Failed to fit paths to material: " << transformInfo.message
+        << std::endl;
+    return kExitGenerationError;
+  }
+  if (!options.quiet && !transformInfo.message.empty()) {
+    log << transformInfo.message << std::endl;
+  }
+
+  // Generate G-code
+  GCodeOptions gcodeOptions;
+  gcodeOptions.includeComments = options.includeComments;
+  gcodeOptions.linearizePaths = options.linearizePaths;
+  gcodeOptions.maxSegmentLength = options.discretizer.maxPointDistance;
+  gcodeOptions.selectedToolId = tool ? tool->id : 0;
+  gcodeOptions.restToolId = options.restToolId;
+  gcodeOptions.enableToolOffsets = tool && options.enableToolOffsets;
+  gcodeOptions.validateFeatureSizes = tool != nullptr;
+  gcodeOptions.offsetDirection = options.offsetDirection;
+  gcodeOptions.batchToolOffsets = options.batchToolOffsets;
+  gcodeOptions.cutoutMode = options.cutoutMode;
+  gcodeOptions.stepover = options.stepover;
+  gcodeOptions.maxStepover = options.maxStepover;
+  gcodeOptions.spiralIn = options.spiralIn;
+  gcodeOptions.optimizePaths = options.optimizePaths;
+  gcodeOptions.threadCount = options.discretizer.threadCount;
+
+  GCodeGenerator generator;
+  generator.setConfig(config);
+  generator.setToolRegistry(registry);
+  generator.setOptions(gcodeOptions);
+
+  bool written = false;
+  if (options.outputFile.empty()) {
+    written = generator.generateGCode(paths, gcodeOut);
+    gcodeOut.flush();
+  } else {
+    written = generator.generateGCode(paths, options.outputFile);
+  }
+
+  if (!written) {
+    log << "Error: Failed to write G-code" << std::endl;
+    return kExitGenerationError;
+  }
+
+  if (!options.quiet) {
+    log << "Converted " << options.inputFile << ": " << paths.size()
+        << " paths" << std::endl;
+  }
+  return kExitSuccess;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  CliOptions options;
+  bool showHelp = false;
+  if (!parseArguments(argc, argv, options, showHelp)) {
+    printUsage(argv[0]);
+    return kExitUsage;
+  }
+  if (showHelp) {
+    printUsage(argv[0]);
+    return kExitSuccess;
+  }
+
+  // G-code goes to stdout; the core library logs to stderr. Debug messages
+  // are only available in builds that keep them (Debug builds or
+  // NWSS_CNC_DEBUG_LOGGING).
+  if (options.verbose) {
+    Log::setLevel(LogLevel::DEBUG);
+  } else if (options.quiet) {
+    Log::setLevel(LogLevel::WARN);
+  }
+
+  PipelineProfiler profiler;
+  if (options.stats) {
+    profiler.start();
+  }
+
+  int status = run(options, std::cout);
+
+  if (options.stats) {
+    profiler.stop();
+    std::cerr << profiler.stats().summary();
+  }
+  return status;
+}
@@ -30,10 +30,13 @@ AreaCutterResult AreaCutter::generateAreaCuts(const std::vector<Path> &paths,
   // Convert CAM result to AreaCutter result
   result.success = camResult.success;
   result.toolpaths = camResult.toolpaths;
+  result.toolpathToolIds = camResult.toolpathToolIds;
   result.warnings = camResult.warnings;
   result.errors = camResult.errors;
   result.estimatedTime = camResult.estimatedMachiningTime;
   result.totalDistance = camResult.totalCuttingDistance;
+  result.rapidDistance = camResult.totalRapidDistance;
+  result.rapidDistanceSaved = camResult.rapidDistanceSaved;
 
   return result;
 }
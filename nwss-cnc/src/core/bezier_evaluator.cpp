@@ -0,0 +1,137 @@
+#include "core/bezier_evaluator.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NWSS_CNC_BEZIER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NWSS_CNC_BEZIER_SSE2
+#endif
+
+namespace nwss {
+namespace cnc {
+
+// The vector paths store x/y pairs straight into Point2D arrays
+static_assert(sizeof(Point2D) == 2 * sizeof(double),
+              "Point2D must be two packed doubles");
+
+namespace {
+
+#if defined(NWSS_CNC_BEZIER_AVX2)
+
+// Store four points given as separate x and y vectors
+inline void storePoints(Point2D *out, __m256d x, __m256d y) {
+  __m256d lo = _mm256_unpacklo_pd(x, y);  // x0 y0 x2 y2
+  __m256d hi = _mm256_unpackhi_pd(x, y);  // x1 y1 x3 y3
+  double *dst = reinterpret_cast<double *>(out);
+  _mm256_storeu_pd(dst, _mm256_permute2f128_pd(lo, hi, 0x20));
+  _mm256_storeu_pd(dst + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+}
+
+#elif defined(NWSS_CNC_BEZIER_SSE2)
+
+// Store two points given as separate x and y vectors
+inline void storePoints(Point2D *out, __m128d x, __m128d y) {
+  double *dst = reinterpret_cast<double *>(out);
+  _mm_storeu_pd(dst, _mm_unpacklo_pd(x, y));
+  _mm_storeu_pd(dst + 2, _mm_unpackhi_pd(x, y));
+}
+
+#endif
+
+}  // namespace
+
+BezierBatchEvaluator::BezierBatchEvaluator(int samples)
+    : m_samples(samples > 0 ? samples : 0) {
+  m_b0.resize(m_samples);
+  m_b1.resize(m_samples);
+  m_b2.resize(m_samples);
+  m_b3.resize(m_samples);
+
+  // Same expressions (and evaluation order) as Discretizer::evaluateBezier
+  for (int j = 1; j <= m_samples; j++) {
+    float t = (float)j / m_samples;
+    float u = 1.0f - t;
+    float tt = t * t;
+    float uu = u * u;
+    m_b0[j - 1] = uu * u;
+    m_b1[j - 1] = 3 * uu * t;
+    m_b2[j - 1] = 3 * u * tt;
+    m_b3[j - 1] = tt * t;
+  }
+}
+
+void BezierBatchEvaluator::evaluate(const float *p, Point2D *out) const {
+  const size_t count = static_cast<size_t>(m_samples);
+  const float *b0 = m_b0.data();
+  const float *b1 = m_b1.data();
+  const float *b2 = m_b2.data();
+  const float *b3 = m_b3.data();
+  size_t i = 0;
+
+#if defined(NWSS_CNC_BEZIER_AVX2)
+  const __m256 x0 = _mm256_set1_ps(p[0]), y0 = _mm256_set1_ps(p[1]);
+  const __m256 x1 = _mm256_set1_ps(p[2]), y1 = _mm256_set1_ps(p[3]);
+  const __m256 x2 = _mm256_set1_ps(p[4]), y2 = _mm256_set1_ps(p[5]);
+  const __m256 x3 = _mm256_set1_ps(p[6]), y3 = _mm256_set1_ps(p[7]);
+  for (; i + 8 <= count; i += 8) {
+    __m256 w0 = _mm256_loadu_ps(b0 + i);
+    __m256 w1 = _mm256_loadu_ps(b1 + i);
+    __m256 w2 = _mm256_loadu_ps(b2 + i);
+    __m256 w3 = _mm256_loadu_ps(b3 + i);
+
+    __m256 x = _mm256_mul_ps(w0, x0);
+    x = _mm256_add_ps(x, _mm256_mul_ps(w1, x1));
+    x = _mm256_add_ps(x, _mm256_mul_ps(w2, x2));
+    x = _mm256_add_ps(x, _mm256_mul_ps(w3, x3));
+    __m256 y = _mm256_mul_ps(w0, y0);
+    y = _mm256_add_ps(y, _mm256_mul_ps(w1, y1));
+    y = _mm256_add_ps(y, _mm256_mul_ps(w2, y2));
+    y = _mm256_add_ps(y, _mm256_mul_ps(w3, y3));
+
+    storePoints(out + i, _mm256_cvtps_pd(_mm256_castps256_ps128(x)),
+                _mm256_cvtps_pd(_mm256_castps256_ps128(y)));
+    storePoints(out + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)),
+                _mm256_cvtps_pd(_mm256_extractf128_ps(y, 1)));
+  }
+#elif defined(NWSS_CNC_BEZIER_SSE2)
+  const __m128 x0 = _mm_set1_ps(p[0]), y0 = _mm_set1_ps(p[1]);
+  const __m128 x1 = _mm_set1_ps(p[2]), y1 = _mm_set1_ps(p[3]);
+  const __m128 x2 = _mm_set1_ps(p[4]), y2 = _mm_set1_ps(p[5]);
+  const __m128 x3 = _mm_set1_ps(p[6]), y3 = _mm_set1_ps(p[7]);
+  for (; i + 4 <= count; i += 4) {
+    __m128 w0 = _mm_loadu_ps(b0 + i);
+    __m128 w1 = _mm_loadu_ps(b1 + i);
+    __m128 w2 = _mm_loadu_ps(b2 + i);
+    __m128 w3 = _mm_loadu_ps(b3 + i);
+
+    __m128 x = _mm_mul_ps(w0, x0);
+    x = _mm_add_ps(x, _mm_mul_ps(w1, x1));
+    x = _mm_add_ps(x, _mm_mul_ps(w2, x2));
+    x = _mm_add_ps(x, _mm_mul_ps(w3, x3));
+    __m128 y = _mm_mul_ps(w0, y0);
+    y = _mm_add_ps(y, _mm_mul_ps(w1, y1));
+    y = _mm_add_ps(y, _mm_mul_ps(w2, y2));
+    y = _mm_add_ps(y, _mm_mul_ps(w3, y3));
+
+    storePoints(out + i, _mm_cvtps_pd(x), _mm_cvtps_pd(y));
+    storePoints(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)),
+                _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+  }
+#endif
+
+  // Remaining samples (all of them without SIMD support)
+  for (; i < count; i++) {
+    float x = b0[i] * p[0] + b1[i] * p[2] + b2[i] * p[4] + b3[i] * p[6];
+    float y = b0[i] * p[1] + b1[i] * p[3] + b2[i] * p[5] + b3[i] * p[7];
+    out[i] = Point2D(x, y);
+  }
+}
+
+void BezierBatchEvaluator::append(const float *p, Path &path) const {
+  evaluate(p, path.appendPoints(static_cast<size_t>(m_samples)));
+}
+
+}  // namespace cnc
+}  // namespace nwss
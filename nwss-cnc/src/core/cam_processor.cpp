@@ -4,11 +4,573 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
-#include <iostream>
+
+#include "core/box_grid.h"
+#include "core/fixed_point.h"
+#include "core/log.h"
+#include "core/medial_axis.h"
+#include "core/metrics.h"
+#include "core/offset_engine.h"
+#include "core/scanline_fill.h"
+#include "core/segment_grid.h"
+#include "core/segment_intersector.h"
+#include "core/thread_pool.h"
 
 namespace nwss {
 namespace cnc {
 
+namespace {
+
+// Get the index of the vertex of a path nearest to a point
+size_t nearestVertex(const Clipper2Lib::Path64 &path,
+                     const Clipper2Lib::Point64 &point) {
+  size_t nearest = 0;
+  double nearestDistance = 0.0;
+  for (size_t i = 0; i < path.size(); ++i) {
+    double dx = static_cast<double>(path[i].x - point.x);
+    double dy = static_cast<double>(path[i].y - point.y);
+    double distance = dx * dx + dy * dy;
+    if (i == 0 || distance < nearestDistance) {
+      nearest = i;
+      nearestDistance = distance;
+    }
+  }
+  return nearest;
+}
+
+// Points closer than this to a line (fixed-point units) count as lying on
+// it, so moves along a boundary rounded to the grid do not cross it
+const double kOnLineTolerance = 2.0;
+
+// Side of the line through o and p that q lies on (0 = on the line)
+int lineSide(const Clipper2Lib::Point64 &o, const Clipper2Lib::Point64 &p,
+             const Clipper2Lib::Point64 &q) {
+  double dx = static_cast<double>(p.x - o.x);
+  double dy = static_cast<double>(p.y - o.y);
+  double cross = dx * static_cast<double>(q.y - o.y) -
+                 dy * static_cast<double>(q.x - o.x);
+  if (std::fabs(cross) <= kOnLineTolerance * std::sqrt(dx * dx + dy * dy)) {
+    return 0;
+  }
+  return cross > 0.0 ? 1 : -1;
+}
+
+// Check if segment (a, b) crosses an edge of a closed path at a point
+// inside both (touching does not count)
+bool crossesPath(const Clipper2Lib::Point64 &a, const Clipper2Lib::Point64 &b,
+                 const Clipper2Lib::Path64 &path) {
+  size_t j = path.size() - 1;
+  for (size_t i = 0; i < path.size(); j = i++) {
+    if (lineSide(path[j], path[i], a) * lineSide(path[j], path[i], b) < 0 &&
+        lineSide(a, b, path[j]) * lineSide(a, b, path[i]) < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Get the area the tool center may cover when clearing an outline minus its
+ * holes: the outline shrunk and the holes grown by the tool radius
+ * @param region Output rings (outlines and holes)
+ * @return false if Clipper2 failed
+ */
+bool toolCenterRegion(const Clipper2Lib::Path64 &outline,
+                      const Clipper2Lib::Paths64 &holes, double toolRadius,
+                      Clipper2Lib::Paths64 &region) {
+  // Offset the outline and its holes as one group, so the outline shrinks
+  // and the holes grow; Clipper2 tells them apart by orientation
+  Clipper2Lib::Paths64 input;
+  input.reserve(holes.size() + 1);
+  input.push_back(outline);
+  bool outlinePositive = Clipper2Lib::IsPositive(outline);
+  for (const auto &hole : holes) {
+    if (hole.size() < 3) {
+      continue;
+    }
+    input.push_back(hole);
+    if (Clipper2Lib::IsPositive(hole) == outlinePositive) {
+      std::reverse(input.back().begin(), input.back().end());
+    }
+  }
+
+  OffsetEngine engine;
+  engine.addPaths(input, true);
+  std::vector<Clipper2Lib::Paths64> insets;
+  std::string error;
+  if (!engine.offset({-toolRadius}, insets, error)) {
+    NWSS_LOG_WARN(error);
+    return false;
+  }
+  region = std::move(insets[0]);
+  return true;
+}
+
+/**
+ * Split rings into connected areas, each an outline followed by the holes
+ * inside it. Outlines are the rings oriented like the largest one; a hole
+ * belongs to the smallest outline around it.
+ */
+std::vector<Clipper2Lib::Paths64> splitRegion(
+    const Clipper2Lib::Paths64 &region) {
+  std::vector<Clipper2Lib::Paths64> areas;
+  const Clipper2Lib::Path64 *largest = nullptr;
+  double largestArea = 0.0;
+  for (const auto &ring : region) {
+    double ringArea = std::fabs(Clipper2Lib::Area(ring));
+    if (ring.size() >= 3 && (!largest || ringArea > largestArea)) {
+      largest = &ring;
+      largestArea = ringArea;
+    }
+  }
+  if (!largest) {
+    return areas;
+  }
+
+  bool outlinePositive = Clipper2Lib::IsPositive(*largest);
+  std::vector<double> outlineAreas;
+  for (const auto &ring : region) {
+    if (ring.size() >= 3 && Clipper2Lib::IsPositive(ring) == outlinePositive) {
+      areas.push_back(Clipper2Lib::Paths64{ring});
+      outlineAreas.push_back(std::fabs(Clipper2Lib::Area(ring)));
+    }
+  }
+  for (const auto &ring : region) {
+    if (ring.size() < 3 || Clipper2Lib::IsPositive(ring) == outlinePositive) {
+      continue;
+    }
+    size_t owner = areas.size();
+    for (size_t i = 0; i < areas.size(); ++i) {
+      if ((owner == areas.size() || outlineAreas[i] < outlineAreas[owner]) &&
+          Clipper2Lib::PointInPolygon(ring[0], areas[i][0]) !=
+              Clipper2Lib::PointInPolygonResult::IsOutside) {
+        owner = i;
+      }
+    }
+    if (owner < areas.size()) {
+      areas[owner].push_back(ring);
+    }
+  }
+  return areas;
+}
+
+// Check if a point lies on an edge of a closed path, within
+// kOnLineTolerance
+bool nearPath(const Clipper2Lib::Point64 &point,
+              const Clipper2Lib::Path64 &path) {
+  size_t j = path.size() - 1;
+  for (size_t i = 0; i < path.size(); j = i++) {
+    if (lineSide(path[j], path[i], point) != 0) {
+      continue;
+    }
+    // On the line; check it is between the end points
+    double dx = static_cast<double>(path[i].x - path[j].x);
+    double dy = static_cast<double>(path[i].y - path[j].y);
+    double t = dx * static_cast<double>(point.x - path[j].x) +
+               dy * static_cast<double>(point.y - path[j].y);
+    if (t >= 0.0 && t <= dx * dx + dy * dy) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Check if a point is inside or on the boundary of an area (even-odd)
+bool insideRegion(const Clipper2Lib::Point64 &point,
+                  const Clipper2Lib::Paths64 &region) {
+  bool inside = false;
+  for (const auto &ring : region) {
+    auto location = Clipper2Lib::PointInPolygon(point, ring);
+    if (location == Clipper2Lib::PointInPolygonResult::IsOn ||
+        nearPath(point, ring)) {
+      return true;
+    }
+    if (location == Clipper2Lib::PointInPolygonResult::IsInside) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+// Check if a straight move between two points stays inside an area
+bool segmentInsideRegion(const Clipper2Lib::Point64 &a,
+                         const Clipper2Lib::Point64 &b,
+                         const Clipper2Lib::Paths64 &region) {
+  for (const auto &ring : region) {
+    if (crossesPath(a, b, ring)) {
+      return false;
+    }
+  }
+  return insideRegion(
+      Clipper2Lib::Point64((a.x + b.x) / 2, (a.y + b.y) / 2), region);
+}
+
+/**
+ * Get the stretches of a ring that do not run along the walls, i.e. the
+ * cutting front of a clearing pass. Each stretch starts and ends at a wall
+ * unless the whole ring is away from the walls, in which case the closed
+ * ring is returned.
+ * @param walls Index of the walls, in mm
+ * @param tolerance Distance (mm) within which a point counts as on a wall
+ */
+void frontierRuns(const Clipper2Lib::Path64 &ring, const SegmentGrid &walls,
+                  double tolerance, std::vector<Clipper2Lib::Path64> &runs) {
+  const size_t n = ring.size();
+  if (n < 2) {
+    return;
+  }
+
+  const double factor = 1.0 / FixedPoint::kDefaultScale;
+  auto onWall = [&](double x, double y) {
+    SegmentGrid::Match match;
+    return walls.findNearest(Point2D(x * factor, y * factor), tolerance,
+                             match);
+  };
+  std::vector<bool> vertexOnWall(n);
+  for (size_t i = 0; i < n; ++i) {
+    vertexOnWall[i] = onWall(static_cast<double>(ring[i].x),
+                             static_cast<double>(ring[i].y));
+  }
+
+  // Edge i runs from vertex i to vertex i + 1
+  std::vector<bool> edgeOnWall(n);
+  size_t firstWallEdge = n;
+  for (size_t i = 0; i < n; ++i) {
+    size_t j = (i + 1) % n;
+    edgeOnWall[i] =
+        vertexOnWall[i] && vertexOnWall[j] &&
+        onWall((static_cast<double>(ring[i].x) + ring[j].x) / 2.0,
+               (static_cast<double>(ring[i].y) + ring[j].y) / 2.0);
+    if (edgeOnWall[i] && firstWallEdge == n) {
+      firstWallEdge = i;
+    }
+  }
+
+  if (firstWallEdge == n) {
+    runs.push_back(ring);
+    runs.back().push_back(ring[0]);
+    return;
+  }
+
+  // Walk once around, starting after a wall edge
+  Clipper2Lib::Path64 run;
+  for (size_t k = 1; k <= n; ++k) {
+    size_t i = (firstWallEdge + k) % n;
+    if (edgeOnWall[i]) {
+      if (!run.empty()) {
+        runs.push_back(std::move(run));
+        run.clear();
+      }
+      continue;
+    }
+    if (run.empty()) {
+      run.push_back(ring[i]);
+    }
+    run.push_back(ring[(i + 1) % n]);
+  }
+  if (!run.empty()) {
+    runs.push_back(std::move(run));
+  }
+}
+
+// Get the holes directly inside a hierarchy node
+Clipper2Lib::Paths64 holePaths(const PolygonHierarchy &node) {
+  Clipper2Lib::Paths64 holes;
+  for (const auto &child : node.children) {
+    if (child->isHole && !child->fixedPath.empty()) {
+      holes.push_back(child->fixedPath);
+    }
+  }
+  return holes;
+}
+
+// Material the larger tool leaves along a wall thinner than this (mm) is
+// offset rounding, not rest material
+const double kRestTolerance = 0.01;
+
+/**
+ * Get the areas a rest tool has to clear after a larger tool cleared an
+ * outline minus its holes: the material the larger tool cannot reach, grown
+ * by the rest tool's diameter so that its passes run into the cleared area
+ * and leave no ridge, kept inside the outline
+ * @return Connected areas, each an outline followed by the holes inside it
+ */
+std::vector<Clipper2Lib::Paths64> restAreas(
+    const Clipper2Lib::Path64 &outline, const Clipper2Lib::Paths64 &holes,
+    double toolRadius, double restToolDiameter) {
+  Clipper2Lib::Paths64 region{outline};
+  region.insert(region.end(), holes.begin(), holes.end());
+  PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+  region = Clipper2Lib::Union(region, Clipper2Lib::FillRule::EvenOdd);
+
+  // Everything the larger tool's edge can reach from its centre region
+  Clipper2Lib::Paths64 rest = region;
+  Clipper2Lib::Paths64 centers;
+  std::string error;
+  if (toolCenterRegion(outline, holes, toolRadius, centers) &&
+      !centers.empty()) {
+    OffsetEngine reachEngine;
+    reachEngine.addPaths(centers, true);
+    std::vector<Clipper2Lib::Paths64> reached;
+    if (!reachEngine.offset({toolRadius + kRestTolerance}, reached, error)) {
+      NWSS_LOG_WARN(error);
+      return {};
+    }
+    PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+    rest = Clipper2Lib::Difference(region, reached[0],
+                                   Clipper2Lib::FillRule::NonZero);
+  }
+
+  // Drop specks smaller than a strip of the rest tool's width
+  double minArea = restToolDiameter * kRestTolerance;
+  Clipper2Lib::Paths64 pieces;
+  for (const auto &piece : splitRegion(rest)) {
+    if (FixedPoint::area(piece[0]) > minArea) {
+      pieces.insert(pieces.end(), piece.begin(), piece.end());
+    }
+  }
+  if (pieces.empty()) {
+    return {};
+  }
+
+  OffsetEngine growEngine;
+  growEngine.addPaths(pieces, true);
+  std::vector<Clipper2Lib::Paths64> grown;
+  if (!growEngine.offset({restToolDiameter}, grown, error)) {
+    NWSS_LOG_WARN(error);
+    return {};
+  }
+  PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+  return splitRegion(Clipper2Lib::Intersect(grown[0], region,
+                                            Clipper2Lib::FillRule::NonZero));
+}
+
+// Below this many features the thread hand-off costs more than it saves
+const size_t kMinParallelFeatures = 4;
+
+// Run task(i) for every feature, on the shared pool when there are enough
+void forEachFeature(size_t featureCount, int threadCount,
+                    const std::function<void(size_t)> &task) {
+  size_t threads = ThreadPool::resolveThreadCount(threadCount);
+  if (threads > 1 && featureCount >= kMinParallelFeatures) {
+    ThreadPool::shared().parallelFor(featureCount, threads, task);
+  } else {
+    for (size_t i = 0; i < featureCount; ++i) {
+      task(i);
+    }
+  }
+}
+
+// Append the toolpaths and messages of every feature, in feature order
+void mergeFeatureResults(const std::vector<CAMOperationResult> &features,
+                         CAMOperationResult &result) {
+  for (const auto &feature : features) {
+    result.toolpaths.insert(result.toolpaths.end(), feature.toolpaths.begin(),
+                            feature.toolpaths.end());
+    result.warnings.insert(result.warnings.end(), feature.warnings.begin(),
+                           feature.warnings.end());
+    result.errors.insert(result.errors.end(), feature.errors.begin(),
+                         feature.errors.end());
+  }
+}
+
+// Largest distance between V-carve wall samples (mm)
+const double kVCarveSampleSpacing = 0.1;
+
+// Depth profile of a V-bit
+struct VCarveBit {
+  double tipRadius;
+  double slope;      // Flank distance from the axis per mm of depth
+  double maxRadius;  // Half width carved at the deepest cut
+};
+
+// Add the bit position for a disc. Discs wider than the deepest cut are
+// carved at that depth, with the bit moved towards their wall so the flank
+// still meets it.
+void addVCarvePoint(const Point2D &center, const Point2D &boundary,
+                    double radius, const VCarveBit &bit, Path &path) {
+  Point2D position = center;
+  if (radius > bit.maxRadius) {
+    position = boundary + (center - boundary) * (bit.maxRadius / radius);
+    radius = bit.maxRadius;
+  }
+  path.addPoint(position,
+                std::max(0.0, (radius - bit.tipRadius) / bit.slope));
+}
+
+// Add the bit position for the next disc of a ring. Samples further apart
+// than the sample spacing had the discs between them left out, which lie
+// on the straight bisector of two walls; such a step gets a point where
+// the depth stops following the width (at the tip and the deepest cut), so
+// the bit does not cut across the corner the clamped discs turn.
+void addVCarveStep(const MedialBall &from, const MedialBall &to,
+                   const VCarveBit &bit, Path &path) {
+  double change = to.radius - from.radius;
+  if (from.boundary.distanceTo(to.boundary) > 1.5 * kVCarveSampleSpacing &&
+      change != 0.0) {
+    double limits[2] = {bit.tipRadius, bit.maxRadius};
+    if (change < 0.0) {
+      std::swap(limits[0], limits[1]);
+    }
+    for (double limit : limits) {
+      double t = (limit - from.radius) / change;
+      if (t > 0.0 && t < 1.0) {
+        addVCarvePoint(from.center + (to.center - from.center) * t,
+                       from.boundary + (to.boundary - from.boundary) * t,
+                       limit, bit, path);
+      }
+    }
+  }
+  addVCarvePoint(to.center, to.boundary, to.radius, bit, path);
+}
+
+// Depth profile of a V-bit cutting at most maxDepth deep
+VCarveBit vcarveBit(double tipDiameter, double tipAngle, double maxDepth) {
+  // The flanks of the bit are this far from its axis per mm of depth; a disc
+  // is carved by the depth at which the bit is as wide as the disc
+  VCarveBit bit;
+  bit.slope = std::tan(tipAngle * M_PI / 360.0);
+  bit.tipRadius = tipDiameter / 2.0;
+  bit.maxRadius = bit.tipRadius + std::max(0.0, maxDepth) * bit.slope;
+  return bit;
+}
+
+// Carving distance that takes as long as lifting to the safe height and
+// plunging back to maxDepth (mm)
+double vcarveLiftLength(const CNConfig &config, double maxDepth) {
+  double feedRate = config.getFeedRate() > 0 ? config.getFeedRate() : 1000.0;
+  double plungeRate =
+      config.getPlungeRate() > 0 ? config.getPlungeRate() : feedRate;
+  return (std::max(0.0, config.getSafeHeight()) + std::max(0.0, maxDepth)) *
+         feedRate / plungeRate;
+}
+
+/**
+ * Add the V-carve toolpaths of some rings of a medial axis. A disc that
+ * touches the inside of a wall edge is also the disc of the samples on that
+ * edge where it touches, so each stretch of axis between two walls is found
+ * from both walls. Discs wider than the deepest cut are carved beside each
+ * wall, so both keep them; other duplicates are left to the other wall (the
+ * lower (ring, edge)). A ring's longest stretch of duplicates is always
+ * left out, as that only opens the ring; any other stretch is carved again
+ * when that is quicker than lifting over it (liftLength along the axis).
+ * Rings carved whole are loops starting at a convex corner; the rest are
+ * open toolpaths over the discs they keep, joined to the discs on either
+ * side and starting at their shallower end.
+ */
+void addVCarvePaths(const MedialAxis &axis, size_t firstRing, size_t endRing,
+                    const VCarveBit &bit, double liftLength,
+                    std::vector<Path> &paths) {
+  for (size_t ring = firstRing; ring < endRing; ++ring) {
+    const auto &balls = axis.balls(ring);
+    size_t count = balls.size();
+    if (count == 0) {
+      continue;
+    }
+
+    std::vector<char> keep(count);
+    size_t keptCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+      keep[i] = !balls[i].duplicate || balls[i].radius > bit.maxRadius;
+      keptCount += keep[i];
+    }
+    if (keptCount == 0) {
+      continue;
+    }
+
+    // Axis length of a stretch of duplicates from the kept disc before it
+    // to the one after it
+    auto stretchAlong = [&](size_t begin, size_t &length) {
+      double along = 0.0;
+      for (length = 0; !keep[(begin + length) % count]; ++length) {
+        along += balls[(begin + length + count - 1) % count].center.distanceTo(
+            balls[(begin + length) % count].center);
+      }
+      return along +
+             balls[(begin + length + count - 1) % count].center.distanceTo(
+                 balls[(begin + length) % count].center);
+    };
+    auto startsStretch = [&](size_t i) {
+      return !keep[i] && keep[(i + count - 1) % count];
+    };
+
+    // Leaving out one stretch only opens the ring, so the longest always
+    // goes; every other one costs a lift, so short ones are carved again
+    size_t dropped = count;
+    double droppedAlong = 0.0;
+    size_t length = 0;
+    for (size_t begin = 0; begin < count; ++begin) {
+      if (startsStretch(begin)) {
+        double along = stretchAlong(begin, length);
+        if (dropped == count || along > droppedAlong) {
+          dropped = begin;
+          droppedAlong = along;
+        }
+      }
+    }
+    for (size_t begin = 0; begin < count; ++begin) {
+      if (begin != dropped && startsStretch(begin) &&
+          stretchAlong(begin, length) <= liftLength) {
+        for (size_t j = 0; j < length; ++j) {
+          keep[(begin + j) % count] = 1;
+        }
+      }
+    }
+
+    if (dropped == count) {
+      // Start at a convex corner, where the bit meets the surface
+      size_t start = 0;
+      for (size_t i = 0; i < count; ++i) {
+        if (balls[i].radius == 0.0) {
+          start = i;
+          break;
+        }
+      }
+      Path path;
+      path.reserve(count + 1);
+      const MedialBall &first = balls[start];
+      addVCarvePoint(first.center, first.boundary, first.radius, bit, path);
+      for (size_t k = 1; k <= count; ++k) {
+        addVCarveStep(balls[(start + k - 1) % count],
+                      balls[(start + k) % count], bit, path);
+      }
+      paths.push_back(std::move(path));
+      continue;
+    }
+
+    // Runs of kept discs, going round from a dropped one
+    for (size_t k = 1; k <= count; ++k) {
+      size_t begin = (dropped + k) % count;
+      if (!keep[begin] || keep[(begin + count - 1) % count]) {
+        continue;
+      }
+      size_t length = 0;
+      while (keep[(begin + length) % count]) {
+        ++length;
+      }
+
+      std::vector<size_t> order;
+      order.reserve(length + 2);
+      for (size_t j = 0; j < length + 2; ++j) {
+        order.push_back((begin + count - 1 + j) % count);
+      }
+      if (balls[order.front()].radius > balls[order.back()].radius) {
+        std::reverse(order.begin(), order.end());
+      }
+      Path path;
+      path.reserve(order.size());
+      const MedialBall &first = balls[order[0]];
+      addVCarvePoint(first.center, first.boundary, first.radius, bit, path);
+      for (size_t j = 1; j < order.size(); ++j) {
+        addVCarveStep(balls[order[j - 1]], balls[order[j]], bit, path);
+      }
+      paths.push_back(std::move(path));
+    }
+  }
+}
+
+}  // namespace
+
 CAMProcessor::CAMProcessor() {}
 
 CAMProcessor::~CAMProcessor() {}
@@ -22,64 +584,90 @@ void CAMProcessor::setToolRegistry(const ToolRegistry &registry) {
 CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
                                                const CutoutParams &cutoutParams,
                                                int selectedToolId) {
+  ScopedStageTimer timer("cam");
   CAMOperationResult result;
 
-  std::cout << "DEBUG: CAMProcessor::processForCAM() called with:" << std::endl;
-  std::cout << "  - Input paths: " << paths.size() << std::endl;
-  std::cout << "  - Cutout mode: " << static_cast<int>(cutoutParams.mode)
-            << std::endl;
-  std::cout << "  - Selected tool ID: " << selectedToolId << std::endl;
-  std::cout << "  - Stepover: " << cutoutParams.stepover << std::endl;
+  NWSS_LOG_DEBUG("CAMProcessor::processForCAM() called with:");
+  NWSS_LOG_DEBUG("  - Input paths: " << paths.size());
+  NWSS_LOG_DEBUG("  - Cutout mode: " << static_cast<int>(cutoutParams.mode));
+  NWSS_LOG_DEBUG("  - Selected tool ID: " << selectedToolId);
+  NWSS_LOG_DEBUG("  - Stepover: " << cutoutParams.stepover);
 
   // Get tool information
   const Tool *toolPtr = m_toolRegistry.getTool(selectedToolId);
   if (!toolPtr) {
-    std::cout << "DEBUG: Tool lookup failed for ID: " << selectedToolId
-              << std::endl;
+    NWSS_LOG_DEBUG("Tool lookup failed for ID: " << selectedToolId);
     addError(result, "Invalid tool ID: " + std::to_string(selectedToolId));
     return result;
   }
   Tool tool = *toolPtr;
-  std::cout << "DEBUG: Tool found - diameter: " << tool.diameter
-            << "mm, name: " << tool.name << std::endl;
+  NWSS_LOG_DEBUG("Tool found - diameter: " << tool.diameter << "mm, name: "
+                 << tool.name);
+
+  // Optional smaller tool for the material the selected tool cannot reach.
+  // Callers such as the G-code generator drop CAM warnings, so skipping it
+  // is logged as well
+  const Tool *restTool = nullptr;
+  auto skipRestMachining = [&](const std::string &reason) {
+    NWSS_LOG_WARN("Rest machining skipped: " << reason);
+    addWarning(result, "Rest machining skipped: " + reason);
+    restTool = nullptr;
+  };
+  if (cutoutParams.restToolId != 0) {
+    restTool = m_toolRegistry.getTool(cutoutParams.restToolId);
+    if (!restTool) {
+      skipRestMachining("invalid tool ID " +
+                        std::to_string(cutoutParams.restToolId));
+    } else if (cutoutParams.mode != CutoutMode::POCKET &&
+               cutoutParams.mode != CutoutMode::ADAPTIVE) {
+      skipRestMachining("only pocket and adaptive clearing use a rest tool");
+    } else if (restTool->diameter <= 0.0 ||
+               restTool->diameter >= tool.diameter) {
+      skipRestMachining("the rest tool must be smaller than the selected "
+                        "tool");
+    } else {
+      NWSS_LOG_DEBUG("Rest tool - diameter: " << restTool->diameter
+                     << "mm, name: " << restTool->name);
+    }
+  }
+  // Features only the rest tool fits are still machinable
+  double smallestDiameter = restTool ? restTool->diameter : tool.diameter;
 
   // Convert paths to polygons
   std::vector<Polygon> polygons;
   for (const auto &path : paths) {
-    std::cout << "DEBUG: Processing path with " << path.size() << " points"
-              << std::endl;
+    NWSS_LOG_DEBUG("Processing path with " << path.size() << " points");
     if (path.size() >= 3) {
       Polygon polygon(path.getPoints());
       polygons.push_back(polygon);
-      std::cout << "DEBUG: Added polygon with " << polygon.size() << " points"
-                << std::endl;
+      NWSS_LOG_DEBUG("Added polygon with " << polygon.size() << " points");
     } else {
-      std::cout << "DEBUG: Skipping path with < 3 points" << std::endl;
+      NWSS_LOG_DEBUG("Skipping path with < 3 points");
     }
   }
 
   if (polygons.empty()) {
-    std::cout << "DEBUG: No valid polygons found" << std::endl;
+    NWSS_LOG_DEBUG("No valid polygons found");
     addError(result, "No valid polygons found in input paths");
     return result;
   }
 
-  std::cout << "DEBUG: Created " << polygons.size() << " polygons" << std::endl;
+  NWSS_LOG_DEBUG("Created " << polygons.size() << " polygons");
 
   // Analyze polygon hierarchy using Clipper2
-  std::cout << "DEBUG: Analyzing polygon hierarchy..." << std::endl;
+  NWSS_LOG_DEBUG("Analyzing polygon hierarchy...");
   auto hierarchy = analyzePolygonHierarchy(polygons);
-  std::cout << "DEBUG: Hierarchy analysis complete - " << hierarchy.size()
-            << " root nodes" << std::endl;
+  NWSS_LOG_DEBUG("Hierarchy analysis complete - " << hierarchy.size()
+                 << " root nodes");
 
   // Validate feasibility for each polygon
-  std::cout << "DEBUG: Validating polygon feasibility..." << std::endl;
+  NWSS_LOG_DEBUG("Validating polygon feasibility...");
   int validPolygons = 0;
   int totalPolygons = polygons.size();
 
   for (const auto &poly : polygons) {
     auto validation =
-        validateToolpathFeasibility(poly, tool.diameter, cutoutParams.mode);
+        validateToolpathFeasibility(poly, smallestDiameter, cutoutParams.mode);
     result.warnings.insert(result.warnings.end(), validation.warnings.begin(),
                            validation.warnings.end());
 
@@ -92,19 +680,17 @@ CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
       }
     }
 
-    std::cout << "DEBUG: Polygon validation - success: " << validation.success
-              << ", warnings: " << validation.warnings.size()
-              << ", errors: " << validation.errors.size() << std::endl;
+    NWSS_LOG_DEBUG("Polygon validation - success: " << validation.success
+                   << ", warnings: " << validation.warnings.size()
+                   << ", errors: " << validation.errors.size());
   }
 
-  std::cout << "DEBUG: Validation summary: " << validPolygons << "/"
-            << totalPolygons << " polygons are machinable" << std::endl;
+  NWSS_LOG_DEBUG("Validation summary: " << validPolygons << "/"
+                 << totalPolygons << " polygons are machinable");
 
   // Only fail completely if NO polygons are machinable
   if (validPolygons == 0) {
-    std::cout
-        << "DEBUG: Complete validation failure - no polygons are machinable"
-        << std::endl;
+    NWSS_LOG_DEBUG("Complete validation failure - no polygons are machinable");
     result.errors.push_back(
         "No features in this design can be machined with the selected tool");
     result.success = false;
@@ -119,11 +705,11 @@ CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
   // Generate toolpaths based on cutout mode
   CAMOperationResult toolpathResult;
   double stepover = cutoutParams.stepover * tool.diameter;
-  std::cout << "DEBUG: Calculated stepover: " << stepover << "mm" << std::endl;
+  NWSS_LOG_DEBUG("Calculated stepover: " << stepover << "mm");
 
   switch (cutoutParams.mode) {
     case CutoutMode::PERIMETER:
-      std::cout << "DEBUG: Using PERIMETER mode" << std::endl;
+      NWSS_LOG_DEBUG("Using PERIMETER mode");
       // For perimeter, just use the original paths
       for (const auto &path : paths) {
         result.toolpaths.push_back(path);
@@ -132,30 +718,48 @@ CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
       break;
 
     case CutoutMode::PUNCHOUT:
-      std::cout << "DEBUG: Using PUNCHOUT mode" << std::endl;
-      toolpathResult =
-          generatePunchoutToolpaths(hierarchy, tool.diameter, stepover);
+      NWSS_LOG_DEBUG("Using PUNCHOUT mode");
+      toolpathResult = generatePunchoutToolpaths(
+          hierarchy, tool.diameter, stepover, cutoutParams.threadCount);
       break;
 
     case CutoutMode::POCKET:
-      std::cout << "DEBUG: Using POCKET mode" << std::endl;
-      toolpathResult = generatePocketToolpaths(hierarchy, tool.diameter,
-                                               stepover, cutoutParams.spiralIn);
+      NWSS_LOG_DEBUG("Using POCKET mode");
+      toolpathResult = generatePocketToolpaths(
+          hierarchy, tool.diameter, stepover, cutoutParams.spiralIn,
+          cutoutParams.threadCount, restTool == nullptr);
       break;
 
     case CutoutMode::ENGRAVE:
-      std::cout << "DEBUG: Using ENGRAVE mode" << std::endl;
-      toolpathResult =
-          generateEngraveToolpaths(hierarchy, tool.diameter, stepover);
+      if (tool.type == ToolType::V_BIT) {
+        // V-bits carve down to the configured depth of every pass
+        NWSS_LOG_DEBUG("Using ENGRAVE mode (V-carve)");
+        double maxDepth =
+            std::min(m_config.getCutDepth() * m_config.getPassCount(),
+                     m_config.getMaterialThickness());
+        toolpathResult = generateVCarveToolpaths(hierarchy, tool, maxDepth,
+                                                 cutoutParams.threadCount);
+      } else {
+        NWSS_LOG_DEBUG("Using ENGRAVE mode");
+        toolpathResult = generateEngraveToolpaths(
+            hierarchy, tool.diameter, stepover, cutoutParams.threadCount);
+      }
+      break;
+
+    case CutoutMode::ADAPTIVE:
+      NWSS_LOG_DEBUG("Using ADAPTIVE mode");
+      toolpathResult = generateAdaptiveToolpaths(
+          hierarchy, tool.diameter, stepover, cutoutParams.threadCount,
+          restTool == nullptr);
       break;
   }
 
   if (cutoutParams.mode != CutoutMode::PERIMETER) {
-    std::cout << "DEBUG: Toolpath generation result - success: "
-              << toolpathResult.success
-              << ", paths: " << toolpathResult.toolpaths.size()
-              << ", warnings: " << toolpathResult.warnings.size()
-              << ", errors: " << toolpathResult.errors.size() << std::endl;
+    NWSS_LOG_DEBUG("Toolpath generation result - success: "
+                   << toolpathResult.success << ", paths: "
+                   << toolpathResult.toolpaths.size() << ", warnings: "
+                   << toolpathResult.warnings.size() << ", errors: "
+                   << toolpathResult.errors.size());
 
     result.toolpaths = toolpathResult.toolpaths;
     result.success = toolpathResult.success;
@@ -166,12 +770,56 @@ CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
                          toolpathResult.errors.end());
   }
 
-  // Optimize toolpath order
+  // Clear what the selected tool left with the rest tool
+  std::vector<Path> restPaths;
+  if (restTool && result.success) {
+    NWSS_LOG_DEBUG("Using rest machining");
+    CAMOperationResult restResult = generateRestToolpaths(
+        hierarchy, tool.diameter, restTool->diameter,
+        cutoutParams.stepover * restTool->diameter, cutoutParams.mode,
+        cutoutParams.spiralIn, cutoutParams.threadCount);
+    restPaths = restResult.toolpaths;
+    result.warnings.insert(result.warnings.end(), restResult.warnings.begin(),
+                           restResult.warnings.end());
+    result.errors.insert(result.errors.end(), restResult.errors.begin(),
+                         restResult.errors.end());
+  }
+
+  // The rest tool's toolpaths follow after a tool change
   if (result.success && !result.toolpaths.empty()) {
-    std::cout << "DEBUG: Optimizing toolpath order..." << std::endl;
-    result.toolpaths = optimizeToolpathOrder(result.toolpaths);
     result.toolpaths = removeRedundantMoves(result.toolpaths);
+  }
+  if (!restPaths.empty()) {
+    restPaths = removeRedundantMoves(restPaths);
+    result.toolpathToolIds.assign(result.toolpaths.size(), tool.id);
+    result.toolpathToolIds.resize(result.toolpaths.size() + restPaths.size(),
+                                  restTool->id);
+    result.toolpaths.insert(result.toolpaths.end(), restPaths.begin(),
+                            restPaths.end());
+  }
+
+  // Optimize toolpath order, each tool's toolpaths on their own. Profiles
+  // cut holes before the outlines around them; nested pocket rings keep
+  // their spiral direction. Adaptive passes keep their order: each one
+  // relies on the ones before it having cleared its way in.
+  if (result.success && !result.toolpaths.empty()) {
+    if (cutoutParams.mode == CutoutMode::ADAPTIVE) {
+      result.totalRapidDistance =
+          ToolpathOptimizer::rapidDistance(result.toolpaths);
+    } else {
+      NWSS_LOG_DEBUG("Optimizing toolpath order...");
+      bool profile = cutoutParams.mode == CutoutMode::PERIMETER ||
+                     cutoutParams.mode == CutoutMode::PUNCHOUT;
+      ToolpathOrderReport order = optimizeToolpathOrder(
+          result.toolpaths, result.toolpathToolIds,
+          profile ? ToolpathOptimizer::Nesting::INNER_FIRST
+                  : ToolpathOptimizer::Nesting::KEEP);
+      result.totalRapidDistance = order.rapidAfter;
+      result.rapidDistanceSaved = order.saved();
+    }
+  }
 
+  if (result.success && !result.toolpaths.empty()) {
     // Calculate statistics
     for (const auto &path : result.toolpaths) {
       result.totalCuttingDistance += path.length();
@@ -184,12 +832,11 @@ CAMOperationResult CAMProcessor::processForCAM(const std::vector<Path> &paths,
         result.totalCuttingDistance / feedRate;  // minutes
   }
 
-  std::cout << "DEBUG: CAMProcessor::processForCAM() complete - final result:"
-            << std::endl;
-  std::cout << "  - Success: " << result.success << std::endl;
-  std::cout << "  - Toolpaths: " << result.toolpaths.size() << std::endl;
-  std::cout << "  - Warnings: " << result.warnings.size() << std::endl;
-  std::cout << "  - Errors: " << result.errors.size() << std::endl;
+  NWSS_LOG_DEBUG("CAMProcessor::processForCAM() complete - final result:");
+  NWSS_LOG_DEBUG("  - Success: " << result.success);
+  NWSS_LOG_DEBUG("  - Toolpaths: " << result.toolpaths.size());
+  NWSS_LOG_DEBUG("  - Warnings: " << result.warnings.size());
+  NWSS_LOG_DEBUG("  - Errors: " << result.errors.size());
 
   return result;
 }
@@ -198,8 +845,8 @@ std::vector<std::shared_ptr<PolygonHierarchy>>
 CAMProcessor::analyzePolygonHierarchy(const std::vector<Polygon> &polygons) {
   std::vector<std::shared_ptr<PolygonHierarchy>> hierarchy;
 
-  std::cout << "DEBUG: analyzePolygonHierarchy() called with "
-            << polygons.size() << " polygons" << std::endl;
+  NWSS_LOG_DEBUG("analyzePolygonHierarchy() called with " << polygons.size()
+                 << " polygons");
 
   // For text and complex designs, we need to analyze containment relationships
   // manually because Clipper2 Union operations merge everything into one shape
@@ -209,25 +856,45 @@ CAMProcessor::analyzePolygonHierarchy(const std::vector<Polygon> &polygons) {
   for (size_t i = 0; i < polygons.size(); i++) {
     auto node = std::make_shared<PolygonHierarchy>();
     node->polygon = polygons[i];
+    node->fixedPath = FixedPoint::toPath64(polygons[i]);
     node->level = 0;       // Will be updated based on containment
     node->isHole = false;  // Will be updated based on containment
     allNodes.push_back(node);
 
-    std::cout << "DEBUG: Created node " << i << " with area "
-              << polygons[i].area() << "mm²" << std::endl;
+    NWSS_LOG_DEBUG("Created node " << i << " with area "
+                   << node->polygon.area() << "mm²");
+  }
+
+  // Index the bounding boxes so each polygon is only tested against the
+  // polygons whose box covers its own
+  std::vector<size_t> boxedNodes;
+  std::vector<Clipper2Lib::Rect64> boxes;
+  std::vector<Clipper2Lib::Rect64> nodeBoxes(allNodes.size());
+  for (size_t i = 0; i < allNodes.size(); i++) {
+    if (!allNodes[i]->fixedPath.empty()) {
+      nodeBoxes[i] = Clipper2Lib::GetBounds(allNodes[i]->fixedPath);
+      boxedNodes.push_back(i);
+      boxes.push_back(nodeBoxes[i]);
+    }
   }
+  BoxGrid boxGrid(boxes);
 
   // Analyze containment relationships using point-in-polygon tests
   for (size_t i = 0; i < allNodes.size(); i++) {
     int containmentLevel = 0;
     std::shared_ptr<PolygonHierarchy> directParent = nullptr;
 
-    // Test if this polygon is contained within any other polygon
-    for (size_t j = 0; j < allNodes.size(); j++) {
-      if (i == j) continue;
+    // Test if this polygon is contained within any candidate polygon
+    const std::vector<size_t> *candidates = nullptr;
+    if (!allNodes[i]->fixedPath.empty()) {
+      candidates = &boxGrid.candidates(allNodes[i]->fixedPath[0]);
+    }
+    for (size_t k = 0; candidates && k < candidates->size(); k++) {
+      size_t j = boxedNodes[(*candidates)[k]];
+      if (i == j || !BoxGrid::covers(nodeBoxes[j], nodeBoxes[i])) continue;
 
       // Check if polygon i is inside polygon j
-      if (isPolygonInsidePolygon(allNodes[i]->polygon, allNodes[j]->polygon)) {
+      if (isPolygonInsidePolygon(*allNodes[i], *allNodes[j])) {
         containmentLevel++;
 
         // Find the most direct parent (smallest containing polygon)
@@ -244,160 +911,167 @@ CAMProcessor::analyzePolygonHierarchy(const std::vector<Polygon> &polygons) {
 
     if (directParent) {
       directParent->children.push_back(allNodes[i]);
-      std::cout << "DEBUG: Node " << i << " (level " << containmentLevel << ", "
-                << (allNodes[i]->isHole ? "HOLE" : "SOLID")
-                << ") is child of another polygon" << std::endl;
+      NWSS_LOG_DEBUG("Node " << i << " (level " << containmentLevel << ", "
+                     << (allNodes[i]->isHole ? "HOLE" : "SOLID")
+                     << ") is child of another polygon");
     } else {
       hierarchy.push_back(allNodes[i]);
-      std::cout << "DEBUG: Node " << i << " (level " << containmentLevel << ", "
-                << (allNodes[i]->isHole ? "HOLE" : "SOLID")
-                << ") is root polygon" << std::endl;
+      NWSS_LOG_DEBUG("Node " << i << " (level " << containmentLevel << ", "
+                     << (allNodes[i]->isHole ? "HOLE" : "SOLID")
+                     << ") is root polygon");
     }
   }
 
-  std::cout << "DEBUG: Hierarchy analysis complete - " << hierarchy.size()
-            << " root nodes, " << allNodes.size() << " total nodes"
-            << std::endl;
+  NWSS_LOG_DEBUG("Hierarchy analysis complete - " << hierarchy.size()
+                 << " root nodes, " << allNodes.size() << " total nodes");
 
   return hierarchy;
 }
 
 CAMOperationResult CAMProcessor::generatePunchoutToolpaths(
     const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-    double toolDiameter, double stepover) {
+    double toolDiameter, double stepover, int threadCount) {
   // PUNCHOUT MODE: Only removes material from the INNERMOST enclosed shapes
   // For text: punches out letter interiors (like "A", "a", "o") but preserves
   // letter outlines For complex designs: only punches out the deepest
   // holes/cavities
   CAMOperationResult result;
 
-  std::cout << "DEBUG: generatePunchoutToolpaths() called with:" << std::endl;
-  std::cout << "  - Hierarchy nodes: " << hierarchy.size() << std::endl;
-  std::cout << "  - Tool diameter: " << toolDiameter << "mm" << std::endl;
-  std::cout << "  - Stepover: " << stepover << "mm" << std::endl;
+  NWSS_LOG_DEBUG("generatePunchoutToolpaths() called with:");
+  NWSS_LOG_DEBUG("  - Hierarchy nodes: " << hierarchy.size());
+  NWSS_LOG_DEBUG("  - Tool diameter: " << toolDiameter << "mm");
+  NWSS_LOG_DEBUG("  - Stepover: " << stepover << "mm");
 
   // NEW STRATEGY: Only punch out innermost holes (deepest level holes with no
   // children) This preserves the overall shape while removing only the enclosed
   // cavities
 
-  int processedFeatures = 0;
-  int skippedFeatures = 0;
-
-  // Recursive function to find and process only the deepest holes
+  // Recursive function to find the deepest holes, in the order their
+  // toolpaths are emitted
+  std::vector<const PolygonHierarchy *> features;
   std::function<void(const std::shared_ptr<PolygonHierarchy> &)>
-      processHierarchyNode = [&](const std::shared_ptr<PolygonHierarchy>
+      collectHierarchyNode = [&](const std::shared_ptr<PolygonHierarchy>
                                      &node) {
-        std::cout << "DEBUG: Examining level " << node->level << " "
-                  << (node->isHole ? "HOLE" : "SOLID") << " with "
-                  << node->children.size() << " children" << std::endl;
+        NWSS_LOG_DEBUG("Examining level " << node->level << " "
+                       << (node->isHole ? "HOLE" : "SOLID") << " with "
+                       << node->children.size() << " children");
 
         // Process children first (depth-first traversal)
         for (const auto &child : node->children) {
-          processHierarchyNode(child);
+          collectHierarchyNode(child);
         }
 
         // Only process HOLES that have NO CHILDREN (deepest holes)
         // if (node->isHole && node->children.empty()) {
         if (node->children.size() <= 1) {
-          std::cout << "DEBUG: Found innermost hole at level " << node->level
-                    << " - this should be punched out" << std::endl;
-
-          // Check if this hole is suitable for machining
-          auto validation = validateToolpathFeasibility(
-              node->polygon, toolDiameter, CutoutMode::PUNCHOUT);
-          if (!validation.success) {
-            std::cout << "DEBUG: Skipping hole - too small or invalid for tool"
-                      << std::endl;
-            skippedFeatures++;
-
-            // Add warnings but continue processing other features
-            for (const auto &error : validation.errors) {
-              result.warnings.push_back("Skipped hole: " + error);
-            }
-            return;
-          }
-
-          // Generate spiral to remove all material inside this innermost hole
-          std::cout << "DEBUG: Generating punchout spiral for innermost hole..."
-                    << std::endl;
-          auto punchoutPaths = generateSpiralToolpath(
-              node->polygon, toolDiameter, stepover, true);
-
-          std::cout << "DEBUG: Generated " << punchoutPaths.size()
-                    << " spiral paths for hole" << std::endl;
-
-          for (const auto &path : punchoutPaths) {
-            result.toolpaths.push_back(path);
-            std::cout << "DEBUG: Added punchout spiral path with "
-                      << path.size() << " points" << std::endl;
-          }
-          processedFeatures++;
+          NWSS_LOG_DEBUG("Found innermost hole at level " << node->level
+                         << " - this should be punched out");
+          features.push_back(node.get());
         } else if (node->isHole && !node->children.empty()) {
-          std::cout << "DEBUG: Skipping hole with children - not innermost"
-                    << std::endl;
+          NWSS_LOG_DEBUG("Skipping hole with children - not innermost");
         } else if (!node->isHole) {
-          std::cout << "DEBUG: Skipping solid shape - preserving outline"
-                    << std::endl;
+          NWSS_LOG_DEBUG("Skipping solid shape - preserving outline");
         }
       };
 
   // Process the hierarchy starting from root nodes
   for (const auto &rootNode : hierarchy) {
-    processHierarchyNode(rootNode);
+    collectHierarchyNode(rootNode);
   }
 
-  std::cout << "DEBUG: Feature processing summary: " << processedFeatures
-            << " innermost holes punched out, " << skippedFeatures << " skipped"
-            << std::endl;
+  // Holes are independent: generate them in parallel, then merge in order
+  std::vector<CAMOperationResult> featureResults(features.size());
+  forEachFeature(features.size(), threadCount, [&](size_t i) {
+    const PolygonHierarchy &node = *features[i];
+    CAMOperationResult &featureResult = featureResults[i];
+
+    // Check if this hole is suitable for machining
+    auto validation = validateToolpathFeasibility(node.polygon, toolDiameter,
+                                                  CutoutMode::PUNCHOUT);
+    if (!validation.success) {
+      NWSS_LOG_DEBUG("Skipping hole - too small or invalid for tool");
+
+      // Add warnings but continue processing other features
+      for (const auto &error : validation.errors) {
+        featureResult.warnings.push_back("Skipped hole: " + error);
+      }
+      return;
+    }
+
+    // Generate spiral to remove all material inside this innermost hole
+    NWSS_LOG_DEBUG("Generating punchout spiral for innermost hole...");
+    featureResult.toolpaths = generateSpiralToolpath(
+        node.fixedPath, toolDiameter, stepover, true);
+    featureResult.success = true;
+
+    NWSS_LOG_DEBUG("Generated " << featureResult.toolpaths.size()
+                   << " spiral paths for hole");
+  });
+
+  int processedFeatures = 0;
+  int skippedFeatures = 0;
+  for (const auto &featureResult : featureResults) {
+    if (featureResult.success) {
+      processedFeatures++;
+    } else {
+      skippedFeatures++;
+    }
+  }
+  mergeFeatureResults(featureResults, result);
+
+  NWSS_LOG_DEBUG("Feature processing summary: " << processedFeatures
+                 << " innermost holes punched out, " << skippedFeatures
+                 << " skipped");
 
   if (processedFeatures == 0) {
     result.warnings.push_back(
         "No innermost holes found to punch out - this "
         "design may not have enclosed cavities");
-    std::cout << "DEBUG: No punchout operations performed - design has no "
-                 "innermost holes"
-              << std::endl;
+    NWSS_LOG_DEBUG(
+        "No punchout operations performed - design has no innermost holes");
   }
 
-  std::cout << "DEBUG: generatePunchoutToolpaths() complete - "
-            << result.toolpaths.size() << " total paths" << std::endl;
-  std::cout << "DEBUG: Punchout will remove material from innermost enclosed "
-               "shapes only"
-            << std::endl;
+  NWSS_LOG_DEBUG("generatePunchoutToolpaths() complete - "
+                 << result.toolpaths.size() << " total paths");
+  NWSS_LOG_DEBUG(
+      "Punchout will remove material from innermost enclosed shapes only");
   result.success = true;
   return result;
 }
 
 CAMOperationResult CAMProcessor::generatePocketToolpaths(
     const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-    double toolDiameter, double stepover, bool spiralIn) {
+    double toolDiameter, double stepover, bool spiralIn, int threadCount,
+    bool skipNarrowFeatures) {
   // POCKET MODE: Creates recessed areas by removing material inside shapes
   // Similar to punchout but typically used for partial depth cuts
   CAMOperationResult result;
 
-  for (const auto &node : hierarchy) {
-    if (node->isHole) {
-      continue;  // Skip holes for pocketing
+  std::vector<CAMOperationResult> featureResults(hierarchy.size());
+  forEachFeature(hierarchy.size(), threadCount, [&](size_t i) {
+    const PolygonHierarchy &node = *hierarchy[i];
+    CAMOperationResult &featureResult = featureResults[i];
+    if (node.isHole) {
+      return;  // Skip holes for pocketing
     }
 
     // Check if polygon is suitable for pocketing
-    if (isPolygonTooSmallForTool(node->polygon, toolDiameter)) {
-      addWarning(result, "Polygon too small for selected tool diameter");
-      continue;
+    if (skipNarrowFeatures &&
+        isPolygonTooSmallForTool(node.polygon, toolDiameter)) {
+      addWarning(featureResult,
+                 "Polygon too small for selected tool diameter");
+      return;
     }
 
-    std::vector<Path> pocketPaths;
     if (spiralIn) {
-      pocketPaths =
-          generateSpiralToolpath(node->polygon, toolDiameter, stepover, true);
+      featureResult.toolpaths = generateSpiralToolpath(
+          node.fixedPath, toolDiameter, stepover, true);
     } else {
-      pocketPaths =
-          generateParallelToolpath(node->polygon, toolDiameter, stepover, 0.0);
+      featureResult.toolpaths = generateRasterToolpath(
+          node.fixedPath, holePaths(node), toolDiameter, stepover, 0.0);
     }
-
-    result.toolpaths.insert(result.toolpaths.end(), pocketPaths.begin(),
-                            pocketPaths.end());
-  }
+  });
+  mergeFeatureResults(featureResults, result);
 
   result.success = true;
   return result;
@@ -405,21 +1079,186 @@ CAMOperationResult CAMProcessor::generatePocketToolpaths(
 
 CAMOperationResult CAMProcessor::generateEngraveToolpaths(
     const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
-    double toolDiameter, double stepover) {
+    double toolDiameter, double stepover, int threadCount) {
   CAMOperationResult result;
 
-  for (const auto &node : hierarchy) {
-    if (node->isHole) {
-      continue;  // Skip holes for engraving
+  std::vector<CAMOperationResult> featureResults(hierarchy.size());
+  forEachFeature(hierarchy.size(), threadCount, [&](size_t i) {
+    const PolygonHierarchy &node = *hierarchy[i];
+    if (node.isHole) {
+      return;  // Skip holes for engraving
     }
 
     // Generate raster pattern at 45 degrees for optimal surface finish
-    auto engravePaths =
-        generateRasterToolpath(node->polygon, toolDiameter, stepover, 45.0);
-    result.toolpaths.insert(result.toolpaths.end(), engravePaths.begin(),
-                            engravePaths.end());
+    featureResults[i].toolpaths = generateRasterToolpath(
+        node.fixedPath, holePaths(node), toolDiameter, stepover, 45.0);
+  });
+  mergeFeatureResults(featureResults, result);
+
+  result.success = true;
+  return result;
+}
+
+CAMOperationResult CAMProcessor::generateVCarveToolpaths(
+    const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+    const Tool &tool, double maxDepth, int threadCount) {
+  CAMOperationResult result;
+
+  double tipAngle = tool.tipAngle;
+  if (tipAngle <= 0.0 || tipAngle >= 180.0) {
+    addWarning(result, "V-bit has no tip angle set, assuming 90 degrees");
+    tipAngle = 90.0;
+  }
+
+  // Shapes whose boxes overlap may overlap, and must not see each other's
+  // walls: each shape goes into the first batch without such a shape
+  std::vector<size_t> features;
+  std::vector<Clipper2Lib::Rect64> boxes;
+  for (size_t i = 0; i < hierarchy.size(); ++i) {
+    const PolygonHierarchy &node = *hierarchy[i];
+    if (!node.isHole && node.polygon.size() >= 3) {
+      features.push_back(i);
+      boxes.push_back(Clipper2Lib::GetBounds(node.fixedPath));
+    }
+  }
+  BoxGrid boxGrid(boxes);
+  std::vector<size_t> featureBatch(features.size(), 0);
+  std::vector<std::vector<size_t>> batches;
+  std::vector<char> taken;
+  for (size_t k = 0; k < features.size(); ++k) {
+    taken.assign(batches.size() + 1, 0);
+    boxGrid.forEachNear(boxes[k], [&](size_t other) {
+      if (other < k && BoxGrid::overlaps(boxes[other], boxes[k])) {
+        taken[featureBatch[other]] = 1;
+      }
+    });
+    featureBatch[k] = std::find(taken.begin(), taken.end(), 0) - taken.begin();
+    if (featureBatch[k] == batches.size()) {
+      batches.emplace_back();
+    }
+    batches[featureBatch[k]].push_back(k);
+  }
+
+  // One medial axis per batch: each outline with the holes directly inside
+  // it, holes being carved as walls of their outline
+  MedialAxis::Options options;
+  options.sampleSpacing = kVCarveSampleSpacing;
+  options.threadCount = threadCount;
+  MedialAxis axis(options);
+  VCarveBit bit = vcarveBit(tool.diameter, tipAngle, maxDepth);
+  double liftLength = vcarveLiftLength(m_config, maxDepth);
+  std::vector<std::vector<Path>> featurePaths(features.size());
+  std::vector<PathView> rings;
+  std::vector<char> holes;
+  std::vector<size_t> featureRings;
+  auto addRing = [&](const Polygon &polygon, bool hole) {
+    const auto &points = polygon.getPoints();
+    rings.emplace_back(&points[0].x, &points[0].y, points.size(), 2);
+    holes.push_back(hole);
+  };
+  for (const auto &batch : batches) {
+    rings.clear();
+    holes.clear();
+    featureRings.assign(1, 0);
+    for (size_t k : batch) {
+      const PolygonHierarchy &node = *hierarchy[features[k]];
+      addRing(node.polygon, false);
+      for (const auto &child : node.children) {
+        if (child->isHole && !child->polygon.empty()) {
+          addRing(child->polygon, true);
+        }
+      }
+      featureRings.push_back(rings.size());
+    }
+    if (axis.compute(rings, holes)) {
+      for (size_t j = 0; j < batch.size(); ++j) {
+        addVCarvePaths(axis, featureRings[j], featureRings[j + 1], bit,
+                       liftLength, featurePaths[batch[j]]);
+      }
+    }
   }
+  for (auto &paths : featurePaths) {
+    for (auto &path : paths) {
+      result.toolpaths.push_back(std::move(path));
+    }
+  }
+  NWSS_LOG_DEBUG("V-carve toolpaths complete - " << result.toolpaths.size()
+                 << " paths");
+
+  result.success = true;
+  return result;
+}
+
+CAMOperationResult CAMProcessor::generateAdaptiveToolpaths(
+    const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+    double toolDiameter, double stepover, int threadCount,
+    bool skipNarrowFeatures) {
+  // ADAPTIVE MODE: Clears the same areas as pocketing, but grows the cut
+  // outward from the deepest point so the tool engagement stays bounded
+  CAMOperationResult result;
+
+  std::vector<CAMOperationResult> featureResults(hierarchy.size());
+  forEachFeature(hierarchy.size(), threadCount, [&](size_t i) {
+    const PolygonHierarchy &node = *hierarchy[i];
+    CAMOperationResult &featureResult = featureResults[i];
+    if (node.isHole) {
+      return;  // Holes are left standing as islands
+    }
+
+    if (skipNarrowFeatures &&
+        isPolygonTooSmallForTool(node.polygon, toolDiameter)) {
+      addWarning(featureResult,
+                 "Polygon too small for selected tool diameter");
+      return;
+    }
+
+    featureResult.toolpaths = generateAdaptiveToolpath(
+        node.fixedPath, holePaths(node), toolDiameter, stepover);
+  });
+  mergeFeatureResults(featureResults, result);
+
+  result.success = true;
+  return result;
+}
+
+CAMOperationResult CAMProcessor::generateRestToolpaths(
+    const std::vector<std::shared_ptr<PolygonHierarchy>> &hierarchy,
+    double toolDiameter, double restToolDiameter, double stepover,
+    CutoutMode mode, bool spiralIn, int threadCount) {
+  // REST MACHINING: Clears only the corners and narrow parts a larger tool
+  // could not reach, instead of clearing everything with the smaller tool
+  CAMOperationResult result;
+
+  std::vector<CAMOperationResult> featureResults(hierarchy.size());
+  forEachFeature(hierarchy.size(), threadCount, [&](size_t i) {
+    const PolygonHierarchy &node = *hierarchy[i];
+    if (node.isHole || node.fixedPath.size() < 3) {
+      return;  // Holes are left standing as islands
+    }
+
+    std::vector<Path> &toolpaths = featureResults[i].toolpaths;
+    for (const auto &area : restAreas(node.fixedPath, holePaths(node),
+                                      toolDiameter / 2.0, restToolDiameter)) {
+      Clipper2Lib::Paths64 areaHoles(area.begin() + 1, area.end());
+      std::vector<Path> areaPaths;
+      if (mode == CutoutMode::ADAPTIVE) {
+        areaPaths = generateAdaptiveToolpath(area[0], areaHoles,
+                                             restToolDiameter, stepover);
+      } else if (spiralIn && areaHoles.empty()) {
+        areaPaths = generateSpiralToolpath(area[0], restToolDiameter,
+                                           stepover, true);
+      } else {
+        // Spirals cut through islands; rest areas often wrap around them
+        areaPaths = generateRasterToolpath(area[0], areaHoles,
+                                           restToolDiameter, stepover, 0.0);
+      }
+      toolpaths.insert(toolpaths.end(), areaPaths.begin(), areaPaths.end());
+    }
+  });
+  mergeFeatureResults(featureResults, result);
 
+  NWSS_LOG_DEBUG("Rest machining complete - " << result.toolpaths.size()
+                 << " paths");
   result.success = true;
   return result;
 }
@@ -429,14 +1268,14 @@ CAMOperationResult CAMProcessor::validateToolpathFeasibility(
   CAMOperationResult result;
   result.success = true;
 
-  std::cout << "DEBUG: validateToolpathFeasibility() called:" << std::endl;
-  std::cout << "  - Polygon points: " << polygon.size() << std::endl;
-  std::cout << "  - Tool diameter: " << toolDiameter << "mm" << std::endl;
-  std::cout << "  - Cutout mode: " << static_cast<int>(cutoutMode) << std::endl;
+  NWSS_LOG_DEBUG("validateToolpathFeasibility() called:");
+  NWSS_LOG_DEBUG("  - Polygon points: " << polygon.size());
+  NWSS_LOG_DEBUG("  - Tool diameter: " << toolDiameter << "mm");
+  NWSS_LOG_DEBUG("  - Cutout mode: " << static_cast<int>(cutoutMode));
 
   // Check for invalid geometry
   if (hasInvalidGeometry(polygon)) {
-    std::cout << "DEBUG: Invalid geometry detected" << std::endl;
+    NWSS_LOG_DEBUG("Invalid geometry detected");
     addError(result, "Polygon has invalid geometry");
     result.success = false;
     return result;
@@ -446,18 +1285,19 @@ CAMOperationResult CAMProcessor::validateToolpathFeasibility(
   double area = polygon.area();
   double toolArea =
       (toolDiameter * toolDiameter * M_PI) / 4.0;  // Area of tool circle
-  std::cout << "DEBUG: Polygon area: " << area << "mm², tool area: " << toolArea
-            << "mm²" << std::endl;
+  NWSS_LOG_DEBUG("Polygon area: " << area << "mm², tool area: " << toolArea
+                 << "mm²");
 
   if (area <
       toolArea * 2.0) {  // Need at least 2x tool area for meaningful cutting
-    if (cutoutMode == CutoutMode::POCKET) {
-      std::cout << "DEBUG: Polygon area too small for pocketing" << std::endl;
+    if (cutoutMode == CutoutMode::POCKET ||
+        cutoutMode == CutoutMode::ADAPTIVE) {
+      NWSS_LOG_DEBUG("Polygon area too small for pocketing");
       addError(result,
                "Polygon area too small for pocketing with selected tool");
       result.success = false;
     } else if (cutoutMode == CutoutMode::PUNCHOUT) {
-      std::cout << "DEBUG: Polygon area too small for punchout" << std::endl;
+      NWSS_LOG_DEBUG("Polygon area too small for punchout");
       addWarning(result,
                  "Polygon area may be too small for effective punchout");
     }
@@ -470,30 +1310,31 @@ CAMOperationResult CAMProcessor::validateToolpathFeasibility(
   double height = maxY - minY;
   double minDimension = std::min(width, height);
 
-  std::cout << "DEBUG: Polygon dimensions: " << width << "x" << height
-            << "mm, min: " << minDimension << "mm" << std::endl;
+  NWSS_LOG_DEBUG("Polygon dimensions: " << width << "x" << height
+                 << "mm, min: " << minDimension << "mm");
 
   // Different dimension requirements for different modes
   double requiredMultiplier = 1.5;  // Default
   if (cutoutMode == CutoutMode::PUNCHOUT) {
     requiredMultiplier =
         1.2;  // More lenient for punchout - can still rough out material
-  } else if (cutoutMode == CutoutMode::POCKET) {
+  } else if (cutoutMode == CutoutMode::POCKET ||
+             cutoutMode == CutoutMode::ADAPTIVE) {
     requiredMultiplier = 1.5;  // Stricter for pockets - need clean walls
   }
 
   double requiredDimension = toolDiameter * requiredMultiplier;
 
   if (minDimension < requiredDimension) {
-    if (cutoutMode == CutoutMode::POCKET) {
-      std::cout << "DEBUG: Polygon too narrow for clean pocketing" << std::endl;
+    if (cutoutMode == CutoutMode::POCKET ||
+        cutoutMode == CutoutMode::ADAPTIVE) {
+      NWSS_LOG_DEBUG("Polygon too narrow for clean pocketing");
       addError(result, "Polygon too narrow for clean pocketing (" +
                            std::to_string(minDimension) + "mm < " +
                            std::to_string(requiredDimension) + "mm required)");
       result.success = false;
     } else if (cutoutMode == CutoutMode::PUNCHOUT) {
-      std::cout << "DEBUG: Polygon narrow but may still be punchable"
-                << std::endl;
+      NWSS_LOG_DEBUG("Polygon narrow but may still be punchable");
       addWarning(
           result,
           "Feature is narrow for tool size but may still be rough-cut (" +
@@ -512,122 +1353,40 @@ CAMOperationResult CAMProcessor::validateToolpathFeasibility(
   if (polygon.size() <
       100) {  // Only check simple polygons, not complex offset paths
     if (checkForSelfIntersections(polygon)) {
-      std::cout << "DEBUG: Self-intersections detected in original geometry"
-                << std::endl;
+      NWSS_LOG_DEBUG("Self-intersections detected in original geometry");
       addWarning(
           result,
           "Polygon has self-intersections - toolpaths may be unreliable");
       // Don't fail validation for this, just warn
     }
   } else {
-    std::cout << "DEBUG: Skipping self-intersection check for complex polygon ("
-              << polygon.size() << " points)" << std::endl;
+    NWSS_LOG_DEBUG("Skipping self-intersection check for complex polygon ("
+                   << polygon.size() << " points)");
   }
 
-  std::cout << "DEBUG: Validation complete - success: " << result.success
-            << ", warnings: " << result.warnings.size()
-            << ", errors: " << result.errors.size() << std::endl;
+  NWSS_LOG_DEBUG("Validation complete - success: " << result.success
+                 << ", warnings: " << result.warnings.size() << ", errors: "
+                 << result.errors.size());
 
   return result;
 }
 
-// Clipper2 conversion utilities
-Clipper2Lib::Paths64 CAMProcessor::polygonToClipperPaths(
-    const Polygon &polygon) {
-  Clipper2Lib::Paths64 paths;
-  Clipper2Lib::Path64 path;
+std::vector<Clipper2Lib::Paths64> CAMProcessor::offsetRings(
+    const Clipper2Lib::Path64 &path, double firstOffset, double step,
+    size_t maxRings, double minArea) {
+  std::vector<Clipper2Lib::Paths64> rings;
 
-  for (const auto &point : polygon.getPoints()) {
-    path.push_back(Clipper2Lib::Point64(
-        static_cast<int64_t>(
-            point.x * 1000),  // Convert to integer with 0.001mm precision
-        static_cast<int64_t>(point.y * 1000)));
-  }
-
-  paths.push_back(path);
-  return paths;
-}
-
-Clipper2Lib::Paths64 CAMProcessor::polygonsToClipperPaths(
-    const std::vector<Polygon> &polygons) {
-  Clipper2Lib::Paths64 paths;
-
-  for (const auto &polygon : polygons) {
-    auto polyPaths = polygonToClipperPaths(polygon);
-    paths.insert(paths.end(), polyPaths.begin(), polyPaths.end());
-  }
-
-  return paths;
-}
-
-std::vector<Polygon> CAMProcessor::clipperPathsToPolygons(
-    const Clipper2Lib::Paths64 &paths) {
-  std::vector<Polygon> polygons;
+  // Default engine options match InflatePaths (round joins, 1000x scale)
+  OffsetEngine engine;
+  engine.addPath(path, true);
 
-  for (const auto &path : paths) {
-    polygons.push_back(clipperPathToPolygon(path));
-  }
-
-  return polygons;
-}
-
-Polygon CAMProcessor::clipperPathToPolygon(const Clipper2Lib::Path64 &path) {
-  Polygon polygon;
-
-  for (const auto &point : path) {
-    polygon.addPoint(Point2D(
-        static_cast<double>(point.x) / 1000.0,  // Convert back from integer
-        static_cast<double>(point.y) / 1000.0));
+  std::string error;
+  if (!engine.offsetUntilCollapse(firstOffset, step, maxRings, minArea, rings,
+                                  error)) {
+    NWSS_LOG_WARN(error);
+    rings.clear();
   }
-
-  return polygon;
-}
-
-// Advanced polygon operations using Clipper2
-std::vector<Polygon> CAMProcessor::offsetPolygon(const Polygon &polygon,
-                                                 double offset) {
-  // Use direct Clipper2 offsetting for pure geometric operations
-  // Positive offset = expand outward, Negative offset = shrink inward
-
-  auto clipperPaths = polygonToClipperPaths(polygon);
-
-  // Scale offset to Clipper2 integer coordinates (1000x scale factor)
-  double scaledOffset = offset * 1000.0;
-
-  // Perform offset operation using Clipper2
-  auto offsetPaths = Clipper2Lib::InflatePaths(clipperPaths, scaledOffset,
-                                               Clipper2Lib::JoinType::Round,
-                                               Clipper2Lib::EndType::Polygon);
-
-  // Convert back to polygons
-  return clipperPathsToPolygons(offsetPaths);
-}
-
-std::vector<Polygon> CAMProcessor::unionPolygons(
-    const std::vector<Polygon> &polygons) {
-  auto clipperPaths = polygonsToClipperPaths(polygons);
-  auto result =
-      Clipper2Lib::Union(clipperPaths, Clipper2Lib::FillRule::NonZero);
-  return clipperPathsToPolygons(result);
-}
-
-std::vector<Polygon> CAMProcessor::intersectPolygons(
-    const std::vector<Polygon> &polygons1,
-    const std::vector<Polygon> &polygons2) {
-  auto clipperPaths1 = polygonsToClipperPaths(polygons1);
-  auto clipperPaths2 = polygonsToClipperPaths(polygons2);
-  auto result = Clipper2Lib::Intersect(clipperPaths1, clipperPaths2,
-                                       Clipper2Lib::FillRule::NonZero);
-  return clipperPathsToPolygons(result);
-}
-
-std::vector<Polygon> CAMProcessor::differencePolygons(
-    const std::vector<Polygon> &subject, const std::vector<Polygon> &clip) {
-  auto clipperSubject = polygonsToClipperPaths(subject);
-  auto clipperClip = polygonsToClipperPaths(clip);
-  auto result = Clipper2Lib::Difference(clipperSubject, clipperClip,
-                                        Clipper2Lib::FillRule::NonZero);
-  return clipperPathsToPolygons(result);
+  return rings;
 }
 
 // Professional toolpath generation algorithms
@@ -635,85 +1394,135 @@ std::vector<Path> CAMProcessor::generateSpiralToolpath(const Polygon &polygon,
                                                        double toolDiameter,
                                                        double stepover,
                                                        bool inward) {
+  return generateSpiralToolpath(FixedPoint::toPath64(polygon), toolDiameter,
+                                stepover, inward);
+}
+
+std::vector<Path> CAMProcessor::generateSpiralToolpath(
+    const Clipper2Lib::Path64 &polygon, double toolDiameter, double stepover,
+    bool inward) {
   std::vector<Path> paths;
 
   double toolRadius = toolDiameter / 2.0;
-
-  // For inward spiral (punchout): start from outside boundary, spiral toward
-  // center For outward spiral (pocket): start from inside, spiral toward
-  // boundary
-  std::vector<Polygon> currentPolygons;
-
+  const size_t MAX_SPIRAL_PASSES = 1000;
+  double minArea =
+      (toolDiameter * toolDiameter) * 0.1;  // Even smaller minimum area
+
+  // Every pass is an offset of the input polygon itself, one stepover
+  // further in than the previous pass.
+  // For inward spiral (punchout): start from the outer boundary (no initial
+  // offset) and spiral toward the center.
+  // For outward spiral (pocket): the same rings starting one tool radius
+  // inside, cut from the center out toward the boundary.
   if (inward) {
-    // PUNCHOUT: Start from the outer boundary (no initial offset)
-    // and spiral inward by stepover each pass
-    std::cout << "DEBUG: Starting INWARD spiral (punchout) from outer boundary"
-              << std::endl;
-    currentPolygons.push_back(polygon);
+    NWSS_LOG_DEBUG("Starting INWARD spiral (punchout) from outer boundary");
   } else {
-    // POCKET: Start from inside (offset inward by tool radius)
-    // and spiral outward by stepover each pass
-    std::cout << "DEBUG: Starting OUTWARD spiral (pocket) from inner boundary"
-              << std::endl;
-    currentPolygons = offsetPolygon(polygon, -toolRadius);
-  }
-
-  int passCount = 0;
-  const int MAX_SPIRAL_PASSES = 1000;
-
-  std::cout << "DEBUG: Starting spiral with " << currentPolygons.size()
-            << " initial polygons" << std::endl;
-
-  while (!currentPolygons.empty() && passCount < MAX_SPIRAL_PASSES) {
-    // Convert largest polygon to path
-    auto largestPoly = *std::max_element(
-        currentPolygons.begin(), currentPolygons.end(),
-        [](const Polygon &a, const Polygon &b) { return a.area() < b.area(); });
-
-    double currentArea = largestPoly.area();
-    std::cout << "DEBUG: Pass " << passCount << " - area: " << currentArea
-              << "mm²" << std::endl;
-
-    if (largestPoly.size() >= 3) {
-      Path path(largestPoly.getPoints());
-      paths.push_back(path);
-    }
-
-    // Offset for next pass
-    double offsetDistance = inward ? -stepover : stepover;
-    auto nextPolygons = offsetPolygon(largestPoly, offsetDistance);
-
-    std::cout << "DEBUG: Offset by " << offsetDistance << "mm generated "
-              << nextPolygons.size() << " polygons" << std::endl;
-
-    // Filter out polygons that are too small
-    currentPolygons.clear();
-    double minArea =
-        (toolDiameter * toolDiameter) * 0.1;  // Even smaller minimum area
-    for (const auto &poly : nextPolygons) {
-      double polyArea = poly.area();
-      if (polyArea > minArea) {
-        currentPolygons.push_back(poly);
-        std::cout << "DEBUG: Keeping polygon with area " << polyArea << "mm²"
-                  << std::endl;
+    NWSS_LOG_DEBUG("Starting OUTWARD spiral (pocket) from inner boundary");
+  }
+  auto rings = offsetRings(polygon, inward ? 0.0 : -toolRadius, -stepover,
+                           MAX_SPIRAL_PASSES, minArea);
+
+  // Each polygon of a pass lies inside one polygon of the pass before; where
+  // a pass splits into several regions the polygon gets several children
+  struct SpiralRing {
+    const Clipper2Lib::Path64 *path;
+    std::vector<size_t> children;
+  };
+  std::vector<SpiralRing> spiralRings;
+  std::vector<size_t> chainStarts;
+  std::vector<size_t> previousPass;
+  bool outlinePositive = Clipper2Lib::IsPositive(polygon);
+
+  size_t passCount = 0;
+  for (; passCount < rings.size(); ++passCount) {
+    std::vector<size_t> currentPass;
+    for (const auto &poly : rings[passCount]) {
+      // After the first pass, slivers are skipped
+      if (poly.size() < 3 ||
+          (passCount > 0 && FixedPoint::area(poly) <= minArea)) {
+        continue;
+      }
+
+      size_t index = spiralRings.size();
+      spiralRings.push_back({&poly, {}});
+      currentPass.push_back(index);
+
+      // Rings around islands are cut on their own
+      size_t parent = spiralRings.size();
+      if (Clipper2Lib::IsPositive(poly) == outlinePositive) {
+        for (size_t candidate : previousPass) {
+          if (Clipper2Lib::PointInPolygon(poly[0],
+                                          *spiralRings[candidate].path) !=
+              Clipper2Lib::PointInPolygonResult::IsOutside) {
+            parent = candidate;
+            break;
+          }
+        }
+      }
+      if (parent < spiralRings.size()) {
+        spiralRings[parent].children.push_back(index);
       } else {
-        std::cout << "DEBUG: Filtering out small polygon with area " << polyArea
-                  << "mm²" << std::endl;
+        chainStarts.push_back(index);
       }
     }
 
-    passCount++;
-
-    // Only stop if we truly have no more polygons to process
-    if (currentPolygons.empty()) {
-      std::cout << "DEBUG: Spiral complete - no more polygons to process"
-                << std::endl;
+    if (currentPass.empty()) {
+      NWSS_LOG_DEBUG("Spiral complete - no more polygons to process");
       break;
     }
+    NWSS_LOG_DEBUG("Pass " << passCount << " - " << currentPass.size()
+                   << " regions");
+    previousPass = std::move(currentPass);
+  }
+
+  // Follow each ring once around, then step to the nearest point of the
+  // next ring in, so a pocket is cut in one path. Further regions a ring
+  // splits into start paths of their own.
+  for (size_t s = 0; s < chainStarts.size(); ++s) {
+    Clipper2Lib::Path64 chain;
+    size_t current = chainStarts[s];
+    size_t entry = 0;
+    while (true) {
+      const Clipper2Lib::Path64 &ring = *spiralRings[current].path;
+      for (size_t i = 0; i <= ring.size(); ++i) {
+        chain.push_back(ring[(entry + i) % ring.size()]);
+      }
+
+      const Clipper2Lib::Point64 &position = ring[entry];
+      size_t next = spiralRings.size();
+      size_t nextEntry = 0;
+      for (size_t child : spiralRings[current].children) {
+        const Clipper2Lib::Path64 &childRing = *spiralRings[child].path;
+        size_t childEntry = nearestVertex(childRing, position);
+        if (next == spiralRings.size() &&
+            !crossesPath(position, childRing[childEntry], ring) &&
+            !crossesPath(position, childRing[childEntry], childRing)) {
+          next = child;
+          nextEntry = childEntry;
+        } else {
+          chainStarts.push_back(child);
+        }
+      }
+      if (next == spiralRings.size()) {
+        break;
+      }
+      current = next;
+      entry = nextEntry;
+    }
+
+    // The outward spiral cuts the same paths from the center out
+    if (!inward) {
+      std::reverse(chain.begin(), chain.end());
+    }
+    paths.push_back(FixedPoint::toPath(chain));
   }
 
-  std::cout << "DEBUG: Spiral toolpath complete - " << passCount << " passes, "
-            << paths.size() << " paths" << std::endl;
+  if (!inward) {
+    std::reverse(paths.begin(), paths.end());
+  }
+
+  NWSS_LOG_DEBUG("Spiral toolpath complete - " << passCount << " passes, "
+                 << paths.size() << " paths");
   return paths;
 }
 
@@ -727,60 +1536,62 @@ std::vector<Path> CAMProcessor::generateParallelToolpath(const Polygon &polygon,
 std::vector<Path> CAMProcessor::generateContourToolpath(const Polygon &polygon,
                                                         double toolDiameter,
                                                         double stepover) {
+  return generateContourToolpath(FixedPoint::toPath64(polygon), toolDiameter,
+                                 stepover);
+}
+
+std::vector<Path> CAMProcessor::generateContourToolpath(
+    const Clipper2Lib::Path64 &polygon, double toolDiameter,
+    double stepover) {
   std::vector<Path> paths;
 
   double toolRadius = toolDiameter / 2.0;
+  const size_t MAX_PASSES = 10;  // Reduced limit for efficiency
+  double minArea =
+      (toolDiameter * toolDiameter) * 2.0;  // Increased minimum area
 
-  // Start with initial offset
-  auto currentPolygons = offsetPolygon(polygon, -toolRadius);
+  // One tool radius in, then one stepover further per pass
+  auto rings =
+      offsetRings(polygon, -toolRadius, -stepover, MAX_PASSES, minArea);
 
-  int passCount = 0;
-  const int MAX_PASSES = 10;  // Reduced limit for efficiency
+  size_t passCount = 0;
   double previousTotalArea = 0.0;
 
-  while (!currentPolygons.empty() && passCount < MAX_PASSES) {
-    std::vector<Polygon> nextPolygons;
+  for (; passCount < rings.size(); ++passCount) {
     double currentTotalArea = 0.0;
+    bool anyPolygon = false;
 
-    for (const auto &poly : currentPolygons) {
+    for (const auto &poly : rings[passCount]) {
+      double area = FixedPoint::area(poly);
+      if (passCount > 0 && area <= minArea) {
+        continue;
+      }
+      anyPolygon = true;
       if (poly.size() >= 3) {
-        currentTotalArea += poly.area();
-        Path path(poly.getPoints());
-        paths.push_back(path);
-
-        // Generate next offset
-        auto offsetPolys = offsetPolygon(poly, -stepover);
-
-        for (const auto &offsetPoly : offsetPolys) {
-          double area = offsetPoly.area();
-          double minArea =
-              (toolDiameter * toolDiameter) * 2.0;  // Increased minimum area
-
-          if (area > minArea) {
-            nextPolygons.push_back(offsetPoly);
-          }
-        }
+        currentTotalArea += area;
+        paths.push_back(FixedPoint::toPath(poly));
       }
     }
+    if (!anyPolygon) {
+      break;
+    }
 
     // Check for convergence - if area isn't decreasing significantly, stop
     if (passCount > 0 && previousTotalArea > 0) {
       double areaReduction =
           (previousTotalArea - currentTotalArea) / previousTotalArea;
       if (areaReduction < 0.1) {  // Less than 10% reduction
-        std::cout << "DEBUG: Contour toolpath converged after " << passCount
-                  << " passes" << std::endl;
+        NWSS_LOG_DEBUG("Contour toolpath converged after " << passCount
+                       << " passes");
         break;
       }
     }
 
-    currentPolygons = nextPolygons;
     previousTotalArea = currentTotalArea;
-    passCount++;
   }
 
-  std::cout << "DEBUG: Contour toolpath complete - " << passCount << " passes, "
-            << paths.size() << " paths" << std::endl;
+  NWSS_LOG_DEBUG("Contour toolpath complete - " << passCount << " passes, "
+                 << paths.size() << " paths");
   return paths;
 }
 
@@ -788,49 +1599,225 @@ std::vector<Path> CAMProcessor::generateRasterToolpath(const Polygon &polygon,
                                                        double toolDiameter,
                                                        double stepover,
                                                        double angle) {
+  return generateRasterToolpath(FixedPoint::toPath64(polygon),
+                                Clipper2Lib::Paths64(), toolDiameter, stepover,
+                                angle);
+}
+
+std::vector<Path> CAMProcessor::generateRasterToolpath(
+    const Clipper2Lib::Path64 &outline, const Clipper2Lib::Paths64 &holes,
+    double toolDiameter, double stepover, double angle) {
+  if (outline.size() < 3 || stepover <= 0.0) {
+    return std::vector<Path>();
+  }
+
+  Clipper2Lib::Paths64 region;
+  if (!toolCenterRegion(outline, holes, toolDiameter / 2.0, region)) {
+    return std::vector<Path>();
+  }
+
+  auto paths = ScanlineFill::zigZag(region, stepover, angle);
+  NWSS_LOG_DEBUG("Raster toolpath complete - " << paths.size()
+                 << " zig-zag paths");
+  return paths;
+}
+
+std::vector<Path> CAMProcessor::generateAdaptiveToolpath(
+    const Polygon &polygon, double toolDiameter, double stepover) {
+  return generateAdaptiveToolpath(FixedPoint::toPath64(polygon),
+                                  Clipper2Lib::Paths64(), toolDiameter,
+                                  stepover);
+}
+
+std::vector<Path> CAMProcessor::generateAdaptiveToolpath(
+    const Clipper2Lib::Path64 &outline, const Clipper2Lib::Paths64 &holes,
+    double toolDiameter, double stepover) {
   std::vector<Path> paths;
+  if (outline.size() < 3 || stepover <= 0.0) {
+    return paths;
+  }
 
-  // Get polygon bounds
-  double minX, minY, maxX, maxY;
-  polygon.getBounds(minX, minY, maxX, maxY);
+  const size_t MAX_ADAPTIVE_PASSES = 10000;
+  const int SEED_SEGMENTS = 32;
+  const double scale = FixedPoint::kDefaultScale;
+  // Vertices this close to a wall (mm) are on it; Clipper2 rounds the points
+  // where a pass meets a wall to the nearest unit
+  const double wallTolerance = 2.0 / scale;
+  // A pass that clears less than this (mm^2) ends the clearing
+  const double minGain = stepover * stepover * 0.01;
+
+  Clipper2Lib::Paths64 region;
+  if (!toolCenterRegion(outline, holes, toolDiameter / 2.0, region)) {
+    return paths;
+  }
 
-  // Calculate raster lines
-  double angleRad = angle * M_PI / 180.0;
-  double cosAngle = std::cos(angleRad);
-  double sinAngle = std::sin(angleRad);
+  std::string error;
+  Clipper2Lib::Path64 current;
+  auto flush = [&]() {
+    if (current.size() >= 2) {
+      paths.push_back(FixedPoint::toPath(current));
+    }
+    current.clear();
+  };
+  // Continue the current path with a cut if the move there stays inside
+  // the area already reached, otherwise start a new path
+  auto append = [&](const Clipper2Lib::Path64 &cut,
+                    const Clipper2Lib::Paths64 &reached) {
+    if (!current.empty() &&
+        !segmentInsideRegion(current.back(), cut.front(), reached)) {
+      flush();
+    }
+    current.insert(current.end(), cut.begin(), cut.end());
+  };
+
+  size_t passCount = 0;
+  for (const auto &area : splitRegion(region)) {
+    // Enter at the deepest point of the area: a point of the last ring left
+    // when it is shrunk one stepover at a time, which lies on its medial
+    // axis
+    OffsetEngine coreEngine;
+    coreEngine.addPaths(area, true);
+    std::vector<Clipper2Lib::Paths64> cores;
+    if (!coreEngine.offsetUntilCollapse(-stepover, -stepover,
+                                        MAX_ADAPTIVE_PASSES, 0.0, cores,
+                                        error)) {
+      NWSS_LOG_WARN(error);
+      continue;
+    }
+    Clipper2Lib::Point64 entry = area[0][0];
+    for (auto ring = cores.rbegin(); ring != cores.rend(); ++ring) {
+      if (!ring->empty() && !ring->front().empty() &&
+          insideRegion(ring->front().front(), area)) {
+        entry = ring->front().front();
+        break;
+      }
+    }
 
-  // Determine the number of passes needed
-  double diagonal =
-      std::sqrt((maxX - minX) * (maxX - minX) + (maxY - minY) * (maxY - minY));
-  int numPasses = static_cast<int>(std::ceil(diagonal / stepover));
+    SegmentGrid walls;
+    std::vector<Path> wallPaths = FixedPoint::toPaths(area);
+    for (size_t i = 0; i < wallPaths.size(); ++i) {
+      walls.addPath(wallPaths[i], i, true);
+    }
+    walls.build();
+
+    // The first pass is a circle of one stepover around the entry point;
+    // every later pass reaches one stepover beyond the area cleared so far,
+    // so the tool never cuts wider than a stepover
+    Clipper2Lib::Path64 seed;
+    for (int i = 0; i < SEED_SEGMENTS; ++i) {
+      double angle = 2.0 * M_PI * i / SEED_SEGMENTS;
+      seed.push_back(Clipper2Lib::Point64(
+          entry.x + std::round(stepover * scale * std::cos(angle)),
+          entry.y + std::round(stepover * scale * std::sin(angle))));
+    }
+    Clipper2Lib::Paths64 reach{seed};
+    Clipper2Lib::Paths64 cleared;
+    double clearedArea = 0.0;
+    double areaLimit =
+        std::fabs(Clipper2Lib::Area(area)) / (scale * scale) + minGain;
+    flush();
+    current.push_back(entry);
+
+    for (size_t pass = 0; pass < MAX_ADAPTIVE_PASSES; ++pass) {
+      PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+      Clipper2Lib::Paths64 next = Clipper2Lib::Intersect(
+          reach, area, Clipper2Lib::FillRule::NonZero);
+
+      // Keep only the parts connected to the area already cleared; others
+      // are reached later through the material in between
+      if (!cleared.empty()) {
+        Clipper2Lib::Paths64 connected;
+        std::vector<Clipper2Lib::Paths64> clearedParts = splitRegion(cleared);
+        for (const auto &part : splitRegion(next)) {
+          for (const auto &clearedPart : clearedParts) {
+            if (insideRegion(clearedPart[0][0], part)) {
+              connected.insert(connected.end(), part.begin(), part.end());
+              break;
+            }
+          }
+        }
+        next = std::move(connected);
+      }
 
-  for (int i = 0; i < numPasses; ++i) {
-    double offset = i * stepover - diagonal / 2.0;
+      double nextArea = std::fabs(Clipper2Lib::Area(next)) / (scale * scale);
+      if (next.empty() || nextArea - clearedArea <= minGain) {
+        break;
+      }
+      if (nextArea > areaLimit) {
+        NWSS_LOG_WARN("Adaptive clearing stopped: pass left the region");
+        break;
+      }
 
-    // Create a long line across the bounding box
-    Point2D start(-diagonal, offset);
-    Point2D end(diagonal, offset);
+      std::vector<Clipper2Lib::Path64> runs;
+      for (const auto &ring : next) {
+        frontierRuns(ring, walls, wallTolerance, runs);
+      }
+      for (const auto &run : runs) {
+        append(run, next);
+      }
 
-    // Rotate the line by the specified angle
-    Point2D center((minX + maxX) / 2.0, (minY + maxY) / 2.0);
-    Point2D rotatedStart(start.x * cosAngle - start.y * sinAngle + center.x,
-                         start.x * sinAngle + start.y * cosAngle + center.y);
-    Point2D rotatedEnd(end.x * cosAngle - end.y * sinAngle + center.x,
-                       end.x * sinAngle + end.y * cosAngle + center.y);
+      cleared = std::move(next);
+      clearedArea = nextArea;
+      ++passCount;
 
-    // TODO: Use Clipper2 for proper line-polygon intersection
-    // For now, use simple point containment check
-    Path rasterLine;
-    rasterLine.addPoint(rotatedStart);
-    rasterLine.addPoint(rotatedEnd);
+      OffsetEngine growEngine;
+      growEngine.addPaths(cleared, true);
+      std::vector<Clipper2Lib::Paths64> grown;
+      if (!growEngine.offset({stepover}, grown, error)) {
+        NWSS_LOG_WARN(error);
+        break;
+      }
+      reach = std::move(grown[0]);
+    }
 
-    Point2D midPoint((rotatedStart.x + rotatedEnd.x) / 2.0,
-                     (rotatedStart.y + rotatedEnd.y) / 2.0);
-    if (polygon.containsPoint(midPoint)) {
-      paths.push_back(rasterLine);
+    // Finish with one pass along the walls
+    for (const auto &wall : area) {
+      if (wall.size() < 3) {
+        continue;
+      }
+      size_t start =
+          current.empty() ? 0 : nearestVertex(wall, current.back());
+      Clipper2Lib::Path64 loop;
+      for (size_t i = 0; i <= wall.size(); ++i) {
+        loop.push_back(wall[(start + i) % wall.size()]);
+      }
+      append(loop, area);
     }
   }
+  flush();
+
+  NWSS_LOG_DEBUG("Adaptive toolpath complete - " << passCount << " passes, "
+                 << paths.size() << " paths");
+  return paths;
+}
+
+std::vector<Path> CAMProcessor::generateVCarveToolpath(
+    const Polygon &polygon, const std::vector<Polygon> &holes,
+    double tipDiameter, double tipAngle, double maxDepth) {
+  std::vector<Path> paths;
+  if (polygon.size() < 3 || tipAngle <= 0.0 || tipAngle >= 180.0) {
+    return paths;
+  }
+
+  std::vector<Path> rings;
+  rings.reserve(holes.size() + 1);
+  rings.emplace_back(polygon.getPoints());
+  for (const auto &hole : holes) {
+    rings.emplace_back(hole.getPoints());
+  }
 
+  MedialAxis::Options options;
+  options.sampleSpacing = kVCarveSampleSpacing;
+  MedialAxis axis(options);
+  if (!axis.compute(rings)) {
+    return paths;
+  }
+
+  addVCarvePaths(axis, 0, axis.ringCount(),
+                 vcarveBit(tipDiameter, tipAngle, maxDepth),
+                 vcarveLiftLength(m_config, maxDepth), paths);
+
+  NWSS_LOG_DEBUG("V-carve toolpath complete - " << paths.size() << " paths");
   return paths;
 }
 
@@ -859,96 +1846,64 @@ bool CAMProcessor::hasInvalidGeometry(const Polygon &polygon) {
 double CAMProcessor::calculateMinimumFeatureSize(const Polygon &polygon) {
   if (polygon.size() < 3) return 0.0;
 
-  double minDistance = std::numeric_limits<double>::max();
+  // The narrowest disc of the medial axis that touches facing walls
   const auto &points = polygon.getPoints();
-
-  // Calculate minimum distance between consecutive points
-  for (size_t i = 1; i < points.size(); ++i) {
-    double distance = points[i].distanceTo(points[i - 1]);
-    minDistance = std::min(minDistance, distance);
+  MedialAxis axis;
+  double width = 0.0;
+  if (axis.narrowestWidth(
+          {PathView(&points[0].x, &points[0].y, points.size(), 2)}, {0},
+          width)) {
+    return width;
   }
 
-  // Also check distance from last to first point
-  double distance = points[0].distanceTo(points.back());
-  minDistance = std::min(minDistance, distance);
-
-  return minDistance;
+  // No opposite walls (e.g. a triangle): fall back to the narrower extent
+  double minX, minY, maxX, maxY;
+  polygon.getBounds(minX, minY, maxX, maxY);
+  return std::min(maxX - minX, maxY - minY);
 }
 
 bool CAMProcessor::checkForSelfIntersections(const Polygon &polygon) {
-  // Use Clipper2 to check for self-intersections
-  auto clipperPaths = polygonToClipperPaths(polygon);
-
-  // A simple way to check is to perform a union operation
-  // If the result differs significantly from the input, there were
-  // self-intersections
-  auto unionResult =
-      Clipper2Lib::Union(clipperPaths, Clipper2Lib::FillRule::NonZero);
+  const auto &points = polygon.getPoints();
+  if (points.size() < 3) return false;
 
-  return unionResult.size() != 1 || unionResult[0].size() != polygon.size();
+  return SegmentIntersector::hasSelfIntersections(
+      PathView(&points[0].x, &points[0].y, points.size(), 2), true);
 }
 
-bool CAMProcessor::isPolygonInsidePolygon(const Polygon &inner,
-                                          const Polygon &outer) {
-  // Use Clipper2 for robust point-in-polygon testing
-  // Convert polygons to Clipper2 format
-  auto innerPaths = polygonToClipperPaths(inner);
-  auto outerPaths = polygonToClipperPaths(outer);
+bool CAMProcessor::isPolygonInsidePolygon(const PolygonHierarchy &inner,
+                                          const PolygonHierarchy &outer) {
+  if (inner.fixedPath.empty() || outer.fixedPath.empty()) {
+    return false;
+  }
 
-  if (innerPaths.empty() || outerPaths.empty()) {
+  // Check that the inner polygon is actually smaller than the outer (to
+  // avoid cases where they're the same polygon) before the vertex tests
+  if (inner.polygon.area() >= outer.polygon.area()) {
     return false;
   }
 
-  // Test if all points of inner polygon are inside outer polygon
-  for (const auto &point : innerPaths[0]) {
-    if (Clipper2Lib::PointInPolygon(point, outerPaths[0]) ==
+  // Use Clipper2 for robust point-in-polygon testing on the fixed-point
+  // copies made when the hierarchy was built: all points of the inner
+  // polygon must be inside the outer polygon
+  for (const auto &point : inner.fixedPath) {
+    if (Clipper2Lib::PointInPolygon(point, outer.fixedPath) ==
         Clipper2Lib::PointInPolygonResult::IsOutside) {
       return false;
     }
   }
-
-  // Also check that the inner polygon is actually smaller than the outer
-  // (to avoid cases where they're the same polygon)
-  return inner.area() < outer.area();
+  return true;
 }
 
 // Toolpath optimization
-std::vector<Path> CAMProcessor::optimizeToolpathOrder(
-    const std::vector<Path> &toolpaths) {
-  if (toolpaths.size() <= 1) return toolpaths;
-
-  std::vector<Path> optimized;
-  std::vector<bool> used(toolpaths.size(), false);
-
-  // Start with the first path
-  optimized.push_back(toolpaths[0]);
-  used[0] = true;
-
-  Point2D currentEnd = toolpaths[0].getPoints().back();
-
-  // Greedy nearest-neighbor optimization
-  for (size_t i = 1; i < toolpaths.size(); ++i) {
-    double minDistance = std::numeric_limits<double>::max();
-    size_t nextIndex = 0;
-
-    for (size_t j = 0; j < toolpaths.size(); ++j) {
-      if (used[j]) continue;
-
-      Point2D pathStart = toolpaths[j].getPoints().front();
-      double distance = pathStart.distanceTo(currentEnd);
-
-      if (distance < minDistance) {
-        minDistance = distance;
-        nextIndex = j;
-      }
-    }
-
-    optimized.push_back(toolpaths[nextIndex]);
-    used[nextIndex] = true;
-    currentEnd = toolpaths[nextIndex].getPoints().back();
-  }
-
-  return optimized;
+ToolpathOrderReport CAMProcessor::optimizeToolpathOrder(
+    std::vector<Path> &toolpaths, const std::vector<int> &toolIds,
+    ToolpathOptimizer::Nesting nesting) {
+  // Toolpath direction sets climb or conventional milling and the spiral
+  // direction, so only closed toolpaths change where they start
+  ToolpathOptimizer::Options options;
+  options.reverseOpenPaths = false;
+  options.nesting = nesting;
+  return ToolpathOptimizer(options).optimize(toolpaths, toolIds);
 }
 
 std::vector<Path> CAMProcessor::removeRedundantMoves(
@@ -960,15 +1915,27 @@ std::vector<Path> CAMProcessor::removeRedundantMoves(
 
     Path cleanedPath;
     const auto &points = path.getPoints();
-    cleanedPath.addPoint(points[0]);
+    if (path.hasDepths()) {
+      cleanedPath.addPoint(points[0], path.getDepth(0));
+    } else {
+      cleanedPath.addPoint(points[0]);
+    }
 
     for (size_t i = 1; i < points.size(); ++i) {
       Point2D current = points[i];
       Point2D previous = cleanedPath.getPoints().back();
 
       // Only add point if it's significantly different from the previous
-      if (current.distanceTo(previous) > 1e-6) {  // 0.001mm threshold
-        cleanedPath.addPoint(current);
+      bool depthChanged =
+          path.hasDepths() &&
+          std::fabs(path.getDepth(i) - cleanedPath.getDepths().back()) > 1e-6;
+      if (current.distanceTo(previous) > 1e-6 ||  // 0.001mm threshold
+          depthChanged) {
+        if (path.hasDepths()) {
+          cleanedPath.addPoint(current, path.getDepth(i));
+        } else {
+          cleanedPath.addPoint(current);
+        }
       }
     }
 
@@ -3,7 +3,8 @@
 #include <algorithm>
 #include <cctype>
 #include <fstream>
-#include <iostream>
+
+#include "core/log.h"
 
 namespace nwss {
 namespace cnc {
@@ -40,7 +41,7 @@ bool CNConfig::isFirstRun(const std::string &filename) {
 bool CNConfig::loadFromFile(const std::string &filename) {
   std::ifstream file(filename);
   if (!file.is_open()) {
-    std::cerr << "Error: Could not open config file: " << filename << std::endl;
+    NWSS_LOG_ERROR("Could not open config file: " << filename);
     return false;
   }
 
@@ -106,8 +107,7 @@ bool CNConfig::loadFromFile(const std::string &filename) {
 bool CNConfig::saveToFile(const std::string &filename) const {
   std::ofstream file(filename);
   if (!file.is_open()) {
-    std::cerr << "Error: Could not open config file for writing: " << filename
-              << std::endl;
+    NWSS_LOG_ERROR("Could not open config file for writing: " << filename);
     return false;
   }
 
@@ -1,15 +1,77 @@
 #include "core/discretizer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "core/metrics.h"
+#include "core/thread_pool.h"
 #include "nanosvg.h"
 
 namespace nwss {
 namespace cnc {
 
-Discretizer::Discretizer() = default;
+namespace {
+
+// Below this many shapes the thread hand-off costs more than it saves
+const size_t kMinParallelShapes = 64;
+
+// Subdivision stops at this depth even if a piece is not flat yet (2^16
+// pieces per curve). Only degenerate input such as NaN coordinates gets
+// close; it keeps the explicit stack fixed-size.
+const int kMaxSubdivisionDepth = 16;
+const int kMaxFlatteningSegments = 1 << kMaxSubdivisionDepth;
+
+// One pending piece of a curve during subdivision
+struct BezierPiece {
+  float x0, y0, x1, y1, x2, y2, x3, y3;
+  int depth;
+};
+
+// Snapshot the shape list of an image so shapes can be processed
+// independently, and count the bezier segments
+std::vector<NSVGshape *> collectShapes(NSVGimage *image, uint64_t &segments) {
+  std::vector<NSVGshape *> shapes;
+  segments = 0;
+  for (NSVGshape *shape = image->shapes; shape != nullptr;
+       shape = shape->next) {
+    shapes.push_back(shape);
+    for (NSVGpath *path = shape->paths; path != nullptr; path = path->next) {
+      segments += path->npts > 1 ? (path->npts - 1) / 3 : 0;
+    }
+  }
+  return shapes;
+}
+
+// Check if shapes should be spread over the shared pool
+bool useParallelShapes(size_t shapeCount, int threadCount) {
+  return ThreadPool::resolveThreadCount(threadCount) > 1 &&
+         shapeCount >= kMinParallelShapes;
+}
+
+// Run task(i) for every shape, on the shared pool when there are enough
+void forEachShape(size_t shapeCount, int threadCount,
+                  const std::function<void(size_t)> &task) {
+  if (useParallelShapes(shapeCount, threadCount)) {
+    ThreadPool::shared().parallelFor(
+        shapeCount, ThreadPool::resolveThreadCount(threadCount), task);
+  } else {
+    for (size_t i = 0; i < shapeCount; ++i) {
+      task(i);
+    }
+  }
+}
+
+}  // namespace
+
+Discretizer::Discretizer() : m_fixedEvaluator(m_config.bezierSamples) {}
 Discretizer::~Discretizer() = default;
 
 void Discretizer::setConfig(const DiscretizerConfig &config) {
   m_config = config;
+  if (m_fixedEvaluator.samples() != m_config.bezierSamples) {
+    m_fixedEvaluator = BezierBatchEvaluator(m_config.bezierSamples);
+  }
 }
 
 const DiscretizerConfig &Discretizer::getConfig() const { return m_config; }
@@ -54,20 +116,36 @@ double Discretizer::calculateFlatness(float x0, float y0, float x1, float y1,
 void Discretizer::adaptiveSample(float x0, float y0, float x1, float y1,
                                  float x2, float y2, float x3, float y3,
                                  Path &path, double flatnessTolerance) const {
-  // Check the flatness of the curve
-  double flatness = calculateFlatness(x0, y0, x1, y1, x2, y2, x3, y3);
+  // Depth-first subdivision on an explicit stack. The second half of a split
+  // is pushed first so pieces are emitted from start to end, and at most one
+  // pending piece per depth is ever on the stack.
+  // A piece is final once it is flat enough and its chord is short enough,
+  // so both bounds are enforced in the same pass
+  double maxChord = m_config.maxPointDistance;
+  BezierPiece stack[kMaxSubdivisionDepth + 1];
+  int top = 0;
+  stack[0] = {x0, y0, x1, y1, x2, y2, x3, y3, 0};
+
+  while (top >= 0) {
+    BezierPiece c = stack[top--];
+
+    // If the piece is flat and short enough, just add its endpoint
+    if (c.depth >= kMaxSubdivisionDepth ||
+        (calculateFlatness(c.x0, c.y0, c.x1, c.y1, c.x2, c.y2, c.x3, c.y3) <=
+             flatnessTolerance &&
+         (maxChord <= 0.0 ||
+          Point2D(c.x0, c.y0).distanceTo(Point2D(c.x3, c.y3)) <= maxChord))) {
+      path.addPoint(Point2D(c.x3, c.y3));
+      continue;
+    }
 
-  if (flatness <= flatnessTolerance) {
-    // If the curve is flat enough, just add the endpoint
-    path.addPoint(Point2D(x3, y3));
-  } else {
-    // Otherwise, split the curve in half and recurse
-    float x01 = (x0 + x1) / 2;
-    float y01 = (y0 + y1) / 2;
-    float x12 = (x1 + x2) / 2;
-    float y12 = (y1 + y2) / 2;
-    float x23 = (x2 + x3) / 2;
-    float y23 = (y2 + y3) / 2;
+    // Otherwise, split the piece in half
+    float x01 = (c.x0 + c.x1) / 2;
+    float y01 = (c.y0 + c.y1) / 2;
+    float x12 = (c.x1 + c.x2) / 2;
+    float y12 = (c.y1 + c.y2) / 2;
+    float x23 = (c.x2 + c.x3) / 2;
+    float y23 = (c.y2 + c.y3) / 2;
 
     float x012 = (x01 + x12) / 2;
     float y012 = (y01 + y12) / 2;
@@ -77,16 +155,86 @@ void Discretizer::adaptiveSample(float x0, float y0, float x1, float y1,
     float x0123 = (x012 + x123) / 2;
     float y0123 = (y012 + y123) / 2;
 
-    // Recurse on the two halves
-    adaptiveSample(x0, y0, x01, y01, x012, y012, x0123, y0123, path,
-                   flatnessTolerance);
-    adaptiveSample(x0123, y0123, x123, y123, x23, y23, x3, y3, path,
-                   flatnessTolerance);
+    int depth = c.depth + 1;
+    stack[++top] = {x0123, y0123, x123, y123, x23, y23, c.x3, c.y3, depth};
+    stack[++top] = {c.x0, c.y0, x01, y01, x012, y012, x0123, y0123, depth};
   }
 }
 
-Path Discretizer::discretizeBezier(float *points, int numPoints) const {
-  Path result;
+int Discretizer::wangSegmentCount(float x0, float y0, float x1, float y1,
+                                  float x2, float y2, float x3, float y3,
+                                  double flatnessTolerance) const {
+  // calculateFlatness() is 16 times the squared distance bound, so convert
+  // the tolerance back to a distance first
+  double distance = std::sqrt(flatnessTolerance / 16.0);
+  if (!(distance > 0.0)) {
+    return kMaxFlatteningSegments;
+  }
+
+  // Wang's formula: n = sqrt(3 / 4 * max |second difference| / distance)
+  double ax = static_cast<double>(x0) - 2.0 * x1 + x2;
+  double ay = static_cast<double>(y0) - 2.0 * y1 + y2;
+  double bx = static_cast<double>(x1) - 2.0 * x2 + x3;
+  double by = static_cast<double>(y1) - 2.0 * y2 + y3;
+  double m = std::sqrt(std::max(ax * ax + ay * ay, bx * bx + by * by));
+
+  double n = std::ceil(std::sqrt(0.75 * m / distance));
+  if (!(n < kMaxFlatteningSegments)) {
+    return kMaxFlatteningSegments;  // Also catches NaN
+  }
+  return std::max(1, static_cast<int>(n));
+}
+
+int Discretizer::chordSegmentCount(float x0, float y0, float x1, float y1,
+                                   float x2, float y2, float x3,
+                                   float y3) const {
+  double maxChord = m_config.maxPointDistance;
+  if (maxChord <= 0.0) {
+    return 0;
+  }
+
+  // The curve's speed never exceeds three times its longest control polygon
+  // leg, so steps of 1/n in t cover at most 3 * leg / n. For straight SVG
+  // segments (control points at thirds) this splits the line evenly.
+  double leg = std::max({Point2D(x0, y0).distanceTo(Point2D(x1, y1)),
+                         Point2D(x1, y1).distanceTo(Point2D(x2, y2)),
+                         Point2D(x2, y2).distanceTo(Point2D(x3, y3))});
+  double n = std::ceil(3.0 * leg / maxChord - 1e-9);
+  if (!(n < kMaxFlatteningSegments)) {
+    return kMaxFlatteningSegments;  // Also catches NaN
+  }
+  return static_cast<int>(n);
+}
+
+int Discretizer::curveSampleCount(const float *p) const {
+  int samples;
+  if (m_config.adaptiveSampling <= 0.0) {
+    samples = m_config.bezierSamples;
+  } else if (m_config.flatteningMethod == FlatteningMethod::WANG) {
+    samples = wangSegmentCount(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7],
+                               m_config.adaptiveSampling);
+  } else {
+    return -1;
+  }
+  return std::max(samples, chordSegmentCount(p[0], p[1], p[2], p[3], p[4],
+                                             p[5], p[6], p[7]));
+}
+
+void Discretizer::flattenBezier(float *points, int numPoints,
+                                Path &result) const {
+  // Reserve exactly when the sample counts are known up front
+  if (numPoints > 0) {
+    size_t total = 1;
+    for (int i = 0; i < numPoints - 1; i += 3) {
+      int count = curveSampleCount(&points[i * 2]);
+      if (count < 0) {
+        total = 0;
+        break;
+      }
+      total += static_cast<size_t>(count);
+    }
+    result.reserve(result.size() + total);
+  }
 
   // For each bezier segment in the path
   for (int i = 0; i < numPoints - 1; i += 3) {
@@ -110,20 +258,39 @@ Path Discretizer::discretizeBezier(float *points, int numPoints) const {
       result.addPoint(Point2D(x0, y0));
     }
 
-    if (m_config.adaptiveSampling > 0.0) {
+    if (m_config.adaptiveSampling > 0.0 &&
+        m_config.flatteningMethod == FlatteningMethod::SUBDIVISION) {
       // Use adaptive sampling based on curvature
       double flatnessTolerance = m_config.adaptiveSampling;
       adaptiveSample(x0, y0, x1, y1, x2, y2, x3, y3, result, flatnessTolerance);
-    } else {
-      // Use fixed sampling
-      int samples = m_config.bezierSamples;
+    } else if (m_config.adaptiveSampling > 0.0) {
+      // Uniform steps, as many as Wang's formula and the chord bound need
+      int samples = curveSampleCount(p);
       for (int j = 1; j <= samples; j++) {
         float t = (float)j / samples;
         result.addPoint(evaluateBezier(x0, y0, x1, y1, x2, y2, x3, y3, t));
       }
+    } else {
+      // Use fixed sampling (more samples if a chord would be too long)
+      int samples = curveSampleCount(p);
+      if (samples == m_fixedEvaluator.samples()) {
+        // Batch evaluation with the precomputed weights
+        m_fixedEvaluator.append(p, result);
+      } else {
+        for (int j = 1; j <= samples; j++) {
+          float t = (float)j / samples;
+          result.addPoint(evaluateBezier(x0, y0, x1, y1, x2, y2, x3, y3, t));
+        }
+      }
     }
   }
 
+}
+
+Path Discretizer::discretizeBezier(float *points, int numPoints) const {
+  Path result;
+  flattenBezier(points, numPoints, result);
+
   // Apply path simplification if enabled
   if (m_config.simplifyTolerance > 0.0) {
     return result.simplify(m_config.simplifyTolerance);
@@ -132,6 +299,17 @@ Path Discretizer::discretizeBezier(float *points, int numPoints) const {
   return result;
 }
 
+void Discretizer::flattenPath(NSVGpath *path, Path &scratch,
+                              PathSet &out) const {
+  scratch.clear();
+  flattenBezier(path->pts, path->npts, scratch);
+  if (m_config.simplifyTolerance > 0.0) {
+    out.addPath(scratch.simplify(m_config.simplifyTolerance));
+  } else {
+    out.addPath(scratch);
+  }
+}
+
 Path Discretizer::discretizePath(NSVGpath *path) const {
   if (!path) {
     return Path();
@@ -155,20 +333,92 @@ std::vector<Path> Discretizer::discretizeShape(NSVGshape *shape) const {
 }
 
 std::vector<Path> Discretizer::discretizeImage(NSVGimage *image) const {
+  ScopedStageTimer timer("discretize");
   std::vector<Path> allPaths;
 
   if (!image) {
     return allPaths;
   }
 
-  for (NSVGshape *shape = image->shapes; shape != nullptr;
-       shape = shape->next) {
-    auto shapePaths = discretizeShape(shape);
-    allPaths.insert(allPaths.end(), shapePaths.begin(), shapePaths.end());
+  uint64_t segments = 0;
+  std::vector<NSVGshape *> shapes = collectShapes(image, segments);
+
+  std::vector<std::vector<Path>> shapePaths(shapes.size());
+  forEachShape(shapes.size(), m_config.threadCount, [&](size_t i) {
+    shapePaths[i] = discretizeShape(shapes[i]);
+  });
+
+  // Assemble in document order, moving rather than copying the paths
+  size_t pathCount = 0;
+  for (const auto &paths : shapePaths) {
+    pathCount += paths.size();
   }
+  allPaths.reserve(pathCount);
+
+  uint64_t points = 0;
+  for (auto &paths : shapePaths) {
+    for (auto &path : paths) {
+      points += path.size();
+      allPaths.push_back(std::move(path));
+    }
+  }
+  PipelineProfiler::count(PipelineCounter::BEZIER_SEGMENTS, segments);
+  PipelineProfiler::count(PipelineCounter::EMITTED_POINTS, points);
 
   return allPaths;
 }
 
+void Discretizer::discretizeImage(NSVGimage *image, PathSet &paths) const {
+  ScopedStageTimer timer("discretize");
+  paths.clear();
+
+  if (!image) {
+    return;
+  }
+
+  uint64_t segments = 0;
+  std::vector<NSVGshape *> shapes = collectShapes(image, segments);
+
+  // Flatten straight into the output when running serially
+  if (!useParallelShapes(shapes.size(), m_config.threadCount)) {
+    Path scratch;
+    for (NSVGshape *shape : shapes) {
+      for (NSVGpath *path = shape->paths; path != nullptr;
+           path = path->next) {
+        flattenPath(path, scratch, paths);
+      }
+    }
+    PipelineProfiler::count(PipelineCounter::BEZIER_SEGMENTS, segments);
+    PipelineProfiler::count(PipelineCounter::EMITTED_POINTS,
+                            paths.pointCount());
+    return;
+  }
+
+  // Otherwise one small set per shape, flattened through a per-shape scratch
+  // path and concatenated in document order
+  std::vector<PathSet> shapeSets(shapes.size());
+  forEachShape(shapes.size(), m_config.threadCount, [&](size_t i) {
+    Path scratch;
+    for (NSVGpath *path = shapes[i]->paths; path != nullptr;
+         path = path->next) {
+      flattenPath(path, scratch, shapeSets[i]);
+    }
+  });
+
+  size_t pathCount = 0;
+  size_t pointCount = 0;
+  for (const auto &set : shapeSets) {
+    pathCount += set.size();
+    pointCount += set.pointCount();
+  }
+  paths.reserve(pathCount, pointCount);
+  for (const auto &set : shapeSets) {
+    paths.append(set);
+  }
+
+  PipelineProfiler::count(PipelineCounter::BEZIER_SEGMENTS, segments);
+  PipelineProfiler::count(PipelineCounter::EMITTED_POINTS, pointCount);
+}
+
 }  // namespace cnc
-}  // namespace nwss
\ No newline at end of file
+}  // namespace nwss
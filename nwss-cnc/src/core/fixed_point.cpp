@@ -0,0 +1,100 @@
+#include "core/fixed_point.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace nwss {
+namespace cnc {
+
+Clipper2Lib::Path64 FixedPoint::toPath64(const PathView &path, int scale) {
+  Clipper2Lib::Path64 result;
+  result.reserve(path.size());
+  const double factor = static_cast<double>(scale);
+
+  for (size_t i = 0; i < path.size(); ++i) {
+    double x = path.x(i);
+    double y = path.y(i);
+    if (!std::isfinite(x) || !std::isfinite(y)) {
+      continue;
+    }
+    result.push_back(
+        Clipper2Lib::Point64(static_cast<int64_t>(std::round(x * factor)),
+                             static_cast<int64_t>(std::round(y * factor))));
+  }
+  return result;
+}
+
+Clipper2Lib::Path64 FixedPoint::toPath64(const Polygon &polygon, int scale) {
+  const auto &points = polygon.getPoints();
+  if (points.empty()) {
+    return Clipper2Lib::Path64();
+  }
+  return toPath64(PathView(&points[0].x, &points[0].y, points.size(), 2),
+                  scale);
+}
+
+Clipper2Lib::Paths64 FixedPoint::toPaths64(const std::vector<Path> &paths,
+                                           int scale) {
+  Clipper2Lib::Paths64 result;
+  result.reserve(paths.size());
+  for (const auto &path : paths) {
+    Clipper2Lib::Path64 converted = toPath64(path, scale);
+    if (!converted.empty()) {
+      result.push_back(std::move(converted));
+    }
+  }
+  return result;
+}
+
+Path FixedPoint::toPath(const Clipper2Lib::Path64 &path, int scale) {
+  Path result;
+  const double factor = 1.0 / static_cast<double>(scale);
+  Point2D *points = result.appendPoints(path.size());
+  for (const auto &point : path) {
+    *points++ = Point2D(static_cast<double>(point.x) * factor,
+                        static_cast<double>(point.y) * factor);
+  }
+  return result;
+}
+
+std::vector<Path> FixedPoint::toPaths(const Clipper2Lib::Paths64 &paths,
+                                      int scale) {
+  std::vector<Path> result;
+  result.reserve(paths.size());
+  for (const auto &path : paths) {
+    if (!path.empty()) {
+      result.push_back(toPath(path, scale));
+    }
+  }
+  return result;
+}
+
+Polygon FixedPoint::toPolygon(const Clipper2Lib::Path64 &path, int scale) {
+  const double factor = 1.0 / static_cast<double>(scale);
+  std::vector<Point2D> points;
+  points.reserve(path.size());
+  for (const auto &point : path) {
+    points.emplace_back(static_cast<double>(point.x) * factor,
+                        static_cast<double>(point.y) * factor);
+  }
+  return Polygon(points);
+}
+
+double FixedPoint::area(const Clipper2Lib::Path64 &path, int scale) {
+  const double factor = static_cast<double>(scale);
+  return std::fabs(Clipper2Lib::Area(path)) / (factor * factor);
+}
+
+bool FixedPoint::isClosed(const Clipper2Lib::Path64 &path, double tolerance,
+                          int scale) {
+  if (path.size() < 3) {
+    return false;
+  }
+  const double factor = 1.0 / static_cast<double>(scale);
+  double dx = static_cast<double>(path.back().x - path.front().x) * factor;
+  double dy = static_cast<double>(path.back().y - path.front().y) * factor;
+  return std::sqrt(dx * dx + dy * dy) <= tolerance;
+}
+
+}  // namespace cnc
+}  // namespace nwss
@@ -1,16 +1,85 @@
 #include "core/gcode_generator.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
-#include <iostream>
 #include <sstream>
 
+#include "core/log.h"
+#include "core/metrics.h"
 #include "core/tool_offset.h"
 
 namespace nwss {
 namespace cnc {
 
+namespace {
+
+// Most moves one G01 move is split into, so a huge move or a tiny
+// maxSegmentLength cannot overflow the count or flood the output
+const int kMaxSplitMoves = 1 << 16;
+
+// Number of equal moves that keep each no longer than maxLength
+int splitMoveCount(double length, double maxLength) {
+  double n = std::ceil(length / maxLength);
+  if (!(n < kMaxSplitMoves)) {
+    return kMaxSplitMoves;  // Also catches NaN
+  }
+  return static_cast<int>(n);
+}
+
+// Log the rapid travel saved by ordering toolpaths
+void logToolpathOrder(const ToolpathOrderReport &report) {
+  NWSS_LOG_INFO("Path ordering: rapid travel " << report.rapidBefore
+                << " -> " << report.rapidAfter << " mm ("
+                << report.reversedPaths << " paths reversed, "
+                << report.rotatedLoops << " loops re-seamed)");
+}
+
+// Forwards everything to another stream buffer while counting the bytes
+// written; used to measure G-code output size on arbitrary streams
+class CountingStreamBuf : public std::streambuf {
+ public:
+  explicit CountingStreamBuf(std::streambuf *target) : m_target(target) {
+    setp(m_buffer, m_buffer + sizeof(m_buffer));
+  }
+
+  ~CountingStreamBuf() override { flushBuffer(); }
+
+  uint64_t bytes() const { return m_bytes + (pptr() - pbase()); }
+
+ protected:
+  int overflow(int c) override {
+    if (!flushBuffer()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync() override { return flushBuffer() ? m_target->pubsync() : -1; }
+
+ private:
+  bool flushBuffer() {
+    std::streamsize pending = pptr() - pbase();
+    if (pending > 0 && m_target->sputn(pbase(), pending) != pending) {
+      return false;
+    }
+    m_bytes += static_cast<uint64_t>(pending);
+    setp(m_buffer, m_buffer + sizeof(m_buffer));
+    return true;
+  }
+
+  std::streambuf *m_target;
+  char m_buffer[4096];
+  uint64_t m_bytes = 0;
+};
+
+}  // namespace
+
 GCodeGenerator::GCodeGenerator() = default;
 GCodeGenerator::~GCodeGenerator() = default;
 
@@ -28,160 +97,209 @@ bool GCodeGenerator::generateGCode(const std::vector<Path> &paths,
                                    const std::string &outputFile) const {
   std::ofstream file(outputFile);
   if (!file.is_open()) {
-    std::cerr << "Error: Could not open file for writing: " << outputFile
-              << std::endl;
+    NWSS_LOG_ERROR("Could not open file for writing: " << outputFile);
     return false;
   }
 
+  bool written = generateGCode(paths, file);
+  file.close();
+  return written;
+}
+
+bool GCodeGenerator::generateGCode(const PathSet &paths,
+                                   const std::string &outputFile) const {
+  std::ofstream file(outputFile);
+  if (!file.is_open()) {
+    NWSS_LOG_ERROR("Could not open file for writing: " << outputFile);
+    return false;
+  }
+
+  bool written = generateGCode(paths, file);
+  file.close();
+  return written;
+}
+
+bool GCodeGenerator::generateGCode(const std::vector<Path> &paths,
+                                   std::ostream &out) const {
+  validateInput(paths);
+  std::vector<int> toolIds;
+  std::vector<Path> toolpaths = prepareToolpaths(paths, toolIds);
+  return emitProgram(out, toolpaths, toolIds);
+}
+
+bool GCodeGenerator::generateGCode(const PathSet &paths,
+                                   std::ostream &out) const {
+  if (m_options.validateFeatureSizes) {
+    validateInput(paths.toPaths());
+  }
+  if (m_options.cutoutMode != CutoutMode::PERIMETER) {
+    // Area toolpaths are written as Path objects, which keep V-carve depths
+    // and the tool of each toolpath
+    std::vector<int> toolIds;
+    std::vector<Path> toolpaths = prepareToolpaths(paths.toPaths(), toolIds);
+    return emitProgram(out, toolpaths, toolIds);
+  }
+  return emitProgram(out, preparePerimeterToolpaths(paths),
+                     std::vector<int>());
+}
+
+std::string GCodeGenerator::generateGCodeString(
+    const std::vector<Path> &paths) const {
+  std::stringstream ss;
+  std::vector<int> toolIds;
+  std::vector<Path> toolpaths = prepareToolpaths(paths, toolIds);
+  writeProgram(ss, toolpaths, toolIds);
+  std::string gcode = ss.str();
+  PipelineProfiler::count(PipelineCounter::GCODE_BYTES, gcode.size());
+  return gcode;
+}
+
+void GCodeGenerator::validateInput(const std::vector<Path> &paths) const {
   // Validate paths if enabled
   if (m_options.validateFeatureSizes) {
-    std::cout << "DEBUG: Feature size validation ENABLED" << std::endl;
+    NWSS_LOG_DEBUG("Feature size validation ENABLED");
     std::vector<std::string> warnings;
     if (!validatePaths(paths, warnings)) {
-      std::cout << "DEBUG: Feature validation found issues:" << std::endl;
-      std::cerr
-          << "Warning: Some features may be too small for the selected tool:"
-          << std::endl;
+      NWSS_LOG_DEBUG("Feature validation found issues:");
+      NWSS_LOG_WARN("Some features may be too small for the selected tool:");
       for (const auto &warning : warnings) {
-        std::cerr << "  " << warning << std::endl;
+        NWSS_LOG_WARN("  " << warning);
       }
     } else {
-      std::cout << "DEBUG: All features validated successfully" << std::endl;
+      NWSS_LOG_DEBUG("All features validated successfully");
     }
   } else {
-    std::cout << "DEBUG: Feature size validation DISABLED" << std::endl;
+    NWSS_LOG_DEBUG("Feature size validation DISABLED");
   }
+}
 
-  // Apply tool offsets if enabled
-  std::cout << "DEBUG: GCode generation - Tool offsets "
-            << (m_options.enableToolOffsets ? "ENABLED" : "DISABLED")
-            << std::endl;
-  if (m_options.enableToolOffsets) {
-    std::cout << "DEBUG: ========================================" << std::endl;
-    std::cout << "DEBUG: NEW HIGH-PRECISION OFFSET ALGORITHM" << std::endl;
-    std::cout << "DEBUG: ========================================" << std::endl;
-    std::cout << "DEBUG: Features:" << std::endl;
-    std::cout << "  - Sub-millimeter precision for detailed cuts" << std::endl;
-    std::cout << "  - Robust curve handling (not just line segments)"
-              << std::endl;
-    std::cout << "  - Topology preservation for shape integrity" << std::endl;
-    std::cout << "  - Adaptive strategies based on feature size" << std::endl;
-    std::cout << "  - Extensive quality validation" << std::endl;
-    std::cout << "DEBUG: ========================================" << std::endl;
+template <typename Paths>
+bool GCodeGenerator::emitProgram(std::ostream &out, const Paths &toolpaths,
+                                 const std::vector<int> &toolIds) const {
+  if (!PipelineProfiler::isActive()) {
+    writeProgram(out, toolpaths, toolIds);
+    return out.good();
+  }
+
+  // Route the output through a counting buffer while profiling
+  CountingStreamBuf counter(out.rdbuf());
+  std::ostream countedOut(&counter);
+  writeProgram(countedOut, toolpaths, toolIds);
+  countedOut.flush();
+  PipelineProfiler::count(PipelineCounter::GCODE_BYTES, counter.bytes());
+  if (!countedOut.good()) {
+    out.setstate(std::ios::badbit);
   }
+  return out.good();
+}
+
+std::vector<Path> GCodeGenerator::prepareToolpaths(
+    const std::vector<Path> &paths, std::vector<int> &toolIds) const {
+  ScopedStageTimer timer("toolpaths");
+
+  // Apply tool offsets if enabled
+  NWSS_LOG_DEBUG("GCode generation - Tool offsets "
+                 << (m_options.enableToolOffsets ? "ENABLED" : "DISABLED"));
   std::vector<Path> processedPaths =
       m_options.enableToolOffsets ? applyToolOffsets(paths) : paths;
 
   if (m_options.enableToolOffsets) {
-    std::cout << "DEBUG: Tool offsets applied - processed "
-              << processedPaths.size() << " paths" << std::endl;
+    NWSS_LOG_DEBUG("Tool offsets applied - processed "
+                   << processedPaths.size() << " paths");
   } else {
-    std::cout << "DEBUG: Using original paths without offsets - "
-              << paths.size() << " paths" << std::endl;
+    NWSS_LOG_DEBUG("Using original paths without offsets - " << paths.size()
+                   << " paths");
   }
 
   // Check if we need area cutting
-  std::vector<Path> finalPaths;
-  if (m_options.cutoutMode != CutoutMode::PERIMETER) {
-    std::cout << "DEBUG: Using area cutting mode: "
-              << static_cast<int>(m_options.cutoutMode) << std::endl;
-
-    // Convert paths to polygons
-    std::vector<Polygon> polygons = pathsToPolygons(processedPaths);
-    std::cout << "DEBUG: Converted " << processedPaths.size() << " paths to "
-              << polygons.size() << " polygons" << std::endl;
-
-    // Generate area cutting paths
-    finalPaths = generateAreaCuttingPaths(polygons);
-    std::cout << "DEBUG: Generated " << finalPaths.size()
-              << " area cutting paths" << std::endl;
-  } else {
-    std::cout << "DEBUG: Using perimeter cutting mode" << std::endl;
-    finalPaths = processedPaths;
+  if (m_options.cutoutMode == CutoutMode::PERIMETER) {
+    NWSS_LOG_DEBUG("Using perimeter cutting mode");
+    if (m_options.optimizePaths) {
+      orderToolpaths(processedPaths);
+    }
+    return processedPaths;
   }
 
-  // Set precision for output
-  file << std::fixed << std::setprecision(4);
+  NWSS_LOG_DEBUG("Using area cutting mode: "
+                 << static_cast<int>(m_options.cutoutMode));
 
-  // Write header
-  if (m_options.includeHeader) {
-    writeHeader(file);
-  }
+  // Convert paths to polygons
+  std::vector<Polygon> polygons = pathsToPolygons(processedPaths);
+  NWSS_LOG_DEBUG("Converted " << processedPaths.size() << " paths to "
+                 << polygons.size() << " polygons");
 
-  // Process each path
-  for (size_t pathIndex = 0; pathIndex < finalPaths.size(); pathIndex++) {
-    const auto &path = finalPaths[pathIndex];
-    if (path.empty()) continue;
+  // Generate area cutting paths
+  std::vector<Path> areaPaths = generateAreaCuttingPaths(polygons, toolIds);
+  NWSS_LOG_DEBUG("Generated " << areaPaths.size() << " area cutting paths");
+  return areaPaths;
+}
 
-    writePath(file, path, pathIndex);
+PathSet GCodeGenerator::preparePerimeterToolpaths(const PathSet &paths) const {
+  ScopedStageTimer timer("toolpaths");
+  NWSS_LOG_DEBUG("GCode generation - Tool offsets "
+                 << (m_options.enableToolOffsets ? "ENABLED" : "DISABLED"));
+  NWSS_LOG_DEBUG("Using perimeter cutting mode");
+  PathSet toolpaths =
+      m_options.enableToolOffsets ? applyToolOffsets(paths) : paths;
+  if (!m_options.optimizePaths) {
+    return toolpaths;
   }
+  return orderToolpaths(toolpaths);
+}
 
-  // Write footer
-  writeFooter(file);
-
-  file.close();
-  return true;
+void GCodeGenerator::orderToolpaths(std::vector<Path> &toolpaths) const {
+  logToolpathOrder(ToolpathOptimizer(orderOptions()).optimize(toolpaths));
 }
 
-std::string GCodeGenerator::generateGCodeString(
-    const std::vector<Path> &paths) const {
-  // Apply tool offsets if enabled
-  std::cout << "DEBUG: GCode string generation - Tool offsets "
-            << (m_options.enableToolOffsets ? "ENABLED" : "DISABLED")
-            << std::endl;
-  std::vector<Path> processedPaths =
-      m_options.enableToolOffsets ? applyToolOffsets(paths) : paths;
+PathSet GCodeGenerator::orderToolpaths(const PathSet &toolpaths) const {
+  std::vector<ToolpathOptimizer::Step> steps;
+  logToolpathOrder(
+      ToolpathOptimizer(orderOptions()).order(toolpaths, steps));
+  PathSet ordered;
+  ToolpathOptimizer::applyOrder(toolpaths, steps, ordered);
+  return ordered;
+}
 
-  if (m_options.enableToolOffsets) {
-    std::cout
-        << "DEBUG: Tool offsets applied for string generation - processed "
-        << processedPaths.size() << " paths" << std::endl;
-  } else {
-    std::cout << "DEBUG: Using original paths for string generation - "
-              << paths.size() << " paths" << std::endl;
-  }
+ToolpathOptimizer::Options GCodeGenerator::orderOptions() const {
+  // Offset contours keep the cutting direction the offset gave them; paths
+  // cut on the line may run either way. Contours inside others go first so
+  // a part is still held while its inside is cut.
+  ToolpathOptimizer::Options options;
+  options.reverseOpenPaths = !m_options.enableToolOffsets;
+  return options;
+}
 
-  // Check if we need area cutting
-  std::vector<Path> finalPaths;
-  if (m_options.cutoutMode != CutoutMode::PERIMETER) {
-    std::cout << "DEBUG: Using area cutting mode for string generation: "
-              << static_cast<int>(m_options.cutoutMode) << std::endl;
-
-    // Convert paths to polygons
-    std::vector<Polygon> polygons = pathsToPolygons(processedPaths);
-    std::cout << "DEBUG: Converted " << processedPaths.size() << " paths to "
-              << polygons.size() << " polygons" << std::endl;
-
-    // Generate area cutting paths
-    finalPaths = generateAreaCuttingPaths(polygons);
-    std::cout << "DEBUG: Generated " << finalPaths.size()
-              << " area cutting paths" << std::endl;
-  } else {
-    std::cout << "DEBUG: Using perimeter cutting mode for string generation"
-              << std::endl;
-    finalPaths = processedPaths;
-  }
+template <typename Paths>
+void GCodeGenerator::writeProgram(std::ostream &out, const Paths &toolpaths,
+                                  const std::vector<int> &toolIds) const {
+  ScopedStageTimer timer("gcode_write");
 
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(4);
+  // Set precision for output
+  out << std::fixed << std::setprecision(4);
 
   // Write header
   if (m_options.includeHeader) {
-    writeHeader(ss);
+    writeHeader(out);
   }
 
   // Process each path
-  for (size_t pathIndex = 0; pathIndex < finalPaths.size(); pathIndex++) {
-    const auto &path = finalPaths[pathIndex];
+  int currentToolId = m_options.selectedToolId;
+  for (size_t pathIndex = 0; pathIndex < toolpaths.size(); pathIndex++) {
+    PathView path = toolpaths[pathIndex];
     if (path.empty()) continue;
 
-    writePath(ss, path, pathIndex);
+    // Change tools where the toolpaths of the next tool begin
+    if (pathIndex < toolIds.size() && toolIds[pathIndex] != currentToolId) {
+      currentToolId = toolIds[pathIndex];
+      writeToolChange(out, currentToolId);
+    }
+
+    writePath(out, path, pathIndex);
+    PipelineProfiler::count(PipelineCounter::TOOLPATHS);
   }
 
   // Write footer
-  writeFooter(ss);
-
-  return ss.str();
+  writeFooter(out);
 }
 
 void GCodeGenerator::writeHeader(std::ostream &out) const {
@@ -225,30 +343,44 @@ void GCodeGenerator::writeHeader(std::ostream &out) const {
 
   // Tool selection and offset compensation
   const Tool *tool = m_toolRegistry.getTool(m_options.selectedToolId);
-  if (tool && m_options.enableToolOffsets) {
-    // Tool selection
-    out << "T" << tool->id << " M06" << std::endl;
+  if (tool) {
+    writeToolSelection(out, *tool);
+  }
 
-    // Enable tool length compensation
-    out << "G43 H" << tool->id << std::endl;
+  out << "M03 S" << spindleSpeed << std::endl;
+  out << "G00 Z" << safeHeight << std::endl << std::endl;
+}
 
-    if (m_options.includeComments) {
-      out << "( Tool: " << tool->name << ", Diameter: " << tool->diameter
-          << "mm )" << std::endl;
-      out << "( Tool offset compensation enabled )" << std::endl;
-    }
-  } else if (tool) {
-    // Tool selection without offset compensation
-    out << "T" << tool->id << " M06" << std::endl;
+void GCodeGenerator::writeToolSelection(std::ostream &out,
+                                        const Tool &tool) const {
+  out << "T" << tool.id << " M06" << std::endl;
 
-    if (m_options.includeComments) {
-      out << "( Tool: " << tool->name << ", Diameter: " << tool->diameter
-          << "mm )" << std::endl;
-      out << "( Tool offset compensation disabled )" << std::endl;
-    }
+  // Enable tool length compensation
+  if (m_options.enableToolOffsets) {
+    out << "G43 H" << tool.id << std::endl;
   }
 
-  out << "M03 S" << spindleSpeed << std::endl;
+  if (m_options.includeComments) {
+    out << "( Tool: " << tool.name << ", Diameter: " << tool.diameter
+        << "mm )" << std::endl;
+    out << "( Tool offset compensation "
+        << (m_options.enableToolOffsets ? "enabled" : "disabled") << " )"
+        << std::endl;
+  }
+}
+
+void GCodeGenerator::writeToolChange(std::ostream &out, int toolId) const {
+  const Tool *tool = m_toolRegistry.getTool(toolId);
+  if (!tool) {
+    NWSS_LOG_WARN("Tool change skipped: invalid tool ID " << toolId);
+    return;
+  }
+
+  double safeHeight = m_config.getSafeHeight();
+  out << "G00 Z" << safeHeight << std::endl;
+  out << "M05" << std::endl;
+  writeToolSelection(out, *tool);
+  out << "M03 S" << m_config.getSpindleSpeed() << std::endl;
   out << "G00 Z" << safeHeight << std::endl << std::endl;
 }
 
@@ -270,8 +402,7 @@ void GCodeGenerator::writeFooter(std::ostream &out) const {
   out << "END" << std::endl;
 }
 
-void GCodeGenerator::linearizePath(std::ostream &out,
-                                   const std::vector<Point2D> &points,
+void GCodeGenerator::linearizePath(std::ostream &out, const PathView &points,
                                    double feedRate) const {
   if (points.size() < 2) return;
 
@@ -289,8 +420,7 @@ void GCodeGenerator::linearizePath(std::ostream &out,
     }
 
     // Output the line from start to end
-    out << "G01 X" << points[lineEnd].x << " Y" << points[lineEnd].y << " F"
-        << feedRate;
+    writeLinearMove(out, points[lineStart], points[lineEnd], feedRate);
 
     // Add a comment if this is a linearized segment and comments are enabled
     if (m_options.includeComments && lineEnd > lineStart + 1) {
@@ -304,6 +434,55 @@ void GCodeGenerator::linearizePath(std::ostream &out,
   }
 }
 
+void GCodeGenerator::writeLinearMove(std::ostream &out, const Point2D &from,
+                                     const Point2D &to,
+                                     double feedRate) const {
+  if (m_options.maxSegmentLength > 0.0) {
+    int pieces =
+        splitMoveCount(from.distanceTo(to), m_options.maxSegmentLength);
+    for (int i = 1; i < pieces; i++) {
+      Point2D point = from + (to - from) * (static_cast<double>(i) / pieces);
+      out << "G01 X" << point.x << " Y" << point.y << " F" << feedRate
+          << std::endl;
+    }
+  }
+  out << "G01 X" << to.x << " Y" << to.y << " F" << feedRate;
+}
+
+void GCodeGenerator::writeCarvePath(std::ostream &out, const PathView &points,
+                                    double depthLimit, double feedRate,
+                                    double plungeRate, int pass) const {
+  auto zAt = [&](size_t i) {
+    double z = -std::min(points.depth(i), depthLimit);
+    return z == 0.0 ? 0.0 : z;  // Keep "-0.0000" out of the output
+  };
+
+  out << "G01 Z" << zAt(0) << " F" << plungeRate;
+  if (m_options.includeComments) {
+    out << "  ; Plunge to carve depth (pass " << (pass + 1) << ")";
+  }
+  out << std::endl;
+
+  for (size_t i = 1; i < points.size(); i++) {
+    Point2D from = points[i - 1];
+    Point2D to = points[i];
+    double fromZ = zAt(i - 1);
+    double toZ = zAt(i);
+    if (m_options.maxSegmentLength > 0.0) {
+      int pieces =
+          splitMoveCount(from.distanceTo(to), m_options.maxSegmentLength);
+      for (int k = 1; k < pieces; k++) {
+        double t = static_cast<double>(k) / pieces;
+        Point2D point = from + (to - from) * t;
+        out << "G01 X" << point.x << " Y" << point.y << " Z"
+            << fromZ + (toZ - fromZ) * t << " F" << feedRate << std::endl;
+      }
+    }
+    out << "G01 X" << to.x << " Y" << to.y << " Z" << toZ << " F" << feedRate
+        << std::endl;
+  }
+}
+
 bool GCodeGenerator::isCollinear(const Point2D &p1, const Point2D &p2,
                                  const Point2D &p3) const {
   // Calculate the area of the triangle formed by the three points
@@ -315,9 +494,8 @@ bool GCodeGenerator::isCollinear(const Point2D &p1, const Point2D &p2,
   return area < m_options.linearizeTolerance;
 }
 
-void GCodeGenerator::writePath(std::ostream &out, const Path &path,
+void GCodeGenerator::writePath(std::ostream &out, const PathView &points,
                                size_t pathIndex) const {
-  const auto &points = path.getPoints();
   if (points.empty()) return;
 
   // Get configuration values
@@ -347,10 +525,38 @@ void GCodeGenerator::writePath(std::ostream &out, const Path &path,
   }
   out << std::endl;
 
+  // Paths that do not end where they start (zig-zags, connected spirals)
+  // need a rapid back to the start before every further pass
+  double gapX = points[points.size() - 1].x - points[0].x;
+  double gapY = points[points.size() - 1].y - points[0].y;
+  bool endsAtStart = (m_options.closeLoops && points.size() > 2) ||
+                     std::sqrt(gapX * gapX + gapY * gapY) <= 0.001;
+
+  // V-carve paths set their own depth per point; passes only limit it
+  double deepestPoint = 0.0;
+  if (points.hasDepths()) {
+    for (size_t i = 0; i < points.size(); i++) {
+      deepestPoint = std::max(deepestPoint, points.depth(i));
+    }
+  }
+
   // Make multiple passes if needed
   for (int pass = 0; pass < passCount; pass++) {
     double depth = -cutDepth * (pass + 1);
 
+    // The previous pass already reached every point of a V-carve path
+    if (points.hasDepths() && pass > 0 && cutDepth * pass >= deepestPoint) {
+      break;
+    }
+
+    if (pass > 0 && !endsAtStart) {
+      out << "G00 X" << points[0].x << " Y" << points[0].y;
+      if (m_options.includeComments) {
+        out << "  ; Rapid back to start point";
+      }
+      out << std::endl;
+    }
+
     // Ensure we don't cut deeper than the material thickness
     if (std::abs(depth) > materialThickness) {
       depth = -materialThickness;
@@ -359,6 +565,16 @@ void GCodeGenerator::writePath(std::ostream &out, const Path &path,
       }
     }
 
+    if (points.hasDepths()) {
+      writeCarvePath(out, points, -depth, feedRate, plungeRate, pass);
+      out << "G00 Z" << safeHeight;
+      if (m_options.includeComments) {
+        out << "  ; Retract to safe height";
+      }
+      out << std::endl;
+      continue;
+    }
+
     // Plunge to depth
     out << "G01 Z" << depth << " F" << plungeRate;
     if (m_options.includeComments) {
@@ -372,8 +588,8 @@ void GCodeGenerator::writePath(std::ostream &out, const Path &path,
     } else {
       // Standard path generation (point by point)
       for (size_t i = 1; i < points.size(); i++) {
-        out << "G01 X" << points[i].x << " Y" << points[i].y << " F" << feedRate
-            << std::endl;
+        writeLinearMove(out, points[i - 1], points[i], feedRate);
+        out << std::endl;
       }
     }
 
@@ -389,7 +605,7 @@ void GCodeGenerator::writePath(std::ostream &out, const Path &path,
 
       // If the distance is significant, close the loop
       if (distance > 0.001) {
-        out << "G01 X" << first.x << " Y" << first.y << " F" << feedRate;
+        writeLinearMove(out, last, first, feedRate);
         if (m_options.includeComments) {
           out << "  ; Close loop";
         }
@@ -511,152 +727,249 @@ bool GCodeGenerator::validatePaths(const std::vector<Path> &paths,
 
 std::vector<Path> GCodeGenerator::applyToolOffsets(
     const std::vector<Path> &paths) const {
-  std::cout << "DEBUG: GCodeGenerator::applyToolOffsets() called with "
-            << paths.size() << " paths" << std::endl;
+  ScopedStageTimer timer("tool_offset");
+  NWSS_LOG_DEBUG("GCodeGenerator::applyToolOffsets() called with "
+                 << paths.size() << " paths");
 
   std::vector<Path> offsetPaths;
   offsetPaths.reserve(paths.size());
 
   // Get the selected tool
-  const Tool *tool = m_toolRegistry.getTool(m_options.selectedToolId);
-  if (!tool || tool->diameter <= 0) {
-    std::cout << "DEBUG: No valid tool selected or invalid tool diameter"
-              << std::endl;
-    if (!tool) {
-      std::cout << "  - Tool ID: " << m_options.selectedToolId
-                << " not found in registry" << std::endl;
-    } else {
-      std::cout << "  - Tool diameter: " << tool->diameter << " (invalid)"
-                << std::endl;
-    }
-    std::cout << "DEBUG: Returning original paths without offset" << std::endl;
+  const Tool *tool = selectedOffsetTool();
+  if (!tool) {
     // No valid tool selected, return original paths
     return paths;
   }
 
-  std::cout << "DEBUG: Using tool for offset calculation:" << std::endl;
-  std::cout << "  - Tool ID: " << m_options.selectedToolId << std::endl;
-  std::cout << "  - Tool diameter: " << tool->diameter << std::endl;
-  std::cout << "  - Tool name: " << tool->name << std::endl;
-  std::cout << "  - Offset direction: "
-            << static_cast<int>(m_options.offsetDirection) << std::endl;
+  if (m_options.batchToolOffsets) {
+    return applyBatchToolOffsets(paths, *tool);
+  }
 
   // Apply offset to each path
   for (size_t pathIndex = 0; pathIndex < paths.size(); ++pathIndex) {
     const auto &path = paths[pathIndex];
 
-    std::cout << "DEBUG: Processing path " << pathIndex << " of "
-              << paths.size() << std::endl;
+    NWSS_LOG_DEBUG("Processing path " << pathIndex << " of " << paths.size());
 
+    Path offsetPath;
     if (path.empty()) {
-      std::cout << "  - Path is empty, keeping original" << std::endl;
+      NWSS_LOG_DEBUG("  - Path is empty, keeping original");
+      offsetPaths.push_back(path);
+    } else if (offsetToolpath(path, pathIndex, *tool, offsetPath)) {
+      offsetPaths.push_back(std::move(offsetPath));
+    } else {
       offsetPaths.push_back(path);
-      continue;
     }
 
-    const auto &originalPoints = path.getPoints();
-    std::cout << "  - Original path has " << originalPoints.size() << " points"
-              << std::endl;
+    NWSS_LOG_DEBUG("  - Path " << pathIndex << " processing complete");
+  }
+
+  NWSS_LOG_DEBUG("GCodeGenerator::applyToolOffsets() completed");
+  NWSS_LOG_DEBUG("  - Input paths: " << paths.size());
+  NWSS_LOG_DEBUG("  - Output paths: " << offsetPaths.size());
+
+  return offsetPaths;
+}
+
+PathSet GCodeGenerator::applyToolOffsets(const PathSet &paths) const {
+  ScopedStageTimer timer("tool_offset");
+  NWSS_LOG_DEBUG("GCodeGenerator::applyToolOffsets() called with "
+                 << paths.size() << " paths");
 
-    // Print first few points of original path for reference
-    std::cout << "  - First few original points:" << std::endl;
-    for (size_t i = 0; i < std::min<size_t>(3, originalPoints.size()); ++i) {
-      std::cout << "    [" << i << "] (" << originalPoints[i].x << ", "
-                << originalPoints[i].y << ")" << std::endl;
+  const Tool *tool = selectedOffsetTool();
+  if (!tool) {
+    return paths;
+  }
+
+  if (m_options.batchToolOffsets) {
+    return PathSet(applyBatchToolOffsets(paths.toPaths(), *tool));
+  }
+
+  PathSet offsetPaths;
+  offsetPaths.reserve(paths.size(), paths.pointCount());
+  Path offsetPath;
+  for (size_t pathIndex = 0; pathIndex < paths.size(); ++pathIndex) {
+    PathView path = paths[pathIndex];
+    if (!path.empty() && offsetToolpath(path, pathIndex, *tool, offsetPath)) {
+      offsetPaths.addPath(offsetPath);
+    } else {
+      offsetPaths.addPath(path);
     }
+  }
 
-    // Calculate offset path using new robust algorithm
-    std::cout << "  - Calling new ToolOffset::calculateToolOffset for path "
-              << pathIndex << std::endl;
+  NWSS_LOG_DEBUG("GCodeGenerator::applyToolOffsets() completed - "
+                 << offsetPaths.size() << " paths");
+  return offsetPaths;
+}
 
-    ToolOffset::OffsetOptions options;
-    options.minFeatureSize = 0.01;  // 0.01mm minimum feature size
-    options.validateResults = true;
-    options.precision = 0.001;  // High precision
+std::vector<Path> GCodeGenerator::applyBatchToolOffsets(
+    const std::vector<Path> &paths, const Tool &tool) const {
+  ToolOffset::OffsetOptions options;
+  options.minFeatureSize = 0.01;  // 0.01mm minimum feature size
+  options.validateResults = false;
+  options.precision = 0.001;  // High precision
+
+  ToolOffset::BatchOffsetResult offsetResult =
+      ToolOffset::calculateBatchToolOffset(paths, tool.diameter,
+                                           m_options.offsetDirection, options);
+  if (!offsetResult.success) {
+    for (const auto &error : offsetResult.errors) {
+      NWSS_LOG_DEBUG("  ERROR: " << error);
+    }
+    NWSS_LOG_DEBUG("Batch offset failed, using original paths");
+    return paths;
+  }
+  for (const auto &warning : offsetResult.warnings) {
+    NWSS_LOG_DEBUG("  WARNING: " << warning);
+  }
 
-    auto offsetResult = ToolOffset::calculateToolOffset(
-        path, tool->diameter, m_options.offsetDirection, options);
+  // Group the rings by source path, keeping the order within each source
+  std::vector<size_t> ringStart(paths.size() + 1, 0);
+  for (size_t source : offsetResult.sourceIndex) {
+    ++ringStart[source + 1];
+  }
+  for (size_t i = 1; i < ringStart.size(); ++i) {
+    ringStart[i] += ringStart[i - 1];
+  }
+  std::vector<size_t> ringOrder(offsetResult.paths.size());
+  std::vector<size_t> nextRing(ringStart.begin(), ringStart.end() - 1);
+  for (size_t ring = 0; ring < offsetResult.paths.size(); ++ring) {
+    ringOrder[nextRing[offsetResult.sourceIndex[ring]]++] = ring;
+  }
 
-    Path offsetPath;
-    if (offsetResult.success && !offsetResult.paths.empty()) {
-      offsetPath = offsetResult.paths[0];  // Use first result path
-
-      // Log detailed results
-      std::cout << "  - Offset result: SUCCESS" << std::endl;
-      std::cout << "    - Result paths: " << offsetResult.paths.size()
-                << std::endl;
-      std::cout << "    - Warnings: " << offsetResult.warnings.size()
-                << std::endl;
-      std::cout << "    - Errors: " << offsetResult.errors.size() << std::endl;
-      std::cout << "    - Actual offset: " << offsetResult.actualOffsetDistance
-                << "mm" << std::endl;
-
-      for (const auto &warning : offsetResult.warnings) {
-        std::cout << "    WARNING: " << warning << std::endl;
+  std::vector<Path> offsetPaths;
+  offsetPaths.reserve(std::max(paths.size(), offsetResult.paths.size()));
+  size_t merged = 0;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (ringStart[i] < ringStart[i + 1]) {
+      for (size_t k = ringStart[i]; k < ringStart[i + 1]; ++k) {
+        offsetPaths.push_back(std::move(offsetResult.paths[ringOrder[k]]));
       }
+    } else if (offsetResult.mergedInto[i] >= 0) {
+      ++merged;
     } else {
-      std::cout << "  - Offset result: FAILED" << std::endl;
-      for (const auto &error : offsetResult.errors) {
-        std::cout << "    ERROR: " << error << std::endl;
-      }
+      offsetPaths.push_back(paths[i]);
     }
+  }
 
-    // If offset failed, use original path
-    if (offsetPath.empty()) {
-      std::cout << "  - Offset calculation failed for path " << pathIndex
-                << ", using original path" << std::endl;
-      offsetPaths.push_back(path);
+  NWSS_LOG_DEBUG("Batch offset: " << paths.size() << " paths -> "
+                 << offsetPaths.size() << " toolpaths (" << merged
+                 << " merged into neighbours)");
+  return offsetPaths;
+}
+
+const Tool *GCodeGenerator::selectedOffsetTool() const {
+  const Tool *tool = m_toolRegistry.getTool(m_options.selectedToolId);
+  if (!tool || tool->diameter <= 0) {
+    NWSS_LOG_DEBUG("No valid tool selected or invalid tool diameter");
+    if (!tool) {
+      NWSS_LOG_DEBUG("  - Tool ID: " << m_options.selectedToolId
+                     << " not found in registry");
     } else {
-      const auto &offsetPoints = offsetPath.getPoints();
-      std::cout << "  - Offset calculation successful for path " << pathIndex
-                << std::endl;
-      std::cout << "    - Offset path has " << offsetPoints.size() << " points"
-                << std::endl;
-
-      // Print first few points of offset path for comparison
-      std::cout << "    - First few offset points:" << std::endl;
-      for (size_t i = 0; i < std::min<size_t>(3, offsetPoints.size()); ++i) {
-        std::cout << "      [" << i << "] (" << offsetPoints[i].x << ", "
-                  << offsetPoints[i].y << ")" << std::endl;
-      }
+      NWSS_LOG_DEBUG("  - Tool diameter: " << tool->diameter << " (invalid)");
+    }
+    NWSS_LOG_DEBUG("Returning original paths without offset");
+    return nullptr;
+  }
 
-      // Use the actual offset from the ToolOffset result instead of manual
-      // calculation
-      double actualOffset = offsetResult.actualOffsetDistance;
-      double expectedOffset = tool->diameter / 2.0;
-      std::cout << "    - Actual offset distance: " << actualOffset
-                << std::endl;
-      std::cout << "    - Expected offset distance: " << expectedOffset
-                << std::endl;
-
-      // Safety check: if offset is way off, use original path instead
-      double accuracyRatio = std::abs(actualOffset) / expectedOffset;
-      if (accuracyRatio > 2.0 || accuracyRatio < 0.5) {
-        std::cout << "    - Offset accuracy: FAILED (ratio: " << accuracyRatio
-                  << ") - USING ORIGINAL PATH" << std::endl;
-        offsetPaths.push_back(path);  // Use original path instead
-      } else {
-        if (std::abs(actualOffset - expectedOffset) < 0.01) {
-          std::cout << "    - Offset accuracy: EXCELLENT" << std::endl;
-        } else if (std::abs(actualOffset - expectedOffset) < 0.1) {
-          std::cout << "    - Offset accuracy: GOOD" << std::endl;
-        } else {
-          std::cout << "    - Offset accuracy: ACCEPTABLE" << std::endl;
-        }
-        offsetPaths.push_back(offsetPath);  // Use offset path
-      }
+  NWSS_LOG_DEBUG("Using tool for offset calculation:");
+  NWSS_LOG_DEBUG("  - Tool ID: " << m_options.selectedToolId);
+  NWSS_LOG_DEBUG("  - Tool diameter: " << tool->diameter);
+  NWSS_LOG_DEBUG("  - Tool name: " << tool->name);
+  NWSS_LOG_DEBUG("  - Offset direction: "
+                 << static_cast<int>(m_options.offsetDirection));
+  return tool;
+}
+
+bool GCodeGenerator::offsetToolpath(const PathView &path, size_t pathIndex,
+                                    const Tool &tool, Path &offsetPath) const {
+  NWSS_LOG_DEBUG("  - Original path has " << path.size() << " points");
+
+  // Print first few points of original path for reference
+  NWSS_LOG_DEBUG("  - First few original points:");
+  for (size_t i = 0; i < std::min<size_t>(3, path.size()); ++i) {
+    NWSS_LOG_DEBUG("    [" << i << "] (" << path.x(i) << ", " << path.y(i)
+                   << ")");
+  }
+
+  // Calculate offset path using new robust algorithm
+  NWSS_LOG_DEBUG("  - Calling new ToolOffset::calculateToolOffset for path "
+                 << pathIndex);
+
+  ToolOffset::OffsetOptions options;
+  options.minFeatureSize = 0.01;  // 0.01mm minimum feature size
+  options.validateResults = true;
+  options.precision = 0.001;  // High precision
+
+  auto offsetResult = ToolOffset::calculateToolOffset(
+      path, tool.diameter, m_options.offsetDirection, options);
+
+  offsetPath.clear();
+  if (offsetResult.success && !offsetResult.paths.empty()) {
+    offsetPath = offsetResult.paths[0];  // Use first result path
+
+    // Log detailed results
+    NWSS_LOG_DEBUG("  - Offset result: SUCCESS");
+    NWSS_LOG_DEBUG("    - Result paths: " << offsetResult.paths.size());
+    NWSS_LOG_DEBUG("    - Warnings: " << offsetResult.warnings.size());
+    NWSS_LOG_DEBUG("    - Errors: " << offsetResult.errors.size());
+    NWSS_LOG_DEBUG("    - Actual offset: "
+                   << offsetResult.actualOffsetDistance << "mm (min "
+                   << offsetResult.quality.minDistance << ", max "
+                   << offsetResult.quality.maxDistance << ", max deviation "
+                   << offsetResult.quality.maxDeviation << ")");
+
+    for (const auto &warning : offsetResult.warnings) {
+      NWSS_LOG_DEBUG("    WARNING: " << warning);
     }
+  } else {
+    NWSS_LOG_DEBUG("  - Offset result: FAILED");
+    for (const auto &error : offsetResult.errors) {
+      NWSS_LOG_DEBUG("    ERROR: " << error);
+    }
+  }
 
-    std::cout << "  - Path " << pathIndex << " processing complete"
-              << std::endl;
+  // If offset failed, use original path
+  if (offsetPath.empty()) {
+    NWSS_LOG_DEBUG("  - Offset calculation failed for path " << pathIndex
+                   << ", using original path");
+    return false;
   }
 
-  std::cout << "DEBUG: GCodeGenerator::applyToolOffsets() completed"
-            << std::endl;
-  std::cout << "  - Input paths: " << paths.size() << std::endl;
-  std::cout << "  - Output paths: " << offsetPaths.size() << std::endl;
+  const auto &offsetPoints = offsetPath.getPoints();
+  NWSS_LOG_DEBUG("  - Offset calculation successful for path " << pathIndex);
+  NWSS_LOG_DEBUG("    - Offset path has " << offsetPoints.size() << " points");
 
-  return offsetPaths;
+  // Print first few points of offset path for comparison
+  NWSS_LOG_DEBUG("    - First few offset points:");
+  for (size_t i = 0; i < std::min<size_t>(3, offsetPoints.size()); ++i) {
+    NWSS_LOG_DEBUG("      [" << i << "] (" << offsetPoints[i].x << ", "
+                   << offsetPoints[i].y << ")");
+  }
+
+  // Use the actual offset from the ToolOffset result instead of manual
+  // calculation
+  double actualOffset = offsetResult.actualOffsetDistance;
+  double expectedOffset = tool.diameter / 2.0;
+  NWSS_LOG_DEBUG("    - Actual offset distance: " << actualOffset);
+  NWSS_LOG_DEBUG("    - Expected offset distance: " << expectedOffset);
+
+  // Safety check: if offset is way off, use original path instead
+  double accuracyRatio = std::abs(actualOffset) / expectedOffset;
+  if (accuracyRatio > 2.0 || accuracyRatio < 0.5) {
+    NWSS_LOG_DEBUG("    - Offset accuracy: FAILED (ratio: "
+                   << accuracyRatio << ") - USING ORIGINAL PATH");
+    return false;
+  }
+
+  if (std::abs(actualOffset - expectedOffset) < 0.01) {
+    NWSS_LOG_DEBUG("    - Offset accuracy: EXCELLENT");
+  } else if (std::abs(actualOffset - expectedOffset) < 0.1) {
+    NWSS_LOG_DEBUG("    - Offset accuracy: GOOD");
+  } else {
+    NWSS_LOG_DEBUG("    - Offset accuracy: ACCEPTABLE");
+  }
+  return true;
 }
 
 std::vector<Polygon> GCodeGenerator::pathsToPolygons(
@@ -690,7 +1003,7 @@ std::vector<Polygon> GCodeGenerator::pathsToPolygons(
 }
 
 std::vector<Path> GCodeGenerator::generateAreaCuttingPaths(
-    const std::vector<Polygon> &polygons) const {
+    const std::vector<Polygon> &polygons, std::vector<int> &toolIds) const {
   std::vector<Path> areaPaths;
 
   // Create cutout parameters from options
@@ -700,6 +1013,8 @@ std::vector<Path> GCodeGenerator::generateAreaCuttingPaths(
   cutoutParams.overlap = m_options.overlap;
   cutoutParams.spiralIn = m_options.spiralIn;
   cutoutParams.maxStepover = m_options.maxStepover;
+  cutoutParams.threadCount = m_options.threadCount;
+  cutoutParams.restToolId = m_options.restToolId;
 
   // Get the selected tool
   const Tool *tool = m_toolRegistry.getTool(m_options.selectedToolId);
@@ -726,6 +1041,10 @@ std::vector<Path> GCodeGenerator::generateAreaCuttingPaths(
   // TODO: Handle warnings and errors from result
   if (result.success) {
     areaPaths = result.toolpaths;
+    toolIds = result.toolpathToolIds;
+    NWSS_LOG_DEBUG("Area toolpath rapid travel: " << result.rapidDistance
+                   << " mm (" << result.rapidDistanceSaved
+                   << " mm saved by ordering)");
   }
 
   return areaPaths;
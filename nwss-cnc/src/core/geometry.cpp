@@ -6,9 +6,25 @@
 namespace nwss {
 namespace cnc {
 
+void AffineTransform::apply(double *xs, double *ys, size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    double x = xs[i];
+    double y = ys[i];
+    xs[i] = a * x + b * y + tx;
+    ys[i] = c * x + d * y + ty;
+  }
+}
+
+void Path::transform(const AffineTransform &transform) {
+  for (Point2D &point : m_points) {
+    point = transform.apply(point);
+  }
+  m_hasLength = false;
+}
+
 double Path::length() const {
-  if (m_points.size() < 2) {
-    return 0.0;
+  if (m_hasLength) {
+    return m_length;
   }
 
   double totalLength = 0.0;
@@ -16,11 +32,13 @@ double Path::length() const {
     totalLength += m_points[i - 1].distanceTo(m_points[i]);
   }
 
+  m_length = totalLength;
+  m_hasLength = true;
   return totalLength;
 }
 
 Path Path::simplify(double tolerance) const {
-  if (m_points.size() < 3 || tolerance <= 0.0) {
+  if (m_points.size() < 3 || tolerance <= 0.0 || hasDepths()) {
     return *this;
   }
 
@@ -106,60 +124,72 @@ bool Polygon::containsPoint(const Point2D &point) const {
   return inside;
 }
 
-double Polygon::area() const {
+void Polygon::computeArea() const {
+  m_area = 0.0;
+  m_clockwise = false;
+  m_hasArea = true;
   if (m_points.size() < 3) {
-    return 0.0;
+    return;
   }
 
-  // Shoelace formula
+  // Shoelace formula, and the signed area with the opposite sign for the
+  // orientation
   double area = 0.0;
+  double signedArea = 0.0;
   size_t j = m_points.size() - 1;
 
   for (size_t i = 0; i < m_points.size(); i++) {
     area += (m_points[j].x + m_points[i].x) * (m_points[j].y - m_points[i].y);
+    signedArea +=
+        (m_points[j].x - m_points[i].x) * (m_points[j].y + m_points[i].y);
     j = i;
   }
 
-  return std::abs(area) / 2.0;
+  m_area = std::abs(area) / 2.0;
+  // Positive area = clockwise in screen coordinates
+  m_clockwise = signedArea > 0;
 }
 
-bool Polygon::isClockwise() const {
-  if (m_points.size() < 3) {
-    return false;
+double Polygon::area() const {
+  if (!m_hasArea) {
+    computeArea();
   }
+  return m_area;
+}
 
-  // Calculate signed area using shoelace formula
-  double signedArea = 0.0;
-  size_t j = m_points.size() - 1;
-
-  for (size_t i = 0; i < m_points.size(); i++) {
-    signedArea +=
-        (m_points[j].x - m_points[i].x) * (m_points[j].y + m_points[i].y);
-    j = i;
+bool Polygon::isClockwise() const {
+  if (!m_hasArea) {
+    computeArea();
   }
-
-  // Positive area = clockwise in screen coordinates
-  return signedArea > 0;
+  return m_clockwise;
 }
 
-void Polygon::reverse() { std::reverse(m_points.begin(), m_points.end()); }
+void Polygon::reverse() {
+  std::reverse(m_points.begin(), m_points.end());
+  invalidate();
+}
 
 void Polygon::getBounds(double &minX, double &minY, double &maxX,
                         double &maxY) const {
-  if (m_points.empty()) {
-    minX = minY = maxX = maxY = 0.0;
-    return;
+  if (!m_hasBounds) {
+    m_minX = m_minY = m_maxX = m_maxY = 0.0;
+    if (!m_points.empty()) {
+      m_minX = m_maxX = m_points[0].x;
+      m_minY = m_maxY = m_points[0].y;
+    }
+    for (const auto &point : m_points) {
+      m_minX = std::min(m_minX, point.x);
+      m_minY = std::min(m_minY, point.y);
+      m_maxX = std::max(m_maxX, point.x);
+      m_maxY = std::max(m_maxY, point.y);
+    }
+    m_hasBounds = true;
   }
 
-  minX = maxX = m_points[0].x;
-  minY = maxY = m_points[0].y;
-
-  for (const auto &point : m_points) {
-    minX = std::min(minX, point.x);
-    minY = std::min(minY, point.y);
-    maxX = std::max(maxX, point.x);
-    maxY = std::max(maxY, point.y);
-  }
+  minX = m_minX;
+  minY = m_minY;
+  maxX = m_maxX;
+  maxY = m_maxY;
 }
 
 }  // namespace cnc
@@ -0,0 +1,73 @@
+#include "core/log.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+std::atomic<LogLevel> g_level{LogLevel::INFO};
+
+std::mutex &sinkMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+Log::Sink &currentSink() {
+  static Log::Sink sink;
+  return sink;
+}
+
+}  // namespace
+
+void Log::setLevel(LogLevel level) { g_level.store(level); }
+
+LogLevel Log::getLevel() { return g_level.load(); }
+
+bool Log::isEnabled(LogLevel level) {
+  LogLevel current = g_level.load(std::memory_order_relaxed);
+  return level != LogLevel::OFF && current != LogLevel::OFF &&
+         static_cast<int>(level) >= static_cast<int>(current);
+}
+
+void Log::setSink(Sink sink) {
+  std::lock_guard<std::mutex> lock(sinkMutex());
+  currentSink() = std::move(sink);
+}
+
+void Log::write(LogLevel level, const std::string &message) {
+  if (!isEnabled(level)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(sinkMutex());
+  if (currentSink()) {
+    currentSink()(level, message);
+    return;
+  }
+
+  // Default sink: never write to std::cout, which may carry G-code output
+  std::cerr << levelName(level) << ": " << message << '\n';
+}
+
+const char *Log::levelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::DEBUG:
+      return "Debug";
+    case LogLevel::INFO:
+      return "Info";
+    case LogLevel::WARN:
+      return "Warning";
+    case LogLevel::ERR:
+      return "Error";
+    case LogLevel::OFF:
+      break;
+  }
+  return "";
+}
+
+}  // namespace cnc
+}  // namespace nwss
@@ -0,0 +1,687 @@
+#define _USE_MATH_DEFINES
+#include "core/medial_axis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/thread_pool.h"
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// Walls closer than this to a sample (mm) pass through it
+const double kTouchTolerance = 1e-7;
+
+// Turns smaller than this (radians) leave a vertex flat
+const double kFlatTurn = 1e-6;
+
+// Shrinking stops after this many steps; it normally settles in a few
+const int kMaxShrinkSteps = 64;
+
+// Samples fitted per thread pool task
+const size_t kSamplesPerTask = 256;
+
+// Grid cells are this many average edge lengths wide. Disc queries reach
+// about half a feature width from the boundary, usually more than one edge
+// length, so cells wider than the segment grid's default mean fewer empty
+// cells to walk past.
+const double kCellsPerEdge = 2.0;
+
+// Contacts this close to the end of a wall edge (as a fraction of its
+// length) touch its corner rather than the edge
+const double kCornerFraction = 1e-6;
+
+// Steps of the search for the closest approach of a wall to a sweep of
+// discs, each narrowing it to two thirds
+const int kSweepSearchSteps = 40;
+
+// No wall segment
+const size_t kNoSegment = std::numeric_limits<size_t>::max();
+
+// Signed area of a ring (positive when counter-clockwise)
+double signedArea(const Point2D *points, size_t count) {
+  double area = 0.0;
+  size_t j = count - 1;
+  for (size_t i = 0; i < count; j = i++) {
+    area += points[j].x * points[i].y - points[i].x * points[j].y;
+  }
+  return area / 2.0;
+}
+
+double dot(const Point2D &a, const Point2D &b) {
+  return a.x * b.x + a.y * b.y;
+}
+
+// Closest point to p on the segment from a to b
+Point2D closestPoint(const Point2D &p, const Point2D &a, const Point2D &b) {
+  Point2D ab = b - a;
+  double lengthSquared = dot(ab, ab);
+  if (lengthSquared == 0.0) {
+    return a;
+  }
+  double t = std::max(0.0, std::min(1.0, dot(p - a, ab) / lengthSquared));
+  return a + ab * t;
+}
+
+// Radius of the smallest disc tangent at p (centre along the unit normal n)
+// that reaches the segment from a to b, and the point where it does; the
+// disc touches either an end point or the segment's line. Infinite if the
+// segment is not ahead of p.
+double tangentRadius(const Point2D &p, const Point2D &n, const Point2D &a,
+                     const Point2D &b, Point2D &touch) {
+  double radius = std::numeric_limits<double>::infinity();
+  for (const Point2D *end : {&a, &b}) {
+    Point2D offset = *end - p;
+    double along = dot(n, offset);
+    if (along > 0.0 && dot(offset, offset) / (2.0 * along) < radius) {
+      radius = dot(offset, offset) / (2.0 * along);
+      touch = *end;
+    }
+  }
+
+  // Tangent to the line: the centre is as far from it as from p
+  Point2D ab = b - a;
+  double lengthSquared = dot(ab, ab);
+  if (lengthSquared > 0.0) {
+    Point2D m = Point2D(-ab.y, ab.x) * (1.0 / std::sqrt(lengthSquared));
+    double distance = dot(m, p - a);
+    if (distance < 0.0) {
+      m = m * -1.0;
+      distance = -distance;
+    }
+    double closing = 1.0 - dot(m, n);
+    if (distance > 0.0 && closing > 0.0 && distance / closing < radius) {
+      double tangent = distance / closing;
+      Point2D q = p + n * tangent - m * tangent;
+      double t = dot(q - a, ab) / lengthSquared;
+      if (t > 0.0 && t < 1.0) {
+        radius = tangent;
+        touch = q;
+      }
+    }
+  }
+  return radius;
+}
+
+// Rotate a vector counter-clockwise by an angle in radians
+Point2D rotate(const Point2D &v, double angle) {
+  double c = std::cos(angle);
+  double s = std::sin(angle);
+  return Point2D(v.x * c - v.y * s, v.x * s + v.y * c);
+}
+
+// Cross product of two vectors (positive when b turns counter-clockwise
+// from a)
+double cross(const Point2D &a, const Point2D &b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+// Distance between the segments from a to b and from c to d (0 where they
+// cross)
+double segmentDistance(const Point2D &a, const Point2D &b, const Point2D &c,
+                       const Point2D &d) {
+  double c1 = cross(b - a, c - a);
+  double c2 = cross(b - a, d - a);
+  double c3 = cross(d - c, a - c);
+  double c4 = cross(d - c, b - c);
+  if (((c1 < 0.0 && c2 > 0.0) || (c1 > 0.0 && c2 < 0.0)) &&
+      ((c3 < 0.0 && c4 > 0.0) || (c3 > 0.0 && c4 < 0.0))) {
+    return 0.0;
+  }
+  return std::min({SegmentGrid::pointSegmentDistance(a, c, d),
+                   SegmentGrid::pointSegmentDistance(b, c, d),
+                   SegmentGrid::pointSegmentDistance(c, a, b),
+                   SegmentGrid::pointSegmentDistance(d, a, b)});
+}
+
+// Whether the segment from a to b enters the triangle with its apex at p
+// that opens along the unit normal n with the given half width per unit of
+// height, between heights near and far
+bool segmentEntersCone(const Point2D &p, const Point2D &n, double slope,
+                       double near, double far, const Point2D &a,
+                       const Point2D &b) {
+  // Clip the segment against each side of the triangle in turn
+  Point2D tangent(-n.y, n.x);
+  Point2D da = a - p;
+  Point2D db = b - p;
+  double xa = dot(da, tangent), ya = dot(da, n);
+  double xb = dot(db, tangent), yb = dot(db, n);
+  double start = 0.0, end = 1.0;
+  auto clip = [&](double va, double vb) {
+    // Keep the part where va + (vb - va) * s <= 0
+    if (va > 0.0 && vb > 0.0) {
+      return false;
+    }
+    if (va > 0.0) {
+      start = std::max(start, va / (va - vb));
+    } else if (vb > 0.0) {
+      end = std::min(end, va / (va - vb));
+    }
+    return start <= end;
+  };
+  return clip(near - ya, near - yb) && clip(ya - far, yb - far) &&
+         clip(xa - slope * ya, xb - slope * yb) &&
+         clip(-xa - slope * ya, -xb - slope * yb);
+}
+
+}  // namespace
+
+bool MedialAxis::compute(const std::vector<Path> &rings) {
+  if (rings.empty() || rings[0].size() < 3) {
+    m_grid.clear();
+    m_balls.clear();
+    return false;
+  }
+  std::vector<PathView> views(rings.begin(), rings.end());
+  std::vector<char> holes(rings.size(), 1);
+  holes[0] = 0;
+  return compute(views, holes);
+}
+
+bool MedialAxis::compute(const std::vector<PathView> &rings,
+                         const std::vector<char> &holes) {
+  std::vector<Sample> samples;
+  std::vector<size_t> sampleStart;
+  if (!prepare(rings, holes, samples, sampleStart)) {
+    return false;
+  }
+
+  // Each task fits a stretch of samples into its own discs; kept[j] is the
+  // number of discs sample j (with its run along the edge) kept
+  std::vector<size_t> taskStart(1, 0);
+  std::vector<size_t> taskSamples(1, 0);
+  for (size_t j = 0; j < samples.size(); ++j) {
+    if (taskSamples.back() >= kSamplesPerTask) {
+      taskStart.push_back(j);
+      taskSamples.push_back(0);
+    }
+    taskSamples.back() += samples[j].run;
+  }
+  taskStart.push_back(samples.size());
+  size_t taskCount = taskStart.size() - 1;
+
+  std::vector<std::vector<MedialBall>> taskBalls(taskCount);
+  std::vector<size_t> kept(samples.size(), 0);
+  auto fitTask = [&](size_t task) {
+    std::vector<MedialBall> &out = taskBalls[task];
+    out.reserve(taskSamples[task]);
+    std::vector<size_t> nearby;
+    size_t hint = kNoSegment;
+    for (size_t j = taskStart[task]; j < taskStart[task + 1]; ++j) {
+      const Sample &sample = samples[j];
+      size_t begin = out.size();
+      out.push_back(fitBall(sample, 0, hint));
+      if (sample.run == 1) {
+        kept[j] = 1;
+        continue;
+      }
+      MedialBall last = fitBall(sample, sample.run - 1, hint);
+
+      // Discs in between touching the same wall edge as both ends lie on
+      // the straight bisector of the two edges, unless another wall reaches
+      // into them
+      const MedialBall &first = out[begin];
+      bool bisector = first.touchesEdge && last.touchesEdge &&
+                      first.contactRing == last.contactRing &&
+                      first.contactEdge == last.contactEdge &&
+                      sweepIsClear(sample, first, last, nearby);
+      if (!bisector) {
+        for (size_t k = 1; k + 1 < sample.run; ++k) {
+          out.push_back(fitBall(sample, k, hint));
+        }
+      }
+      out.push_back(last);
+      kept[j] = out.size() - begin;
+    }
+  };
+  size_t threads = ThreadPool::resolveThreadCount(m_options.threadCount);
+  if (threads > 1 && taskCount > 1) {
+    ThreadPool::shared().parallelFor(taskCount, threads, fitTask);
+  } else {
+    for (size_t task = 0; task < taskCount; ++task) {
+      fitTask(task);
+    }
+  }
+
+  // The tasks' discs in sample order, split into rings
+  m_balls.resize(rings.size());
+  size_t task = 0;
+  size_t next = 0;
+  for (size_t i = 0; i < rings.size(); ++i) {
+    size_t count = 0;
+    for (size_t j = sampleStart[i]; j < sampleStart[i + 1]; ++j) {
+      count += kept[j];
+    }
+    m_balls[i].reserve(count);
+    while (m_balls[i].size() < count) {
+      if (next == taskBalls[task].size()) {
+        std::vector<MedialBall>().swap(taskBalls[task]);
+        ++task;
+        next = 0;
+        continue;
+      }
+      m_balls[i].push_back(taskBalls[task][next++]);
+    }
+  }
+
+  // Where three walls meet, the discs of the wall a disc touches may touch
+  // a third wall instead; the disc is then only left out if they touch its
+  // own wall too
+  for (size_t i = 0; i < m_balls.size(); ++i) {
+    for (auto &ball : m_balls[i]) {
+      if (!ball.duplicate) {
+        continue;
+      }
+      const auto &other = m_balls[ball.contactRing];
+      auto begin = std::lower_bound(
+          other.begin(), other.end(), ball.contactEdge,
+          [](const MedialBall &b, size_t edge) { return b.edge < edge; });
+      ball.duplicate = false;
+      for (auto it = begin; it != other.end() && it->edge == ball.contactEdge;
+           ++it) {
+        if (it->contactRing == i && it->contactEdge == ball.edge) {
+          ball.duplicate = true;
+          break;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool MedialAxis::prepare(const std::vector<PathView> &rings,
+                         const std::vector<char> &holes,
+                         std::vector<Sample> &samples,
+                         std::vector<size_t> &sampleStart) {
+  m_grid.clear();
+  m_balls.clear();
+
+  // Drop repeated points, including a closing copy of the first, so edge
+  // indices match between the grid and the samples
+  std::vector<Point2D> points;
+  std::vector<size_t> ringStart(rings.size() + 1, 0);
+  for (size_t i = 0; i < rings.size(); ++i) {
+    size_t first = points.size();
+    for (const auto &point : rings[i]) {
+      if (points.size() == first ||
+          point.distanceTo(points.back()) > kTouchTolerance) {
+        points.push_back(point);
+      }
+    }
+    while (points.size() > first + 1 &&
+           points.back().distanceTo(points[first]) <= kTouchTolerance) {
+      points.pop_back();
+    }
+    if (points.size() - first < 3) {
+      points.resize(first);
+    }
+    ringStart[i + 1] = points.size();
+  }
+  if (points.empty()) {
+    return false;
+  }
+
+  double minX = std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  double maxY = std::numeric_limits<double>::lowest();
+  double perimeter = 0.0;
+  m_ringSegments.assign(rings.size() + 1, 0);
+  for (size_t i = 0; i < rings.size(); ++i) {
+    size_t count = ringStart[i + 1] - ringStart[i];
+    m_ringSegments[i + 1] = m_grid.size();
+    if (count == 0) continue;
+    const Point2D *ring = &points[ringStart[i]];
+    m_grid.addPath(PathView(&ring[0].x, &ring[0].y, count, 2), i, true);
+    m_ringSegments[i + 1] = m_grid.size();
+    for (size_t k = 0; k < count; ++k) {
+      minX = std::min(minX, ring[k].x);
+      minY = std::min(minY, ring[k].y);
+      maxX = std::max(maxX, ring[k].x);
+      maxY = std::max(maxY, ring[k].y);
+      perimeter += ring[k].distanceTo(ring[(k + 1) % count]);
+    }
+  }
+  m_grid.build(kCellsPerEdge * perimeter / m_grid.size());
+  m_maxRadius = std::hypot(maxX - minX, maxY - minY);
+
+  // Outlines have the region inside them, holes have it outside
+  samples.reserve(2 * points.size());
+  sampleStart.assign(rings.size() + 1, 0);
+  for (size_t i = 0; i < rings.size(); ++i) {
+    size_t count = ringStart[i + 1] - ringStart[i];
+    if (count > 0) {
+      const Point2D *ring = &points[ringStart[i]];
+      bool counterClockwise = signedArea(ring, count) > 0.0;
+      bool hole = i < holes.size() && holes[i];
+      sampleRing(ring, count, i, counterClockwise != hole, samples);
+    }
+    sampleStart[i + 1] = samples.size();
+  }
+  return true;
+}
+
+bool MedialAxis::sweepIsClear(const Sample &sample, const MedialBall &from,
+                              const MedialBall &to,
+                              std::vector<size_t> &nearby) const {
+  // The discs in between sweep the convex hull of the two
+  double reach = std::max(from.radius, to.radius);
+  m_grid.query(std::min(from.center.x, to.center.x) - reach,
+               std::min(from.center.y, to.center.y) - reach,
+               std::max(from.center.x, to.center.x) + reach,
+               std::max(from.center.y, to.center.y) + reach, nearby);
+  size_t sampleSegment = m_ringSegments[sample.ring] + sample.edge;
+  size_t contactSegment = m_ringSegments[from.contactRing] + from.contactEdge;
+  for (size_t index : nearby) {
+    if (index == sampleSegment || index == contactSegment) {
+      continue;
+    }
+    // A wall farther from the centres' path than the larger disc's radius
+    // misses every disc
+    const SegmentGrid::Segment &wall = m_grid.segment(index);
+    if (segmentDistance(wall.start, wall.end, from.center, to.center) >=
+        reach) {
+      continue;
+    }
+
+    // Otherwise its distance to the moving centre less the radius is
+    // convex along the sweep, so a ternary search finds its smallest value
+    auto clearance = [&](double t) {
+      Point2D center = from.center + (to.center - from.center) * t;
+      return SegmentGrid::pointSegmentDistance(center, wall.start, wall.end) -
+             (from.radius + (to.radius - from.radius) * t);
+    };
+    double low = 0.0;
+    double high = 1.0;
+    for (int step = 0; step < kSweepSearchSteps; ++step) {
+      double a = (2.0 * low + high) / 3.0;
+      double b = (low + 2.0 * high) / 3.0;
+      if (clearance(a) < clearance(b)) {
+        high = b;
+      } else {
+        low = a;
+      }
+    }
+    if (clearance((low + high) / 2.0) < -kTouchTolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MedialAxis::narrowestWidth(const std::vector<PathView> &rings,
+                                const std::vector<char> &holes,
+                                double &width) {
+  std::vector<Sample> samples;
+  std::vector<size_t> sampleStart;
+  if (!prepare(rings, holes, samples, sampleStart)) {
+    return false;
+  }
+
+  // Each task keeps the narrowest width it found. A narrower disc tangent
+  // at a point touches its other wall inside the disc of the narrowest
+  // width tangent there, and inside the thin cone along the normal that the
+  // object angle allows (the chord to the contact turns from the normal by
+  // half of 180 degrees less the object angle). Those two small queries
+  // rule out most points without fitting them.
+  double halfTurn = (180.0 - m_options.minObjectAngle) * M_PI / 360.0;
+  bool coneTest = halfTurn < M_PI / 4.0;
+  double slope = std::tan(halfTurn);
+  double near = m_options.tolerance * std::cos(halfTurn) * std::cos(halfTurn);
+  double bound = width > 0.0 ? width : std::numeric_limits<double>::infinity();
+  size_t taskCount = (samples.size() + kSamplesPerTask - 1) / kSamplesPerTask;
+  std::vector<double> taskWidth(taskCount, bound);
+  auto mayNarrow = [&](const Point2D &p, const Point2D &n, double narrowest,
+                       std::vector<size_t> &nearby) {
+    if (coneTest) {
+      Point2D tip = p + n * narrowest;
+      Point2D side = Point2D(-n.y, n.x) * (slope * narrowest);
+      m_grid.query(std::min({p.x, tip.x - side.x, tip.x + side.x}),
+                   std::min({p.y, tip.y - side.y, tip.y + side.y}),
+                   std::max({p.x, tip.x - side.x, tip.x + side.x}),
+                   std::max({p.y, tip.y - side.y, tip.y + side.y}), nearby);
+      bool entered = false;
+      for (size_t index : nearby) {
+        const SegmentGrid::Segment &wall = m_grid.segment(index);
+        if (segmentEntersCone(p, n, slope, near, narrowest, wall.start,
+                              wall.end)) {
+          entered = true;
+          break;
+        }
+      }
+      if (!entered) {
+        return false;
+      }
+    }
+    double radius = narrowest / 2.0;
+    SegmentGrid::Match nearest;
+    return m_grid.findNearest(p + n * radius, radius * (1.0 - 1e-9),
+                              nearest);
+  };
+  auto fitTask = [&](size_t task) {
+    double narrowest = bound;
+    size_t hint = kNoSegment;
+    std::vector<size_t> nearby;
+    size_t end = std::min(samples.size(), (task + 1) * kSamplesPerTask);
+    for (size_t j = task * kSamplesPerTask; j < end; ++j) {
+      const Sample &sample = samples[j];
+      if (sample.convexCorner) {
+        continue;
+      }
+      for (size_t k = 0; k < sample.run; ++k) {
+        Point2D p = sample.point + sample.step * static_cast<double>(k);
+        if (narrowest < std::numeric_limits<double>::infinity() &&
+            !mayNarrow(p, sample.normal, narrowest, nearby)) {
+          continue;
+        }
+        MedialBall ball = fitBall(sample, k, hint);
+        if (2.0 * ball.radius > m_options.tolerance &&
+            ball.objectAngle >= m_options.minObjectAngle) {
+          narrowest = std::min(narrowest, 2.0 * ball.radius);
+        }
+      }
+    }
+    taskWidth[task] = narrowest;
+  };
+  size_t threads = ThreadPool::resolveThreadCount(m_options.threadCount);
+  if (threads > 1 && taskCount > 1) {
+    ThreadPool::shared().parallelFor(taskCount, threads, fitTask);
+  } else {
+    for (size_t task = 0; task < taskCount; ++task) {
+      fitTask(task);
+    }
+  }
+
+  double narrowest = bound;
+  for (double taskNarrowest : taskWidth) {
+    narrowest = std::min(narrowest, taskNarrowest);
+  }
+  if (!(narrowest < bound)) {
+    return false;
+  }
+  width = narrowest;
+  return true;
+}
+
+void MedialAxis::sampleRing(const Point2D *points, size_t count,
+                            size_t ring, bool interiorLeft,
+                            std::vector<Sample> &samples) const {
+  std::vector<Point2D> directions(count);
+  std::vector<double> lengths(count);
+  for (size_t i = 0; i < count; ++i) {
+    Point2D edge = points[(i + 1) % count] - points[i];
+    lengths[i] = std::sqrt(dot(edge, edge));
+    directions[i] = edge * (1.0 / lengths[i]);
+  }
+  auto inwardNormal = [interiorLeft](const Point2D &direction) {
+    return interiorLeft ? Point2D(-direction.y, direction.x)
+                        : Point2D(direction.y, -direction.x);
+  };
+
+  const double fanAngle = std::max(m_options.fanAngle, 1.0) * M_PI / 180.0;
+  for (size_t i = 0; i < count; ++i) {
+    // Corner at the start of edge i
+    const Point2D &in = directions[(i + count - 1) % count];
+    const Point2D &out = directions[i];
+    double turn = std::atan2(in.x * out.y - in.y * out.x, dot(in, out));
+    double inwardTurn = interiorLeft ? turn : -turn;
+    Point2D inNormal = inwardNormal(in);
+    if (inwardTurn > kFlatTurn) {
+      // Convex: the disc shrinks to the corner itself
+      Point2D bisector = inNormal + inwardNormal(out);
+      double length = std::sqrt(dot(bisector, bisector));
+      samples.push_back({points[i],
+                         length > 0.0 ? bisector * (1.0 / length) : inNormal,
+                         Point2D(), ring, i, 1, true});
+    } else if (inwardTurn < -kFlatTurn) {
+      // Reflex: discs touch the corner over a fan of normals; a shallow
+      // corner only needs the one halfway
+      int steps = static_cast<int>(std::ceil(std::fabs(turn) / fanAngle));
+      if (steps <= 1) {
+        samples.push_back({points[i], rotate(inNormal, turn / 2.0),
+                           Point2D(), ring, i, 1, false});
+      } else {
+        for (int step = 0; step <= steps; ++step) {
+          samples.push_back({points[i], rotate(inNormal, turn * step / steps),
+                             Point2D(), ring, i, 1, false});
+        }
+      }
+    }
+
+    // Along edge i, half a spacing in from its ends
+    size_t edgeSamples = 1;
+    if (m_options.sampleSpacing > 0.0) {
+      edgeSamples = std::max<size_t>(
+          1, static_cast<size_t>(
+                 std::ceil(lengths[i] / m_options.sampleSpacing)));
+    }
+    Point2D step = out * (lengths[i] / edgeSamples);
+    samples.push_back({points[i] + step * 0.5, inwardNormal(out), step, ring,
+                       i, edgeSamples, false});
+  }
+}
+
+MedialBall MedialAxis::fitBall(const Sample &sample, size_t k,
+                               size_t &segment) const {
+  const Point2D p = sample.point + sample.step * static_cast<double>(k);
+  const Point2D &n = sample.normal;
+  MedialBall ball;
+  ball.boundary = p;
+  ball.center = p;
+  ball.edge = sample.edge;
+  if (sample.convexCorner) {
+    return ball;
+  }
+
+  auto awayFromSample = [&](size_t index) {
+    const SegmentGrid::Segment &wall = m_grid.segment(index);
+    return SegmentGrid::pointSegmentDistanceSquared(p, wall.start, wall.end) >
+           kTouchTolerance * kTouchTolerance;
+  };
+
+  // The wall the previous disc touched usually bounds this one closely;
+  // otherwise the disc's diameter along the normal has to end before the
+  // first wall the normal meets
+  double radius = m_maxRadius;
+  Point2D contact = p;
+  size_t contactSegment = kNoSegment;
+  if (segment != kNoSegment) {
+    // The contact moves along the wall, so try its neighbours too
+    const SegmentGrid::Segment &wall = m_grid.segment(segment);
+    size_t first = m_ringSegments[wall.pathIndex];
+    size_t count = m_ringSegments[wall.pathIndex + 1] - first;
+    size_t edge = wall.segmentIndex;
+    for (size_t candidate : {segment, first + (edge + count - 1) % count,
+                             first + (edge + 1) % count}) {
+      const SegmentGrid::Segment &near = m_grid.segment(candidate);
+      Point2D touch;
+      double bound = tangentRadius(p, n, near.start, near.end, touch);
+      if (bound < radius && awayFromSample(candidate)) {
+        radius = bound;
+        contact = touch;
+        contactSegment = candidate;
+      }
+    }
+  }
+  SegmentGrid::Match hit;
+  if (contactSegment == kNoSegment &&
+      m_grid.castRay(p, n, std::numeric_limits<double>::infinity(),
+                     awayFromSample, hit)) {
+    radius = hit.distance / 2.0;
+    contact = p + n * hit.distance;
+    contactSegment = hit.segment;
+  }
+
+  // Shrink the disc to the circle through the sample and the nearest wall
+  // point inside it until no wall is inside
+  for (int step = 0; step < kMaxShrinkSteps; ++step) {
+    Point2D center = p + n * radius;
+    SegmentGrid::Match nearest;
+    if (!m_grid.findNearest(center, radius, nearest) ||
+        nearest.distance >= radius * (1.0 - 1e-9)) {
+      break;
+    }
+    const SegmentGrid::Segment &wall = m_grid.segment(nearest.segment);
+    Point2D q = closestPoint(center, wall.start, wall.end);
+    double along = 2.0 * dot(n, q - p);
+    if (along <= 0.0) {
+      break;
+    }
+    double shrunk = dot(q - p, q - p) / along;
+    if (shrunk >= radius) {
+      break;
+    }
+    radius = shrunk;
+    contact = q;
+    contactSegment = nearest.segment;
+  }
+
+  ball.center = p + n * radius;
+  ball.radius = radius;
+  Point2D toSample = p - ball.center;
+  Point2D toContact = contact - ball.center;
+  double lengths =
+      std::sqrt(dot(toSample, toSample) * dot(toContact, toContact));
+  if (lengths > 0.0) {
+    double cosine =
+        std::max(-1.0, std::min(1.0, dot(toSample, toContact) / lengths));
+    ball.objectAngle = std::acos(cosine) * 180.0 / M_PI;
+  }
+
+  if (contactSegment != kNoSegment) {
+    segment = contactSegment;
+    const SegmentGrid::Segment &wall = m_grid.segment(contactSegment);
+    Point2D edge = wall.end - wall.start;
+    double t = dot(contact - wall.start, edge) / dot(edge, edge);
+    ball.touchesEdge = t > kCornerFraction && t < 1.0 - kCornerFraction;
+    ball.contactRing = wall.pathIndex;
+    ball.contactEdge = wall.segmentIndex;
+    // The samples of that wall find the disc again when there is one on
+    // either side of the contact; the axis may branch off to a sharp
+    // corner of the wall, so a contact close to one is not found again
+    size_t first = m_ringSegments[wall.pathIndex];
+    size_t count = m_ringSegments[wall.pathIndex + 1] - first;
+    double length = std::sqrt(dot(edge, edge));
+    double minCosine = std::cos(m_options.fanAngle * M_PI / 180.0);
+    auto farFromCorner = [&](double along, size_t neighbour) {
+      const SegmentGrid::Segment &next = m_grid.segment(first + neighbour);
+      Point2D turn = next.end - next.start;
+      return along >= m_options.sampleSpacing ||
+             dot(edge, turn) >= minCosine * length *
+                                    std::sqrt(dot(turn, turn));
+    };
+    ball.duplicate =
+        ball.touchesEdge &&
+        farFromCorner(t * length, (wall.segmentIndex + count - 1) % count) &&
+        farFromCorner((1.0 - t) * length, (wall.segmentIndex + 1) % count) &&
+        (ball.contactRing < sample.ring ||
+         (ball.contactRing == sample.ring && ball.contactEdge < sample.edge));
+  }
+  return ball;
+}
+
+}  // namespace cnc
+}  // namespace nwss
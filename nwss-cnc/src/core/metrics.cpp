@@ -0,0 +1,157 @@
+#include "core/metrics.h"
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace nwss {
+namespace cnc {
+
+std::atomic<PipelineProfiler *> PipelineProfiler::s_active{nullptr};
+
+double PipelineStats::stageMilliseconds(const std::string &name) const {
+  for (const auto &stage : stages) {
+    if (stage.name == name) {
+      return stage.milliseconds;
+    }
+  }
+  return 0.0;
+}
+
+std::string PipelineStats::summary() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "total: " << totalMilliseconds << " ms\n";
+  for (const auto &stage : stages) {
+    out << stage.name << ": " << stage.milliseconds << " ms";
+    if (stage.calls > 1) {
+      out << " (" << stage.calls << " calls)";
+    }
+    out << "\n";
+  }
+  out << "bezier segments: " << bezierSegments << "\n";
+  out << "emitted points: " << emittedPoints << "\n";
+  out << "clipper calls: " << clipperCalls << "\n";
+  out << "offset passes: " << offsetPasses << "\n";
+  out << "toolpaths written: " << toolpaths << "\n";
+  out << "gcode bytes: " << gcodeBytes << "\n";
+  out << "rapid travel: " << rapidBefore << " -> " << rapidAfter << " mm\n";
+  return out.str();
+}
+
+PipelineProfiler::PipelineProfiler() {
+  for (auto &counter : m_counters) {
+    counter.store(0);
+  }
+}
+
+PipelineProfiler::~PipelineProfiler() { stop(); }
+
+void PipelineProfiler::start() {
+  if (!m_running) {
+    m_startTime = std::chrono::steady_clock::now();
+    m_running = true;
+  }
+  s_active.store(this);
+}
+
+void PipelineProfiler::stop() {
+  PipelineProfiler *self = this;
+  s_active.compare_exchange_strong(self, nullptr);
+  if (m_running) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - m_startTime;
+    m_activeMilliseconds += elapsed.count();
+    m_running = false;
+  }
+}
+
+void PipelineProfiler::reset() {
+  for (auto &counter : m_counters) {
+    counter.store(0);
+  }
+  m_activeMilliseconds = 0.0;
+  m_startTime = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(m_stageMutex);
+  m_stages.clear();
+}
+
+PipelineStats PipelineProfiler::stats() const {
+  PipelineStats stats;
+  {
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    stats.stages = m_stages;
+  }
+
+  stats.totalMilliseconds = m_activeMilliseconds;
+  if (m_running) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - m_startTime;
+    stats.totalMilliseconds += elapsed.count();
+  }
+
+  auto value = [this](PipelineCounter counter) {
+    return m_counters[static_cast<int>(counter)].load();
+  };
+  stats.bezierSegments = value(PipelineCounter::BEZIER_SEGMENTS);
+  stats.emittedPoints = value(PipelineCounter::EMITTED_POINTS);
+  stats.clipperCalls = value(PipelineCounter::CLIPPER_CALLS);
+  stats.offsetPasses = value(PipelineCounter::OFFSET_PASSES);
+  stats.toolpaths = value(PipelineCounter::TOOLPATHS);
+  stats.gcodeBytes = value(PipelineCounter::GCODE_BYTES);
+  stats.rapidBefore = value(PipelineCounter::RAPID_BEFORE) / 1000.0;
+  stats.rapidAfter = value(PipelineCounter::RAPID_AFTER) / 1000.0;
+  return stats;
+}
+
+void PipelineProfiler::count(PipelineCounter counter, uint64_t amount) {
+  PipelineProfiler *active = s_active.load(std::memory_order_relaxed);
+  if (active) {
+    active->m_counters[static_cast<int>(counter)].fetch_add(
+        amount, std::memory_order_relaxed);
+  }
+}
+
+void PipelineProfiler::recordStage(const char *name, double milliseconds) {
+  PipelineProfiler *active = s_active.load();
+  if (!active) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(active->m_stageMutex);
+  for (auto &stage : active->m_stages) {
+    if (std::strcmp(stage.name.c_str(), name) == 0) {
+      stage.milliseconds += milliseconds;
+      stage.calls++;
+      return;
+    }
+  }
+
+  StageTiming stage;
+  stage.name = name;
+  stage.milliseconds = milliseconds;
+  stage.calls = 1;
+  active->m_stages.push_back(stage);
+}
+
+bool PipelineProfiler::isActive() {
+  return s_active.load(std::memory_order_relaxed) != nullptr;
+}
+
+ScopedStageTimer::ScopedStageTimer(const char *name)
+    : m_name(name), m_active(PipelineProfiler::isActive()) {
+  if (m_active) {
+    m_start = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedStageTimer::~ScopedStageTimer() {
+  if (m_active) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - m_start;
+    PipelineProfiler::recordStage(m_name, elapsed.count());
+  }
+}
+
+}  // namespace cnc
+}  // namespace nwss
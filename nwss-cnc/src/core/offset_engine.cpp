@@ -0,0 +1,130 @@
+#include "core/offset_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#include "core/metrics.h"
+#include "core/thread_pool.h"
+
+namespace nwss {
+namespace cnc {
+
+void OffsetEngine::addPaths(const Clipper2Lib::Paths64 &paths, bool closed) {
+  if (!paths.empty()) {
+    m_groups.push_back({paths, closed});
+  }
+}
+
+void OffsetEngine::prepare(Clipper2Lib::ClipperOffset &clipperOffset) const {
+  for (const auto &group : m_groups) {
+    clipperOffset.AddPaths(group.paths, m_options.joinType,
+                           group.closed ? Clipper2Lib::EndType::Polygon
+                                        : m_options.openEndType);
+  }
+}
+
+void OffsetEngine::execute(Clipper2Lib::ClipperOffset &clipperOffset,
+                           double distance,
+                           Clipper2Lib::Paths64 &result) const {
+  double delta = distance * m_options.scale;
+  if (delta == 0.0) {
+    // Same as Clipper2's InflatePaths: no offset returns the input
+    result.clear();
+    for (const auto &group : m_groups) {
+      result.insert(result.end(), group.paths.begin(), group.paths.end());
+    }
+    return;
+  }
+
+  PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+  PipelineProfiler::count(PipelineCounter::OFFSET_PASSES);
+  clipperOffset.Execute(delta, result);
+}
+
+bool OffsetEngine::isCollapsed(const Clipper2Lib::Paths64 &ring,
+                               double scaledMinArea) {
+  for (const auto &path : ring) {
+    if (std::fabs(Clipper2Lib::Area(path)) > scaledMinArea) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OffsetEngine::offset(const std::vector<double> &distances,
+                          std::vector<Clipper2Lib::Paths64> &results,
+                          std::string &error) const {
+  results.assign(distances.size(), Clipper2Lib::Paths64());
+  if (distances.empty()) {
+    return true;
+  }
+
+  const double arcTolerance = m_options.arcTolerance * m_options.scale;
+  size_t threads = std::min(
+      ThreadPool::resolveThreadCount(m_options.threadCount), distances.size());
+
+  try {
+    if (threads <= 1) {
+      Clipper2Lib::ClipperOffset clipperOffset(m_options.miterLimit,
+                                               arcTolerance);
+      prepare(clipperOffset);
+      for (size_t i = 0; i < distances.size(); ++i) {
+        execute(clipperOffset, distances[i], results[i]);
+      }
+    } else {
+      // One prepared offsetter per worker, each taking every threads-th ring
+      ThreadPool::shared().parallelFor(threads, threads, [&](size_t worker) {
+        Clipper2Lib::ClipperOffset clipperOffset(m_options.miterLimit,
+                                                 arcTolerance);
+        prepare(clipperOffset);
+        for (size_t i = worker; i < distances.size(); i += threads) {
+          execute(clipperOffset, distances[i], results[i]);
+        }
+      });
+    }
+  } catch (const std::exception &e) {
+    error = "Clipper2 offset execution failed: " + std::string(e.what());
+    return false;
+  }
+  return true;
+}
+
+bool OffsetEngine::offsetUntilCollapse(
+    double firstDistance, double step, size_t maxRings, double minArea,
+    std::vector<Clipper2Lib::Paths64> &results, std::string &error) const {
+  results.clear();
+  if (empty()) {
+    return true;
+  }
+
+  const double scaledMinArea = minArea * m_options.scale * m_options.scale;
+
+  // Rings are computed a batch at a time (one ring per thread); at most the
+  // rest of the batch after the collapse is wasted
+  size_t batchSize = ThreadPool::resolveThreadCount(m_options.threadCount);
+  std::vector<double> distances;
+  std::vector<Clipper2Lib::Paths64> batch;
+  while (results.size() < maxRings) {
+    distances.clear();
+    size_t count = std::min(batchSize, maxRings - results.size());
+    for (size_t i = 0; i < count; ++i) {
+      distances.push_back(firstDistance + step * (results.size() + i));
+    }
+    if (!offset(distances, batch, error)) {
+      return false;
+    }
+
+    for (auto &ring : batch) {
+      bool collapsed = isCollapsed(ring, scaledMinArea);
+      results.push_back(std::move(ring));
+      if (collapsed) {
+        return true;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace cnc
+}  // namespace nwss
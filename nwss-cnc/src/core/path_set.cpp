@@ -0,0 +1,109 @@
+#include "core/path_set.h"
+
+#include <cmath>
+
+namespace nwss {
+namespace cnc {
+
+// Path views read the interleaved coordinates of Point2D arrays directly
+static_assert(sizeof(Point2D) == 2 * sizeof(double),
+              "Point2D must be two packed doubles");
+
+PathView::PathView(const Path &path) {
+  const auto &points = path.getPoints();
+  if (!points.empty()) {
+    m_x = &points[0].x;
+    m_y = &points[0].y;
+    m_size = points.size();
+    m_stride = 2;
+    if (path.hasDepths()) {
+      m_depth = path.getDepths().data();
+    }
+  }
+}
+
+Path PathView::toPath() const {
+  Path path;
+  if (hasDepths()) {
+    path.reserve(m_size);
+    for (size_t i = 0; i < m_size; ++i) {
+      path.addPoint((*this)[i], depth(i));
+    }
+    return path;
+  }
+
+  Point2D *points = path.appendPoints(m_size);
+  for (size_t i = 0; i < m_size; ++i) {
+    points[i] = (*this)[i];
+  }
+  return path;
+}
+
+double PathView::length() const {
+  double length = 0.0;
+  for (size_t i = 1; i < m_size; ++i) {
+    double dx = x(i) - x(i - 1);
+    double dy = y(i) - y(i - 1);
+    length += std::sqrt(dx * dx + dy * dy);
+  }
+  return length;
+}
+
+PathSet::PathSet(const std::vector<Path> &paths) {
+  size_t points = 0;
+  for (const auto &path : paths) {
+    points += path.size();
+  }
+  reserve(paths.size(), points);
+
+  for (const auto &path : paths) {
+    addPath(path);
+  }
+}
+
+void PathSet::reserve(size_t pathCount, size_t pointCount) {
+  m_offsets.reserve(pathCount);
+  m_x.reserve(pointCount);
+  m_y.reserve(pointCount);
+}
+
+void PathSet::clear() {
+  m_x.clear();
+  m_y.clear();
+  m_offsets.clear();
+}
+
+void PathSet::addPath(const PathView &path) {
+  beginPath();
+  size_t start = m_x.size();
+  m_x.resize(start + path.size());
+  m_y.resize(start + path.size());
+  double *xs = m_x.data() + start;
+  double *ys = m_y.data() + start;
+  for (size_t i = 0; i < path.size(); ++i) {
+    xs[i] = path.x(i);
+    ys[i] = path.y(i);
+  }
+}
+
+void PathSet::append(const PathSet &other) {
+  size_t base = m_x.size();
+  m_offsets.reserve(m_offsets.size() + other.m_offsets.size());
+  for (size_t offset : other.m_offsets) {
+    m_offsets.push_back(base + offset);
+  }
+  m_x.insert(m_x.end(), other.m_x.begin(), other.m_x.end());
+  m_y.insert(m_y.end(), other.m_y.begin(), other.m_y.end());
+}
+
+std::vector<Path> PathSet::toPaths() const {
+  std::vector<Path> paths;
+  paths.reserve(size());
+  for (PathView path : *this) {
+    paths.push_back(path.toPath());
+  }
+  return paths;
+}
+
+}  // namespace cnc
+}  // namespace nwss
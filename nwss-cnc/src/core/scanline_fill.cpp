@@ -0,0 +1,256 @@
+#define _USE_MATH_DEFINES
+#include "core/scanline_fill.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// A non-horizontal ring edge in the scanline frame, from its lower end up
+struct Edge {
+  double yMin;
+  double yMax;
+  double xAtYMin;
+  double slope;  // dx/dy
+  double xAtYMax;
+
+  double xAt(double y) const { return xAtYMin + (y - yMin) * slope; }
+};
+
+// Part of a scanline inside the region
+struct Span {
+  double start;
+  double end;
+  bool used;
+};
+
+// Points closer than this to a line (mm) count as lying on it; span ends
+// are computed on the edges and only miss them by rounding
+const double kOnLineTolerance = 1e-6;
+
+// Side of the line through (x0, y0) and (x1, y1) a point is on (0 = on it)
+int side(double x0, double y0, double x1, double y1, double px, double py) {
+  double length = std::hypot(x1 - x0, y1 - y0);
+  if (length == 0.0) {
+    return 0;
+  }
+  double distance =
+      ((x1 - x0) * (py - y0) - (y1 - y0) * (px - x0)) / length;
+  if (std::abs(distance) <= kOnLineTolerance) {
+    return 0;
+  }
+  return distance > 0.0 ? 1 : -1;
+}
+
+// Check if a segment and an edge cross at a point inside both
+bool crossesProperly(double x0, double y0, double x1, double y1,
+                     const Edge &edge) {
+  int s1 = side(edge.xAtYMin, edge.yMin, edge.xAtYMax, edge.yMax, x0, y0);
+  int s2 = side(edge.xAtYMin, edge.yMin, edge.xAtYMax, edge.yMax, x1, y1);
+  int s3 = side(x0, y0, x1, y1, edge.xAtYMin, edge.yMin);
+  int s4 = side(x0, y0, x1, y1, edge.xAtYMax, edge.yMax);
+  return s1 * s2 < 0 && s3 * s4 < 0;
+}
+
+/**
+ * Check if the link between two scanlines stays inside the region
+ * @param bandEdges Every edge overlapping the band between the scanlines
+ */
+bool linkInside(double x0, double y0, double x1, double y1,
+                const std::vector<const Edge *> &bandEdges) {
+  for (const Edge *edge : bandEdges) {
+    if (crossesProperly(x0, y0, x1, y1, *edge)) {
+      return false;
+    }
+  }
+
+  // Both ends lie on the boundary, so also make sure the link does not run
+  // outside along a concave stretch of it. A link running along a straight
+  // stretch of the boundary is fine.
+  double midX = (x0 + x1) / 2.0;
+  double midY = (y0 + y1) / 2.0;
+  bool inside = false;
+  for (const Edge *edge : bandEdges) {
+    if (edge->yMin <= midY && midY < edge->yMax) {
+      double x = edge->xAt(midY);
+      if (std::abs(x - midX) <= kOnLineTolerance) {
+        return true;
+      }
+      if (x > midX) {
+        inside = !inside;
+      }
+    }
+  }
+  return inside;
+}
+
+}  // namespace
+
+std::vector<Path> ScanlineFill::zigZag(const Clipper2Lib::Paths64 &region,
+                                       double spacing, double angle,
+                                       int scale) {
+  std::vector<Path> paths;
+  if (spacing <= 0.0 || region.empty()) {
+    return paths;
+  }
+
+  // Rotate into the frame where the scanlines are horizontal
+  double angleRad = angle * M_PI / 180.0;
+  double cosAngle = std::cos(angleRad);
+  double sinAngle = std::sin(angleRad);
+  const double factor = 1.0 / static_cast<double>(scale);
+
+  // Edge table
+  std::vector<Edge> edges;
+  double minY = 0.0;
+  double maxY = 0.0;
+  for (const auto &ring : region) {
+    if (ring.size() < 3) {
+      continue;
+    }
+    size_t j = ring.size() - 1;
+    for (size_t i = 0; i < ring.size(); j = i++) {
+      double ax = static_cast<double>(ring[j].x) * factor;
+      double ay = static_cast<double>(ring[j].y) * factor;
+      double bx = static_cast<double>(ring[i].x) * factor;
+      double by = static_cast<double>(ring[i].y) * factor;
+      double x0 = ax * cosAngle + ay * sinAngle;
+      double y0 = -ax * sinAngle + ay * cosAngle;
+      double x1 = bx * cosAngle + by * sinAngle;
+      double y1 = -bx * sinAngle + by * cosAngle;
+      if (y0 == y1) {
+        continue;  // Horizontal edges never cross a scanline
+      }
+      if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+      }
+
+      if (edges.empty()) {
+        minY = y0;
+        maxY = y1;
+      }
+      minY = std::min(minY, y0);
+      maxY = std::max(maxY, y1);
+      edges.push_back({y0, y1, x0, (x1 - x0) / (y1 - y0), x1});
+    }
+  }
+  if (edges.empty()) {
+    return paths;
+  }
+  std::sort(edges.begin(), edges.end(),
+            [](const Edge &a, const Edge &b) { return a.yMin < b.yMin; });
+
+  // Spread the lines evenly, half a step in from the extremes
+  size_t lineCount = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil((maxY - minY) / spacing)));
+  double step = (maxY - minY) / static_cast<double>(lineCount);
+  std::vector<double> lineY(lineCount);
+  for (size_t k = 0; k < lineCount; ++k) {
+    lineY[k] = minY + (static_cast<double>(k) + 0.5) * step;
+  }
+
+  // Sweep the lines upwards with an active edge list. Edges cover
+  // [yMin, yMax), so a vertex shared by two edges is only crossed once.
+  std::vector<std::vector<Span>> spans(lineCount);
+  std::vector<std::vector<const Edge *>> bandEdges(lineCount);
+  std::vector<const Edge *> active;
+  std::vector<double> crossings;
+  size_t nextEdge = 0;
+
+  for (size_t k = 0; k < lineCount; ++k) {
+    double y = lineY[k];
+    while (nextEdge < edges.size() && edges[nextEdge].yMin <= y) {
+      active.push_back(&edges[nextEdge++]);
+    }
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [y](const Edge *edge) {
+                                  return edge->yMax <= y;
+                                }),
+                 active.end());
+
+    crossings.clear();
+    for (const Edge *edge : active) {
+      crossings.push_back(edge->xAt(y));
+    }
+    std::sort(crossings.begin(), crossings.end());
+    for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+      if (crossings[i + 1] > crossings[i]) {
+        spans[k].push_back({crossings[i], crossings[i + 1], false});
+      }
+    }
+
+    // Edges a link to the next line could meet: those still active, and
+    // those starting before the next line
+    if (k + 1 < lineCount) {
+      bandEdges[k] = active;
+      for (size_t e = nextEdge;
+           e < edges.size() && edges[e].yMin < lineY[k + 1]; ++e) {
+        bandEdges[k].push_back(&edges[e]);
+      }
+    }
+  }
+
+  auto emit = [&](Path &path, double x, double y) {
+    path.addPoint(Point2D(x * cosAngle - y * sinAngle,
+                          x * sinAngle + y * cosAngle));
+  };
+
+  // Link the spans into zig-zags, starting each from the lowest unused span
+  for (size_t first = 0; first < lineCount; ++first) {
+    for (auto &startSpan : spans[first]) {
+      if (startSpan.used) {
+        continue;
+      }
+
+      Path path;
+      Span *span = &startSpan;
+      bool forward = true;
+      size_t k = first;
+      while (true) {
+        span->used = true;
+        double entry = forward ? span->start : span->end;
+        double exit = forward ? span->end : span->start;
+        emit(path, entry, lineY[k]);
+        emit(path, exit, lineY[k]);
+        if (k + 1 >= lineCount) {
+          break;
+        }
+
+        // Continue on the overlapping span of the next line whose end
+        // nearest to this exit can be reached without leaving the region
+        Span *next = nullptr;
+        double nextDistance = 0.0;
+        for (auto &candidate : spans[k + 1]) {
+          if (candidate.used || candidate.end < span->start ||
+              candidate.start > span->end) {
+            continue;
+          }
+          double candidateEntry = forward ? candidate.end : candidate.start;
+          double distance = std::abs(candidateEntry - exit);
+          if ((!next || distance < nextDistance) &&
+              linkInside(exit, lineY[k], candidateEntry, lineY[k + 1],
+                         bandEdges[k])) {
+            next = &candidate;
+            nextDistance = distance;
+          }
+        }
+        if (!next) {
+          break;
+        }
+        span = next;
+        forward = !forward;
+        ++k;
+      }
+      paths.push_back(std::move(path));
+    }
+  }
+
+  return paths;
+}
+
+}  // namespace cnc
+}  // namespace nwss
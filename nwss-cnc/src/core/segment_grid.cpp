@@ -0,0 +1,384 @@
+#include "core/segment_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// Upper bound on the number of cells per indexed segment; keeps sparse
+// designs with a small requested cell size from allocating huge grids
+constexpr size_t kMaxCellsPerSegment = 4;
+
+}  // namespace
+
+void SegmentGrid::addPath(const PathView &path, size_t pathIndex,
+                          bool closed) {
+  if (path.size() < 2) {
+    return;
+  }
+
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    m_segments.push_back({path[i], path[i + 1], pathIndex, i});
+  }
+  if (closed && path.size() > 2) {
+    m_segments.push_back(
+        {path.back(), path.front(), pathIndex, path.size() - 1});
+  }
+}
+
+void SegmentGrid::build(double cellSize) {
+  m_cellStart.clear();
+  m_cellItems.clear();
+  m_columns = m_rows = 0;
+  if (m_segments.empty()) {
+    return;
+  }
+
+  double minX = std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  double maxY = std::numeric_limits<double>::lowest();
+  double totalLength = 0.0;
+  for (const auto &segment : m_segments) {
+    minX = std::min({minX, segment.start.x, segment.end.x});
+    minY = std::min({minY, segment.start.y, segment.end.y});
+    maxX = std::max({maxX, segment.start.x, segment.end.x});
+    maxY = std::max({maxY, segment.start.y, segment.end.y});
+    totalLength += segment.start.distanceTo(segment.end);
+  }
+
+  if (cellSize <= 0.0) {
+    cellSize = totalLength / m_segments.size();
+  }
+  if (!(cellSize > 0.0)) {
+    cellSize = 1.0;
+  }
+
+  // Grow the cells until the grid is proportional to the segment count
+  size_t maxCells = kMaxCellsPerSegment * m_segments.size();
+  for (;;) {
+    m_columns = static_cast<size_t>((maxX - minX) / cellSize) + 1;
+    m_rows = static_cast<size_t>((maxY - minY) / cellSize) + 1;
+    if (m_columns * m_rows <= maxCells) {
+      break;
+    }
+    cellSize *= 2.0;
+  }
+  m_minX = minX;
+  m_minY = minY;
+  m_cellSize = cellSize;
+
+  // Counting sort of segments into the cells their bounding boxes touch
+  m_cellStart.assign(m_columns * m_rows + 1, 0);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+      const Segment &segment = m_segments[i];
+      size_t x0, y0, x1, y1;
+      cellRange(std::min(segment.start.x, segment.end.x),
+                std::min(segment.start.y, segment.end.y),
+                std::max(segment.start.x, segment.end.x),
+                std::max(segment.start.y, segment.end.y), x0, y0, x1, y1);
+      for (size_t y = y0; y <= y1; ++y) {
+        for (size_t x = x0; x <= x1; ++x) {
+          size_t cell = y * m_columns + x;
+          if (pass == 0) {
+            ++m_cellStart[cell + 1];
+          } else {
+            m_cellItems[m_cellStart[cell]++] = i;
+          }
+        }
+      }
+    }
+
+    if (pass == 0) {
+      for (size_t c = 1; c < m_cellStart.size(); ++c) {
+        m_cellStart[c] += m_cellStart[c - 1];
+      }
+      m_cellItems.resize(m_cellStart.back());
+    } else {
+      // The fill pass advanced each start to the next cell's start
+      for (size_t c = m_cellStart.size() - 1; c > 0; --c) {
+        m_cellStart[c] = m_cellStart[c - 1];
+      }
+      m_cellStart[0] = 0;
+    }
+  }
+}
+
+void SegmentGrid::clear() {
+  m_segments.clear();
+  m_cellStart.clear();
+  m_cellItems.clear();
+  m_columns = m_rows = 0;
+}
+
+void SegmentGrid::cellRange(double minX, double minY, double maxX, double maxY,
+                            size_t &x0, size_t &y0, size_t &x1,
+                            size_t &y1) const {
+  auto clampCell = [this](double value, size_t count) {
+    double cell = std::floor(value / m_cellSize);
+    if (!(cell > 0.0)) {
+      return size_t(0);
+    }
+    return std::min(static_cast<size_t>(cell), count - 1);
+  };
+  x0 = clampCell(minX - m_minX, m_columns);
+  y0 = clampCell(minY - m_minY, m_rows);
+  x1 = clampCell(maxX - m_minX, m_columns);
+  y1 = clampCell(maxY - m_minY, m_rows);
+}
+
+void SegmentGrid::query(double minX, double minY, double maxX, double maxY,
+                        std::vector<size_t> &result) const {
+  result.clear();
+  if (m_cellStart.empty()) {
+    return;
+  }
+
+  size_t x0, y0, x1, y1;
+  cellRange(minX, minY, maxX, maxY, x0, y0, x1, y1);
+  for (size_t y = y0; y <= y1; ++y) {
+    for (size_t x = x0; x <= x1; ++x) {
+      size_t cell = y * m_columns + x;
+      result.insert(result.end(), m_cellItems.begin() + m_cellStart[cell],
+                    m_cellItems.begin() + m_cellStart[cell + 1]);
+    }
+  }
+
+  // Segments spanning several cells are listed once per cell
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+bool SegmentGrid::findNearest(const Point2D &point, double maxDistance,
+                              Match &match) const {
+  if (m_cellStart.empty()) {
+    return false;
+  }
+
+  // Visit square rings of cells around the point's cell, nearest first,
+  // and stop once no unvisited cell can hold a closer segment
+  size_t px, py, sameX, sameY;
+  cellRange(point.x, point.y, point.x, point.y, px, py, sameX, sameY);
+  size_t lastRing = std::max(m_columns, m_rows);
+  double rings = maxDistance / m_cellSize + 1.0;
+  if (rings < static_cast<double>(lastRing)) {
+    lastRing = static_cast<size_t>(rings);
+  }
+
+  // Squared distances are compared, and cells entirely farther than the
+  // best match so far (or maxDistance) are skipped
+  bool found = false;
+  double bound = maxDistance * maxDistance;
+  auto visitCell = [&](size_t x, size_t y) {
+    double left = m_minX + x * m_cellSize;
+    double bottom = m_minY + y * m_cellSize;
+    double dx = std::max({0.0, left - point.x, point.x - (left + m_cellSize)});
+    double dy =
+        std::max({0.0, bottom - point.y, point.y - (bottom + m_cellSize)});
+    if (dx * dx + dy * dy > bound) {
+      return;
+    }
+
+    size_t cell = y * m_columns + x;
+    for (size_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+      const Segment &segment = m_segments[m_cellItems[k]];
+      double distanceSquared =
+          pointSegmentDistanceSquared(point, segment.start, segment.end);
+      if (distanceSquared <= bound &&
+          (!found || distanceSquared < match.distance)) {
+        match.segment = m_cellItems[k];
+        match.distance = distanceSquared;
+        bound = distanceSquared;
+        found = true;
+      }
+    }
+  };
+
+  for (size_t ring = 0; ring <= lastRing; ++ring) {
+    size_t x0 = px >= ring ? px - ring : 0;
+    size_t y0 = py >= ring ? py - ring : 0;
+    size_t x1 = std::min(px + ring, m_columns - 1);
+    size_t y1 = std::min(py + ring, m_rows - 1);
+    for (size_t y = y0; y <= y1; ++y) {
+      if (y + ring == py || y == py + ring) {
+        // Top or bottom edge of the ring
+        for (size_t x = x0; x <= x1; ++x) {
+          visitCell(x, y);
+        }
+      } else {
+        // Left and right edges; the interior was visited by earlier rings
+        if (px >= ring) {
+          visitCell(px - ring, y);
+        }
+        if (ring > 0 && px + ring < m_columns) {
+          visitCell(px + ring, y);
+        }
+      }
+    }
+
+    // Cells of the next ring are at least this far from the point
+    double ringDistance = ring * m_cellSize;
+    if (found && match.distance <= ringDistance * ringDistance) {
+      break;
+    }
+  }
+  if (found) {
+    match.distance = std::sqrt(match.distance);
+  }
+  return found;
+}
+
+bool SegmentGrid::castRay(const Point2D &origin, const Point2D &direction,
+                          double maxDistance,
+                          const std::function<bool(size_t)> &accept,
+                          Match &hit) const {
+  if (m_cellStart.empty()) {
+    return false;
+  }
+
+  // Walk the cells along the ray (Amanatides-Woo traversal)
+  size_t startX, startY, sameX, sameY;
+  cellRange(origin.x, origin.y, origin.x, origin.y, startX, startY, sameX,
+            sameY);
+  std::ptrdiff_t cx = static_cast<std::ptrdiff_t>(startX);
+  std::ptrdiff_t cy = static_cast<std::ptrdiff_t>(startY);
+  const double infinity = std::numeric_limits<double>::infinity();
+
+  int stepX = direction.x > 0.0 ? 1 : (direction.x < 0.0 ? -1 : 0);
+  int stepY = direction.y > 0.0 ? 1 : (direction.y < 0.0 ? -1 : 0);
+  double cellLeft = m_minX + cx * m_cellSize;
+  double cellBottom = m_minY + cy * m_cellSize;
+  double nextX = stepX > 0 ? (cellLeft + m_cellSize - origin.x) / direction.x
+                 : stepX < 0 ? (cellLeft - origin.x) / direction.x
+                             : infinity;
+  double nextY = stepY > 0 ? (cellBottom + m_cellSize - origin.y) / direction.y
+                 : stepY < 0 ? (cellBottom - origin.y) / direction.y
+                             : infinity;
+  double deltaX = stepX != 0 ? m_cellSize / std::fabs(direction.x) : infinity;
+  double deltaY = stepY != 0 ? m_cellSize / std::fabs(direction.y) : infinity;
+
+  bool found = false;
+  double best = maxDistance;
+  for (;;) {
+    size_t cell = static_cast<size_t>(cy) * m_columns + cx;
+    for (size_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+      size_t index = m_cellItems[k];
+      const Segment &segment = m_segments[index];
+
+      // Solve origin + t * direction = start + s * (end - start)
+      double ex = segment.end.x - segment.start.x;
+      double ey = segment.end.y - segment.start.y;
+      double denominator = direction.x * ey - direction.y * ex;
+      if (denominator == 0.0) {
+        continue;  // Parallel
+      }
+      double wx = segment.start.x - origin.x;
+      double wy = segment.start.y - origin.y;
+      double t = (wx * ey - wy * ex) / denominator;
+      double s = (wx * direction.y - wy * direction.x) / denominator;
+      if (t > 0.0 && t <= best && s >= 0.0 && s <= 1.0 && accept(index)) {
+        best = t;
+        hit.segment = index;
+        hit.distance = t;
+        found = true;
+      }
+    }
+
+    // Hits in later cells are farther along the ray than this cell's exit
+    double exit = std::min(nextX, nextY);
+    if (exit >= best) {
+      break;
+    }
+    if (nextX < nextY) {
+      cx += stepX;
+      nextX += deltaX;
+    } else {
+      cy += stepY;
+      nextY += deltaY;
+    }
+    if (cx < 0 || cy < 0 || cx >= static_cast<std::ptrdiff_t>(m_columns) ||
+        cy >= static_cast<std::ptrdiff_t>(m_rows)) {
+      break;
+    }
+  }
+  return found;
+}
+
+double SegmentGrid::pointSegmentDistance(const Point2D &point,
+                                         const Point2D &start,
+                                         const Point2D &end) {
+  return std::sqrt(pointSegmentDistanceSquared(point, start, end));
+}
+
+double SegmentGrid::pointSegmentDistanceSquared(const Point2D &point,
+                                                const Point2D &start,
+                                                const Point2D &end) {
+  double dx = end.x - start.x;
+  double dy = end.y - start.y;
+  double lengthSquared = dx * dx + dy * dy;
+  double t = 0.0;
+  if (lengthSquared > 0.0) {
+    t = ((point.x - start.x) * dx + (point.y - start.y) * dy) / lengthSquared;
+    t = std::max(0.0, std::min(1.0, t));
+  }
+  double ox = start.x + t * dx - point.x;
+  double oy = start.y + t * dy - point.y;
+  return ox * ox + oy * oy;
+}
+
+double SegmentGrid::segmentDistance(const Point2D &a0, const Point2D &a1,
+                                    const Point2D &b0, const Point2D &b1,
+                                    Point2D &onA, Point2D &onB) {
+  // Crossing segments touch
+  auto cross = [](const Point2D &o, const Point2D &p, const Point2D &q) {
+    return (p.x - o.x) * (q.y - o.y) - (p.y - o.y) * (q.x - o.x);
+  };
+  double d1 = cross(b0, b1, a0);
+  double d2 = cross(b0, b1, a1);
+  double d3 = cross(a0, a1, b0);
+  double d4 = cross(a0, a1, b1);
+  if (((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0)) &&
+      ((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0))) {
+    double t = d1 / (d1 - d2);
+    onA = onB = Point2D(a0.x + t * (a1.x - a0.x), a0.y + t * (a1.y - a0.y));
+    return 0.0;
+  }
+
+  // Otherwise the closest pair involves an endpoint of one of them
+  auto closestOn = [](const Point2D &point, const Point2D &start,
+                      const Point2D &end) {
+    double dx = end.x - start.x;
+    double dy = end.y - start.y;
+    double lengthSquared = dx * dx + dy * dy;
+    double t = lengthSquared > 0.0 ? ((point.x - start.x) * dx +
+                                      (point.y - start.y) * dy) /
+                                         lengthSquared
+                                   : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    return Point2D(start.x + t * dx, start.y + t * dy);
+  };
+
+  double best = std::numeric_limits<double>::max();
+  auto consider = [&](const Point2D &p, const Point2D &q, bool pOnA) {
+    double distance = p.distanceTo(q);
+    if (distance < best) {
+      best = distance;
+      onA = pOnA ? p : q;
+      onB = pOnA ? q : p;
+    }
+  };
+  consider(a0, closestOn(a0, b0, b1), true);
+  consider(a1, closestOn(a1, b0, b1), true);
+  consider(b0, closestOn(b0, a0, a1), false);
+  consider(b1, closestOn(b1, a0, a1), false);
+  return best;
+}
+
+}  // namespace cnc
+}  // namespace nwss
@@ -0,0 +1,186 @@
+#include "core/segment_intersector.h"
+
+#include <algorithm>
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// Extent of a segment along the sweep axis and the other axis
+struct SweepEntry {
+  double low;
+  double high;
+  double crossLow;
+  double crossHigh;
+  size_t segment;
+};
+
+// Twice the signed area of the triangle (o, p, q)
+inline double orientation(const Point2D &o, const Point2D &p,
+                          const Point2D &q) {
+  return (p.x - o.x) * (q.y - o.y) - (p.y - o.y) * (q.x - o.x);
+}
+
+// Check if a point known to be collinear with a segment lies on it
+inline bool withinSegment(const Point2D &point, const Point2D &start,
+                          const Point2D &end) {
+  return point.x >= std::min(start.x, end.x) &&
+         point.x <= std::max(start.x, end.x) &&
+         point.y >= std::min(start.y, end.y) &&
+         point.y <= std::max(start.y, end.y);
+}
+
+/**
+ * Intersect segments a and b
+ * @param junction Point where the path runs from one segment into the
+ *                 other (contact only there is not an intersection)
+ * @param hasJunction Whether the segments are consecutive
+ * @param point Output intersection point
+ * @return true if the segments intersect
+ */
+bool intersect(const Point2D &a0, const Point2D &a1, const Point2D &b0,
+               const Point2D &b1, const Point2D &junction, bool hasJunction,
+               Point2D &point) {
+  double d1 = orientation(b0, b1, a0);
+  double d2 = orientation(b0, b1, a1);
+  double d3 = orientation(a0, a1, b0);
+  double d4 = orientation(a0, a1, b1);
+
+  // Proper crossing
+  if (((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0)) &&
+      ((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0))) {
+    double t = d1 / (d1 - d2);
+    point = Point2D(a0.x + t * (a1.x - a0.x), a0.y + t * (a1.y - a0.y));
+    return true;
+  }
+
+  // Touching or overlapping: an end point lies on the other segment
+  const Point2D *candidates[4] = {nullptr, nullptr, nullptr, nullptr};
+  if (d1 == 0.0 && withinSegment(a0, b0, b1)) candidates[0] = &a0;
+  if (d2 == 0.0 && withinSegment(a1, b0, b1)) candidates[1] = &a1;
+  if (d3 == 0.0 && withinSegment(b0, a0, a1)) candidates[2] = &b0;
+  if (d4 == 0.0 && withinSegment(b1, a0, a1)) candidates[3] = &b1;
+  for (const Point2D *candidate : candidates) {
+    if (candidate && !(hasJunction && *candidate == junction)) {
+      point = *candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+std::vector<SegmentIntersector::Intersection>
+SegmentIntersector::findSelfIntersections(const PathView &path, bool closed,
+                                          size_t maxResults) {
+  std::vector<Intersection> result;
+  const size_t pointCount = path.size();
+  if (pointCount < 3) {
+    return result;
+  }
+  const size_t segmentCount = closed ? pointCount : pointCount - 1;
+  // Paths ending on their first point wrap from their last real segment
+  // back to segment 0
+  const bool repeatsStart = path[pointCount - 1] == path[0];
+
+  // Sweep along the longer side so fewer segments are open at once
+  double minX = path.x(0), maxX = minX, minY = path.y(0), maxY = minY;
+  for (size_t i = 1; i < pointCount; ++i) {
+    minX = std::min(minX, path.x(i));
+    maxX = std::max(maxX, path.x(i));
+    minY = std::min(minY, path.y(i));
+    maxY = std::max(maxY, path.y(i));
+  }
+  const bool sweepX = maxX - minX >= maxY - minY;
+
+  std::vector<SweepEntry> entries(segmentCount);
+  for (size_t i = 0; i < segmentCount; ++i) {
+    size_t next = i + 1 < pointCount ? i + 1 : 0;
+    double x0 = path.x(i), x1 = path.x(next);
+    double y0 = path.y(i), y1 = path.y(next);
+    SweepEntry &entry = entries[i];
+    if (!sweepX) {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    entry.low = std::min(x0, x1);
+    entry.high = std::max(x0, x1);
+    entry.crossLow = std::min(y0, y1);
+    entry.crossHigh = std::max(y0, y1);
+    entry.segment = i;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const SweepEntry &a, const SweepEntry &b) {
+              return a.low < b.low;
+            });
+
+  std::vector<SweepEntry> active;
+  for (const SweepEntry &entry : entries) {
+    size_t a = entry.segment;
+    Point2D a0 = path[a];
+    Point2D a1 = path[a + 1 < pointCount ? a + 1 : 0];
+
+    for (size_t k = 0; k < active.size();) {
+      const SweepEntry &other = active[k];
+
+      // Segments ending before this one starts can never meet later ones
+      if (other.high < entry.low) {
+        active[k] = active.back();
+        active.pop_back();
+        continue;
+      }
+      ++k;
+      if (other.crossHigh < entry.crossLow ||
+          other.crossLow > entry.crossHigh) {
+        continue;
+      }
+
+      size_t b = other.segment;
+      Point2D b0 = path[b];
+      Point2D b1 = path[b + 1 < pointCount ? b + 1 : 0];
+
+      // Only neighbours along the path may share their junction; any
+      // other shared point (a pinch, a contour touching itself) counts
+      size_t low = std::min(a, b), high = std::max(a, b);
+      Point2D junction;
+      bool hasJunction = true;
+      if (high == low + 1) {
+        junction = path[high];
+      } else if (low == 0 && (high == segmentCount - 1 ||
+                              (high == pointCount - 2 && repeatsStart))) {
+        junction = path[0];
+      } else {
+        hasJunction = false;
+      }
+
+      Point2D point;
+      if (intersect(a0, a1, b0, b1, junction, hasJunction, point)) {
+        result.push_back({point, low, high});
+        if (maxResults > 0 && result.size() >= maxResults) {
+          break;
+        }
+      }
+    }
+    if (maxResults > 0 && result.size() >= maxResults) {
+      break;
+    }
+    active.push_back(entry);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const Intersection &a, const Intersection &b) {
+              return a.first != b.first ? a.first < b.first
+                                        : a.second < b.second;
+            });
+  return result;
+}
+
+bool SegmentIntersector::hasSelfIntersections(const PathView &path,
+                                              bool closed) {
+  return !findSelfIntersections(path, closed, 1).empty();
+}
+
+}  // namespace cnc
+}  // namespace nwss
@@ -1,7 +1,10 @@
 #include "core/svg_parser.h"
 
-#include <cstdio>
+#include <algorithm>
+#include <iomanip>
 
+#include "core/log.h"
+#include "core/metrics.h"
 #include "nanosvg.h"
 
 namespace nwss {
@@ -13,6 +16,8 @@ SVGParser::~SVGParser() { freeImage(); }
 
 bool SVGParser::loadFromFile(const std::string &filename,
                              const std::string &units, float dpi) {
+  ScopedStageTimer timer("parse");
+
   // Free any previously loaded image
   freeImage();
 
@@ -167,24 +172,24 @@ void SVGParser::calculateContentBounds(SVGContentBounds &bounds) const {
        shape = shape->next) {
     shapeCount++;
 
-    // Debug: Print shape information
-    printf(
-        "Shape %d: bounds[%.3f, %.3f, %.3f, %.3f], visible=%d, fill=%d, "
-        "stroke=%d\n",
-        shapeCount, shape->bounds[0], shape->bounds[1], shape->bounds[2],
-        shape->bounds[3], (shape->flags & NSVG_FLAGS_VISIBLE) ? 1 : 0,
-        shape->fill.type, shape->stroke.type);
+    NWSS_LOG_DEBUG("Shape " << shapeCount << ": bounds[" << std::fixed
+                   << std::setprecision(3) << shape->bounds[0] << ", "
+                   << shape->bounds[1] << ", " << shape->bounds[2] << ", "
+                   << shape->bounds[3] << "], visible="
+                   << ((shape->flags & NSVG_FLAGS_VISIBLE) ? 1 : 0)
+                   << ", fill=" << static_cast<int>(shape->fill.type)
+                   << ", stroke=" << static_cast<int>(shape->stroke.type));
 
     // Skip invisible shapes
     if (!(shape->flags & NSVG_FLAGS_VISIBLE)) {
-      printf("  Skipping invisible shape\n");
+      NWSS_LOG_DEBUG("  Skipping invisible shape");
       continue;
     }
 
     // Skip shapes with no fill and no stroke
     if (shape->fill.type == NSVG_PAINT_NONE &&
         shape->stroke.type == NSVG_PAINT_NONE) {
-      printf("  Skipping shape with no fill/stroke\n");
+      NWSS_LOG_DEBUG("  Skipping shape with no fill/stroke");
       continue;
     }
 
@@ -196,8 +201,10 @@ void SVGParser::calculateContentBounds(SVGContentBounds &bounds) const {
       bounds.maxY = shape->bounds[3];
       bounds.isEmpty = false;
       firstShape = false;
-      printf("  Using as first shape bounds: [%.3f, %.3f, %.3f, %.3f]\n",
-             bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+      NWSS_LOG_DEBUG("  Using as first shape bounds: ["
+                     << std::fixed << std::setprecision(3) << bounds.minX
+                     << ", " << bounds.minY << ", " << bounds.maxX << ", "
+                     << bounds.maxY << "]");
     } else {
       // Expand bounds to include this shape
       float oldMinX = bounds.minX, oldMinY = bounds.minY, oldMaxX = bounds.maxX,
@@ -206,11 +213,11 @@ void SVGParser::calculateContentBounds(SVGContentBounds &bounds) const {
       bounds.minY = std::min(bounds.minY, shape->bounds[1]);
       bounds.maxX = std::max(bounds.maxX, shape->bounds[2]);
       bounds.maxY = std::max(bounds.maxY, shape->bounds[3]);
-      printf(
-          "  Expanding bounds from [%.3f, %.3f, %.3f, %.3f] to [%.3f, %.3f, "
-          "%.3f, %.3f]\n",
-          oldMinX, oldMinY, oldMaxX, oldMaxY, bounds.minX, bounds.minY,
-          bounds.maxX, bounds.maxY);
+      NWSS_LOG_DEBUG("  Expanding bounds from ["
+                     << std::fixed << std::setprecision(3) << oldMinX << ", "
+                     << oldMinY << ", " << oldMaxX << ", " << oldMaxY
+                     << "] to [" << bounds.minX << ", " << bounds.minY << ", "
+                     << bounds.maxX << ", " << bounds.maxY << "]");
     }
   }
 
@@ -0,0 +1,139 @@
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// Shared state of one parallelFor call. Helpers that start after the loop
+// has finished only touch the counters, never the task.
+struct LoopState {
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> completed{0};
+  size_t count = 0;
+  const std::function<void(size_t)> *task = nullptr;
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::exception_ptr error;
+};
+
+void runLoop(LoopState &state) {
+  size_t finished = 0;
+  for (;;) {
+    size_t index = state.next.fetch_add(1);
+    if (index >= state.count) {
+      break;
+    }
+    try {
+      (*state.task)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (!state.error) {
+        state.error = std::current_exception();
+      }
+    }
+    ++finished;
+  }
+
+  if (finished > 0 &&
+      state.completed.fetch_add(finished) + finished == state.count) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done.notify_all();
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t workerCount) {
+  m_workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    m_workers.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+ThreadPool &ThreadPool::shared() {
+  // The calling thread also works on every loop, so one fewer worker than
+  // hardware threads keeps all cores busy without oversubscribing
+  static ThreadPool pool(resolveThreadCount(0) - 1);
+  return pool;
+}
+
+size_t ThreadPool::resolveThreadCount(int requested) {
+  if (requested > 0) {
+    return static_cast<size_t>(requested);
+  }
+  unsigned int hardware = std::thread::hardware_concurrency();
+  return hardware > 0 ? hardware : 1;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t maxThreads,
+                             const std::function<void(size_t)> &task) {
+  if (count == 0) {
+    return;
+  }
+
+  size_t threads = std::min({maxThreads, m_workers.size() + 1, count});
+  if (threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<LoopState>();
+  state->count = count;
+  state->task = &task;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 1; i < threads; ++i) {
+      m_queue.emplace_back([state] { runLoop(*state); });
+    }
+  }
+  m_condition.notify_all();
+
+  runLoop(*state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done.wait(
+      lock, [&state, count] { return state->completed.load() == count; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+void ThreadPool::workerLoop() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+      if (m_stopping && m_queue.empty()) {
+        return;
+      }
+      job = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+    job();
+  }
+}
+
+}  // namespace cnc
+}  // namespace nwss
@@ -2,6 +2,7 @@
 #include "core/tool.h"
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 
@@ -355,6 +356,8 @@ bool ToolRegistry::loadFromFile(const std::string &filename) {
       currentTool.fluteLength = std::stod(value);
     } else if (key == "fluteCount") {
       currentTool.fluteCount = std::stoi(value);
+    } else if (key == "tipAngle") {
+      currentTool.tipAngle = std::stod(value);
     } else if (key == "material") {
       if (value == "HSS")
         currentTool.material = ToolMaterial::HSS;
@@ -436,6 +439,7 @@ bool ToolRegistry::saveToFile(const std::string &filename) const {
     file << "length=" << tool.length << "\n";
     file << "fluteLength=" << tool.fluteLength << "\n";
     file << "fluteCount=" << tool.fluteCount << "\n";
+    file << "tipAngle=" << tool.tipAngle << "\n";
     file << "material=";
     switch (tool.material) {
       case ToolMaterial::HSS:
@@ -520,6 +524,7 @@ void ToolRegistry::loadDefaultTools() {
   tool.length = 38.0;
   tool.fluteLength = 8.0;
   tool.fluteCount = 1;
+  tool.tipAngle = 60.0;
   tool.material = ToolMaterial::CARBIDE;
   tool.maxDepthOfCut = 0.2;
   tool.maxFeedRate = 300.0;
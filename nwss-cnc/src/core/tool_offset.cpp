@@ -3,12 +3,25 @@
 
 #include <algorithm>
 #include <cmath>
-#include <iostream>
 #include <limits>
 
+#include "core/fixed_point.h"
+#include "core/log.h"
+#include "core/medial_axis.h"
+#include "core/metrics.h"
+#include "core/segment_grid.h"
+#include "core/segment_intersector.h"
+
 namespace nwss {
 namespace cnc {
 
+namespace {
+
+// Most self-intersection points kept on an offset result
+const size_t kMaxReportedIntersections = 1000;
+
+}  // namespace
+
 // ================================
 // Main Tool Offset Implementation
 // ================================
@@ -20,8 +33,8 @@ ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
 
   // Reduced debug output for efficiency
   if (originalPaths.size() <= 5) {
-    std::cout << "DEBUG: ToolOffset called - paths: " << originalPaths.size()
-              << ", diameter: " << toolDiameter << "mm" << std::endl;
+    NWSS_LOG_DEBUG("ToolOffset called - paths: " << originalPaths.size()
+                   << ", diameter: " << toolDiameter << "mm");
   }
 
   if (originalPaths.empty()) {
@@ -34,44 +47,18 @@ ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
     return result;
   }
 
-  // Initialize result statistics
-  result.originalPathCount = originalPaths.size();
-  for (const auto &path : originalPaths) {
-    result.originalTotalLength += calculatePathLength(path);
-  }
-
-  // Clean input paths first
-  auto cleanedPaths = cleanupPaths(originalPaths, options.precision);
-  if (cleanedPaths.empty()) {
-    addError(result, "All input paths were invalid or degenerate");
-    return result;
-  }
-
-  if (cleanedPaths.size() != originalPaths.size()) {
-    addWarning(result, "Some input paths were removed during cleanup");
-  }
-
-  // Validate tool size against features
-  std::vector<std::string> validationWarnings;
-  if (!validateToolForPaths(cleanedPaths, toolDiameter, validationWarnings)) {
-    for (const auto &warning : validationWarnings) {
-      addWarning(result, warning);
-    }
-  }
-
-  // Convert paths to Clipper2 format
-  auto clipperPaths = pathsToClipper(cleanedPaths, options.scaleFactor);
-  if (clipperPaths.empty()) {
-    addError(result, "Failed to convert paths to Clipper2 format");
+  std::vector<Path> cleanedPaths;
+  OffsetEngine engine(getEngineOptions(options));
+  if (!prepareOffsetInput(originalPaths, toolDiameter, options, result,
+                          cleanedPaths, engine)) {
     return result;
   }
 
-  // Reduced debug output
-
   // Calculate offset amount
+  if (offsetDirection == ToolOffsetDirection::AUTO) {
+    offsetDirection = determineOptimalOffsetDirection(cleanedPaths);
+  }
   double offsetAmount = 0.0;
-  bool needsOffset = true;
-
   switch (offsetDirection) {
     case ToolOffsetDirection::INSIDE:
       offsetAmount = -(toolDiameter / 2.0);
@@ -80,86 +67,321 @@ ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
       offsetAmount = toolDiameter / 2.0;
       break;
     case ToolOffsetDirection::ON_PATH:
+    case ToolOffsetDirection::AUTO:
+      // No offset needed - the engine returns the cleaned paths
       offsetAmount = 0.0;
-      needsOffset = false;
       break;
-    case ToolOffsetDirection::AUTO:
-      offsetDirection = determineOptimalOffsetDirection(cleanedPaths);
-      return calculateToolOffset(originalPaths, toolDiameter, offsetDirection,
-                                 options);
   }
 
   // Apply offset using Clipper2
-  Clipper2Lib::Paths64 offsetPaths;
+  std::vector<Clipper2Lib::Paths64> offsetPaths;
+  std::string error;
+  if (!engine.offset({offsetAmount}, offsetPaths, error)) {
+    addError(result, error);
+    return result;
+  }
 
-  if (!needsOffset) {
-    // No offset needed - just return cleaned paths
-    offsetPaths = clipperPaths;
-  } else {
-    // Set up Clipper offset
-    Clipper2Lib::ClipperOffset clipperOffset(
-        options.miterLimit, options.arcTolerance * options.scaleFactor);
+  finishOffsetResult(offsetPaths[0], cleanedPaths, offsetAmount, options,
+                     result);
+
+  // Only show summary for small numbers of paths to avoid flooding
+  if (result.success && originalPaths.size() <= 5) {
+    NWSS_LOG_DEBUG("Tool offset completed - " << result.originalPathCount
+                   << " -> " << result.resultPathCount << " paths");
+  } else if (!result.success) {
+    NWSS_LOG_DEBUG("Tool offset failed with " << result.errors.size()
+                   << " errors");
+  }
 
-    // Add paths with appropriate join/end types
-    for (const auto &path : clipperPaths) {
-      bool isClosed = isPathClosed(clipperToPath(path, options.scaleFactor));
-      Clipper2Lib::JoinType joinType = getJoinType(options);
-      Clipper2Lib::EndType endType = getEndType(isClosed);
+  return result;
+}
 
-      clipperOffset.AddPath(path, joinType, endType);
+ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
+    const PathView &originalPath, double toolDiameter,
+    ToolOffsetDirection offsetDirection, const OffsetOptions &options) {
+  return calculateToolOffset(std::vector<Path>{originalPath.toPath()},
+                             toolDiameter, offsetDirection, options);
+}
+
+ToolOffset::BatchOffsetResult ToolOffset::calculateBatchToolOffset(
+    const std::vector<Path> &originalPaths, double toolDiameter,
+    ToolOffsetDirection offsetDirection, const OffsetOptions &options) {
+  BatchOffsetResult result;
+  result.mergedInto.assign(originalPaths.size(), -1);
+
+  if (originalPaths.empty()) {
+    result.errors.push_back("No input paths provided");
+    return result;
+  }
+
+  if (toolDiameter <= 0) {
+    result.errors.push_back("Invalid tool diameter: " +
+                            std::to_string(toolDiameter));
+    return result;
+  }
+
+  // Clean every contour once, remembering where it came from
+  std::vector<Path> cleanedPaths;
+  std::vector<size_t> cleanedSource;
+  cleanedPaths.reserve(originalPaths.size());
+  cleanedSource.reserve(originalPaths.size());
+  Path cleaned;
+  for (size_t i = 0; i < originalPaths.size(); ++i) {
+    if (cleanupPath(originalPaths[i], options.precision, cleaned)) {
+      cleanedPaths.push_back(std::move(cleaned));
+      cleanedSource.push_back(i);
     }
+  }
+  if (cleanedPaths.empty()) {
+    result.errors.push_back("All input paths were invalid or degenerate");
+    return result;
+  }
+  if (cleanedPaths.size() != originalPaths.size()) {
+    result.warnings.push_back("Some input paths were removed during cleanup");
+  }
 
-    // Execute offset
-    double scaledOffset = offsetAmount * options.scaleFactor;
+  if (offsetDirection == ToolOffsetDirection::AUTO) {
+    offsetDirection = determineOptimalOffsetDirection(cleanedPaths);
+  }
+  result.direction = offsetDirection;
+  if (offsetDirection == ToolOffsetDirection::ON_PATH) {
+    // Nothing to offset; callers keep the original paths
+    result.success = true;
+    return result;
+  }
+  double radius = toolDiameter / 2.0;
+  double offsetAmount =
+      offsetDirection == ToolOffsetDirection::INSIDE ? -radius : radius;
+
+  // Convert once, splitting closed contours from open paths
+  Clipper2Lib::Paths64 closedPaths;
+  Clipper2Lib::Paths64 openPaths;
+  for (const auto &path : cleanedPaths) {
+    Clipper2Lib::Path64 clipperPath =
+        FixedPoint::toPath64(path, options.scaleFactor);
+    if (clipperPath.empty()) {
+      continue;
+    }
+    if (isPathClosed(path)) {
+      closedPaths.push_back(std::move(clipperPath));
+    } else {
+      openPaths.push_back(std::move(clipperPath));
+    }
+  }
 
-    try {
-      clipperOffset.Execute(scaledOffset, offsetPaths);
-    } catch (const std::exception &e) {
-      addError(result,
-               "Clipper2 offset execution failed: " + std::string(e.what()));
-      return result;
+  // Resolve nesting so holes get the opposite offset of their outlines,
+  // then offset everything in a single execution
+  Clipper2Lib::Paths64 offsetPaths;
+  try {
+    Clipper2Lib::ClipperOffset clipperOffset(
+        options.miterLimit, options.arcTolerance * options.scaleFactor);
+    if (!closedPaths.empty()) {
+      PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+      Clipper2Lib::Paths64 region =
+          Clipper2Lib::Union(closedPaths, Clipper2Lib::FillRule::EvenOdd);
+      clipperOffset.AddPaths(region, getJoinType(options), getEndType(true));
+    }
+    if (!openPaths.empty()) {
+      clipperOffset.AddPaths(openPaths, getJoinType(options),
+                             getEndType(false));
     }
+
+    PipelineProfiler::count(PipelineCounter::CLIPPER_CALLS);
+    PipelineProfiler::count(PipelineCounter::OFFSET_PASSES);
+    clipperOffset.Execute(offsetAmount * options.scaleFactor, offsetPaths);
+    result.clipperCalls = 1;
+  } catch (const std::exception &e) {
+    result.errors.push_back("Clipper2 offset execution failed: " +
+                            std::string(e.what()));
+    return result;
   }
 
-  // Convert back to Path objects
-  auto resultPaths = clipperToPaths(offsetPaths, options.scaleFactor);
+  // Index the input segments to attribute each ring to its inputs: every
+  // vertex of an offset ring lies about one radius from the contour that
+  // produced it
+  SegmentGrid grid;
+  for (size_t i = 0; i < cleanedPaths.size(); ++i) {
+    grid.addPath(cleanedPaths[i], cleanedSource[i],
+                 isPathClosed(cleanedPaths[i]));
+  }
+  grid.build();
+  double searchRadius = 2.0 * radius + options.precision;
 
-  // Filter out degenerate results
-  std::vector<Path> validPaths;
-  for (const auto &path : resultPaths) {
-    if (hasValidGeometry(path)) {
-      double pathLength = calculatePathLength(path);
-      double pathArea = 0.0;
-
-      // Calculate area for closed paths
-      if (isPathClosed(path)) {
-        const auto &points = path.getPoints();
-        if (points.size() >= 3) {
-          // Shoelace formula
-          double area = 0.0;
-          for (size_t i = 0; i < points.size(); ++i) {
-            size_t j = (i + 1) % points.size();
-            area += points[i].x * points[j].y - points[j].x * points[i].y;
-          }
-          pathArea = std::abs(area) / 2.0;
+  std::vector<size_t> votes(originalPaths.size(), 0);
+  std::vector<size_t> voters;
+  std::vector<bool> ownsRing(originalPaths.size(), false);
+  std::vector<int> absorbedBy(originalPaths.size(), -1);
+
+  for (const auto &clipperPath : offsetPaths) {
+    Path ring = FixedPoint::toPath(clipperPath, options.scaleFactor);
+    if (!isUsableOffsetPath(ring, options)) {
+      continue;
+    }
+
+    voters.clear();
+    for (const auto &point : ring.getPoints()) {
+      SegmentGrid::Match match;
+      if (grid.findNearest(point, searchRadius, match)) {
+        size_t source = grid.segment(match.segment).pathIndex;
+        if (votes[source]++ == 0) {
+          voters.push_back(source);
         }
       }
+    }
+    if (voters.empty()) {
+      result.warnings.push_back(
+          "An offset ring could not be matched to an input path");
+      continue;
+    }
 
-      // Check minimum feature size
-      bool isValid = true;
-      if (pathLength < options.minFeatureSize) {
-        isValid = false;
+    size_t owner = voters[0];
+    for (size_t source : voters) {
+      if (votes[source] > votes[owner]) {
+        owner = source;
       }
-
-      if (isPathClosed(path) &&
-          pathArea < (options.minFeatureSize * options.minFeatureSize)) {
-        isValid = false;
+    }
+    for (size_t source : voters) {
+      if (source != owner && absorbedBy[source] < 0) {
+        absorbedBy[source] = static_cast<int>(owner);
       }
+      votes[source] = 0;
+    }
 
-      if (isValid) {
-        validPaths.push_back(path);
-        result.resultTotalLength += pathLength;
-      }
+    ownsRing[owner] = true;
+    result.paths.push_back(std::move(ring));
+    result.sourceIndex.push_back(owner);
+  }
+
+  for (size_t i = 0; i < originalPaths.size(); ++i) {
+    if (!ownsRing[i]) {
+      result.mergedInto[i] = absorbedBy[i];
+    }
+  }
+
+  result.success = true;
+  NWSS_LOG_DEBUG("Batch tool offset completed - " << originalPaths.size()
+                 << " -> " << result.paths.size() << " paths");
+  return result;
+}
+
+std::vector<ToolOffset::OffsetResult> ToolOffset::calculateMultipleOffsets(
+    const std::vector<Path> &originalPaths, double toolDiameter,
+    const std::vector<double> &offsetDistances, const OffsetOptions &options) {
+  std::vector<OffsetResult> results;
+  if (offsetDistances.empty()) {
+    return results;
+  }
+
+  // Clean, check and convert the input once for every distance
+  OffsetResult base;
+  std::vector<Path> cleanedPaths;
+  OffsetEngine engine(getEngineOptions(options));
+  bool prepared = true;
+  if (originalPaths.empty()) {
+    addError(base, "No input paths provided");
+    prepared = false;
+  } else {
+    prepared = prepareOffsetInput(originalPaths, toolDiameter, options, base,
+                                  cleanedPaths, engine);
+  }
+
+  std::vector<Clipper2Lib::Paths64> offsetPaths;
+  std::string error;
+  if (prepared && !engine.offset(offsetDistances, offsetPaths, error)) {
+    addError(base, error);
+    prepared = false;
+  }
+  if (!prepared) {
+    results.assign(offsetDistances.size(), base);
+    return results;
+  }
+
+  results.reserve(offsetDistances.size());
+  for (size_t i = 0; i < offsetDistances.size(); ++i) {
+    results.push_back(base);
+    finishOffsetResult(offsetPaths[i], cleanedPaths, offsetDistances[i],
+                       options, results.back());
+  }
+
+  return results;
+}
+
+OffsetEngine::Options ToolOffset::getEngineOptions(
+    const OffsetOptions &options) {
+  OffsetEngine::Options engineOptions;
+  engineOptions.scale = options.scaleFactor;
+  engineOptions.miterLimit = options.miterLimit;
+  engineOptions.arcTolerance = options.arcTolerance;
+  engineOptions.joinType = getJoinType(options);
+  engineOptions.openEndType = getEndType(false);
+  engineOptions.threadCount = options.threadCount;
+  return engineOptions;
+}
+
+bool ToolOffset::prepareOffsetInput(const std::vector<Path> &originalPaths,
+                                    double toolDiameter,
+                                    const OffsetOptions &options,
+                                    OffsetResult &result,
+                                    std::vector<Path> &cleanedPaths,
+                                    OffsetEngine &engine) {
+  // Initialize result statistics
+  result.originalPathCount = originalPaths.size();
+  for (const auto &path : originalPaths) {
+    result.originalTotalLength += calculatePathLength(path);
+  }
+
+  // Clean input paths first
+  cleanedPaths = cleanupPaths(originalPaths, options.precision);
+  if (cleanedPaths.empty()) {
+    addError(result, "All input paths were invalid or degenerate");
+    return false;
+  }
+
+  if (cleanedPaths.size() != originalPaths.size()) {
+    addWarning(result, "Some input paths were removed during cleanup");
+  }
+
+  // Validate tool size against features
+  std::vector<std::string> validationWarnings;
+  if (toolDiameter > 0 &&
+      !validateToolForPaths(cleanedPaths, toolDiameter, validationWarnings)) {
+    for (const auto &warning : validationWarnings) {
+      addWarning(result, warning);
+    }
+  }
+
+  // Convert paths to Clipper2 format; each path is its own group, so
+  // Clipper2 orients every contour on its own
+  for (const auto &path : cleanedPaths) {
+    Clipper2Lib::Path64 clipperPath =
+        FixedPoint::toPath64(path, options.scaleFactor);
+    if (!clipperPath.empty()) {
+      bool isClosed =
+          FixedPoint::isClosed(clipperPath, 0.001, options.scaleFactor);
+      engine.addPath(clipperPath, isClosed);
+    }
+  }
+  if (engine.empty()) {
+    addError(result, "Failed to convert paths to Clipper2 format");
+    return false;
+  }
+  return true;
+}
+
+void ToolOffset::finishOffsetResult(const Clipper2Lib::Paths64 &offsetPaths,
+                                    const std::vector<Path> &cleanedPaths,
+                                    double offsetAmount,
+                                    const OffsetOptions &options,
+                                    OffsetResult &result) {
+  // Convert back to Path objects
+  auto resultPaths = FixedPoint::toPaths(offsetPaths, options.scaleFactor);
+
+  // Filter out degenerate results
+  std::vector<Path> validPaths;
+  for (const auto &path : resultPaths) {
+    if (isUsableOffsetPath(path, options)) {
+      validPaths.push_back(path);
+      result.resultTotalLength += calculatePathLength(path);
     }
   }
 
@@ -167,12 +389,11 @@ ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
   result.resultPathCount = validPaths.size();
   result.success = !validPaths.empty();
 
-  if (needsOffset && !validPaths.empty()) {
-    // Calculate actual offset distance for validation
-    if (!cleanedPaths.empty() && !validPaths.empty()) {
-      result.actualOffsetDistance =
-          calculateActualOffset(cleanedPaths[0], validPaths[0]);
-    }
+  if (offsetAmount != 0.0 && !validPaths.empty()) {
+    // Measure the actual offset distance for validation
+    result.quality = measureOffsetQuality(cleanedPaths, validPaths,
+                                          std::abs(offsetAmount));
+    result.actualOffsetDistance = result.quality.meanDistance;
   }
 
   // Validate results if requested
@@ -189,46 +410,9 @@ ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
     result.maxFeatureSize = validation.maxFeatureSize;
     result.hasDegenerate = validation.hasDegenerate;
     result.hasSelfIntersections = validation.hasSelfIntersections;
+    result.selfIntersectionPoints =
+        std::move(validation.selfIntersectionPoints);
   }
-
-  // Only show summary for small numbers of paths to avoid flooding
-  if (result.success && originalPaths.size() <= 5) {
-    std::cout << "DEBUG: Tool offset completed - " << result.originalPathCount
-              << " -> " << result.resultPathCount << " paths" << std::endl;
-  } else if (!result.success) {
-    std::cout << "DEBUG: Tool offset failed with " << result.errors.size()
-              << " errors" << std::endl;
-  }
-
-  return result;
-}
-
-ToolOffset::OffsetResult ToolOffset::calculateToolOffset(
-    const Path &originalPath, double toolDiameter,
-    ToolOffsetDirection offsetDirection, const OffsetOptions &options) {
-  return calculateToolOffset(std::vector<Path>{originalPath}, toolDiameter,
-                             offsetDirection, options);
-}
-
-std::vector<ToolOffset::OffsetResult> ToolOffset::calculateMultipleOffsets(
-    const std::vector<Path> &originalPaths, double toolDiameter,
-    const std::vector<double> &offsetDistances, const OffsetOptions &options) {
-  std::vector<OffsetResult> results;
-  results.reserve(offsetDistances.size());
-
-  for (double distance : offsetDistances) {
-    ToolOffsetDirection direction = (distance >= 0)
-                                        ? ToolOffsetDirection::OUTSIDE
-                                        : ToolOffsetDirection::INSIDE;
-    double actualDiameter =
-        std::abs(distance) * 2.0;  // Convert offset to diameter
-
-    auto result =
-        calculateToolOffset(originalPaths, actualDiameter, direction, options);
-    results.push_back(result);
-  }
-
-  return results;
 }
 
 // ================================
@@ -303,46 +487,93 @@ ToolOffsetDirection ToolOffset::determineOptimalOffsetDirection(
   }
 }
 
-double ToolOffset::calculateMinimumFeatureSize(const std::vector<Path> &paths) {
-  if (paths.empty()) {
-    return 0.0;
+ToolOffset::OffsetQualityReport ToolOffset::measureOffsetQuality(
+    const std::vector<Path> &originalPaths,
+    const std::vector<Path> &offsetPaths, double expectedOffset) {
+  OffsetQualityReport report;
+  report.expectedDistance = expectedOffset;
+
+  SegmentGrid grid;
+  for (size_t i = 0; i < originalPaths.size(); ++i) {
+    const auto &path = originalPaths[i];
+    if (path.size() >= 2) {
+      grid.addPath(path, i, isPathClosed(path));
+    }
   }
+  if (grid.empty()) {
+    return report;
+  }
+  grid.build();
 
-  double minSize = std::numeric_limits<double>::max();
-
-  for (const auto &path : paths) {
-    const auto &points = path.getPoints();
-    if (points.size() < 2) continue;
-
-    // Calculate minimum segment length
-    for (size_t i = 0; i < points.size() - 1; ++i) {
-      double dx = points[i + 1].x - points[i].x;
-      double dy = points[i + 1].y - points[i].y;
-      double length = std::sqrt(dx * dx + dy * dy);
-      if (length > 0.001) {  // Ignore tiny segments
-        minSize = std::min(minSize, length);
+  const double unlimited = std::numeric_limits<double>::infinity();
+  double totalDistance = 0.0;
+  SegmentGrid::Match match;
+  for (const auto &path : offsetPaths) {
+    for (const auto &point : path.getPoints()) {
+      if (!grid.findNearest(point, unlimited, match)) {
+        continue;
+      }
+      if (report.samples == 0 || match.distance < report.minDistance) {
+        report.minDistance = match.distance;
       }
+      report.maxDistance = std::max(report.maxDistance, match.distance);
+      report.maxDeviation = std::max(
+          report.maxDeviation, std::abs(match.distance - expectedOffset));
+      totalDistance += match.distance;
+      report.samples++;
     }
+  }
+  if (report.samples > 0) {
+    report.meanDistance = totalDistance / report.samples;
+  }
+  return report;
+}
 
-    // For closed paths, also check minimum distance between non-adjacent
-    // segments
-    if (isPathClosed(path) && points.size() >= 4) {
-      for (size_t i = 0; i < points.size() - 1; ++i) {
-        for (size_t j = i + 2; j < points.size() - 1; ++j) {
-          if (j == points.size() - 2 && i == 0) continue;  // Skip adjacent
+double ToolOffset::calculateMinimumFeatureSize(const std::vector<Path> &paths) {
+  // Narrowest medial disc between facing walls of each closed path, inside
+  // it and outside it; the spacing of flattened curve points is not a
+  // feature and is not reported. Each search only looks for discs narrower
+  // than the narrowest found so far.
+  MedialAxis axis;
+  double minFeatureSize = 0.0;
+  for (const auto &path : paths) {
+    if (!isPathClosed(path)) {
+      continue;
+    }
+    double width = minFeatureSize;
+    if (axis.narrowestWidth({PathView(path)}, {0}, width)) {
+      minFeatureSize = width;
+    }
 
-          double dx = points[i].x - points[j].x;
-          double dy = points[i].y - points[j].y;
-          double dist = std::sqrt(dx * dx + dy * dy);
-          if (dist > 0.001) {
-            minSize = std::min(minSize, dist);
-          }
-        }
-      }
+    // Outside, the path is a hole in a frame; discs touching the frame are
+    // at least as wide as the gap to it, so a gap of the path's extent (or
+    // the narrowest width so far) leaves them out
+    const auto &points = path.getPoints();
+    double minX = points[0].x;
+    double minY = points[0].y;
+    double maxX = minX;
+    double maxY = minY;
+    for (const auto &point : points) {
+      minX = std::min(minX, point.x);
+      minY = std::min(minY, point.y);
+      maxX = std::max(maxX, point.x);
+      maxY = std::max(maxY, point.y);
+    }
+    double gap = std::hypot(maxX - minX, maxY - minY);
+    if (minFeatureSize > 0.0) {
+      gap = std::min(gap, minFeatureSize);
+    }
+    Path frame({Point2D(minX - gap, minY - gap),
+                Point2D(maxX + gap, minY - gap),
+                Point2D(maxX + gap, maxY + gap),
+                Point2D(minX - gap, maxY + gap)});
+    width = gap;
+    if (axis.narrowestWidth({PathView(frame), PathView(path)}, {0, 1},
+                            width)) {
+      minFeatureSize = width;
     }
   }
-
-  return (minSize == std::numeric_limits<double>::max()) ? 0.0 : minSize;
+  return minFeatureSize;
 }
 
 bool ToolOffset::hasFeaturesTooSmallForTool(const std::vector<Path> &paths,
@@ -359,40 +590,43 @@ std::vector<Path> ToolOffset::cleanupPaths(const std::vector<Path> &paths,
                                            double tolerance) {
   std::vector<Path> cleanedPaths;
 
+  Path cleanedPath;
   for (const auto &path : paths) {
-    if (!hasValidGeometry(path)) {
-      continue;
+    if (cleanupPath(path, tolerance, cleanedPath)) {
+      cleanedPaths.push_back(std::move(cleanedPath));
     }
+  }
 
-    const auto &points = path.getPoints();
-    if (points.size() < 2) {
-      continue;
-    }
+  return cleanedPaths;
+}
 
-    // Remove duplicate and very close points
-    std::vector<Point2D> cleanedPoints;
-    cleanedPoints.push_back(points[0]);
+bool ToolOffset::cleanupPath(const Path &path, double tolerance,
+                             Path &cleaned) {
+  cleaned = Path();
+  if (!hasValidGeometry(path)) {
+    return false;
+  }
 
-    for (size_t i = 1; i < points.size(); ++i) {
-      double dx = points[i].x - cleanedPoints.back().x;
-      double dy = points[i].y - cleanedPoints.back().y;
-      double dist = std::sqrt(dx * dx + dy * dy);
+  const auto &points = path.getPoints();
+  if (points.size() < 2) {
+    return false;
+  }
 
-      if (dist > tolerance) {
-        cleanedPoints.push_back(points[i]);
-      }
-    }
+  // Remove duplicate and very close points
+  cleaned.reserve(points.size());
+  cleaned.addPoint(points[0]);
+  for (size_t i = 1; i < points.size(); ++i) {
+    const Point2D &last = cleaned.getPoints().back();
+    double dx = points[i].x - last.x;
+    double dy = points[i].y - last.y;
+    double dist = std::sqrt(dx * dx + dy * dy);
 
-    if (cleanedPoints.size() >= 2) {
-      Path cleanedPath;
-      for (const auto &point : cleanedPoints) {
-        cleanedPath.addPoint(point);
-      }
-      cleanedPaths.push_back(cleanedPath);
+    if (dist > tolerance) {
+      cleaned.addPoint(points[i]);
     }
   }
 
-  return cleanedPaths;
+  return cleaned.size() >= 2;
 }
 
 std::vector<Path> ToolOffset::simplifyPaths(const std::vector<Path> &paths,
@@ -443,93 +677,41 @@ std::vector<Path> ToolOffset::simplifyPaths(const std::vector<Path> &paths,
 }
 
 // ================================
-// Clipper2 Conversion Methods
+// Helper Methods
 // ================================
 
-Clipper2Lib::Paths64 ToolOffset::pathsToClipper(const std::vector<Path> &paths,
-                                                int scaleFactor) {
-  Clipper2Lib::Paths64 clipperPaths;
-  clipperPaths.reserve(paths.size());
-
-  for (const auto &path : paths) {
-    auto clipperPath = pathToClipper(path, scaleFactor);
-    if (!clipperPath.empty()) {
-      clipperPaths.push_back(clipperPath);
-    }
-  }
-
-  return clipperPaths;
-}
-
-std::vector<Path> ToolOffset::clipperToPaths(
-    const Clipper2Lib::Paths64 &clipperPaths, int scaleFactor) {
-  std::vector<Path> paths;
-  paths.reserve(clipperPaths.size());
-
-  for (const auto &clipperPath : clipperPaths) {
-    auto path = clipperToPath(clipperPath, scaleFactor);
-    if (!path.empty()) {
-      paths.push_back(path);
-    }
+bool ToolOffset::isUsableOffsetPath(const Path &path,
+                                    const OffsetOptions &options) {
+  if (!hasValidGeometry(path)) {
+    return false;
   }
 
-  return paths;
-}
-
-Clipper2Lib::Path64 ToolOffset::pathToClipper(const Path &path,
-                                              int scaleFactor) {
-  Clipper2Lib::Path64 clipperPath;
-  const auto &points = path.getPoints();
-
-  if (points.empty()) {
-    return clipperPath;
+  // Check minimum feature size
+  if (calculatePathLength(path) < options.minFeatureSize) {
+    return false;
   }
 
-  clipperPath.reserve(points.size());
-  double scale = static_cast<double>(scaleFactor);
-
-  for (const auto &point : points) {
-    // Validate input coordinates
-    if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
-      continue;
+  // Calculate area for closed paths
+  if (isPathClosed(path)) {
+    const auto &points = path.getPoints();
+    double pathArea = 0.0;
+    if (points.size() >= 3) {
+      // Shoelace formula
+      double area = 0.0;
+      for (size_t i = 0; i < points.size(); ++i) {
+        size_t j = (i + 1) % points.size();
+        area += points[i].x * points[j].y - points[j].x * points[i].y;
+      }
+      pathArea = std::abs(area) / 2.0;
     }
-
-    // Scale and round to integer coordinates
-    int64_t x = static_cast<int64_t>(std::round(point.x * scale));
-    int64_t y = static_cast<int64_t>(std::round(point.y * scale));
-
-    clipperPath.push_back(Clipper2Lib::Point64(x, y));
-  }
-
-  return clipperPath;
-}
-
-Path ToolOffset::clipperToPath(const Clipper2Lib::Path64 &clipperPath,
-                               int scaleFactor) {
-  Path path;
-  if (clipperPath.empty()) {
-    return path;
-  }
-
-  double scale = 1.0 / static_cast<double>(scaleFactor);
-
-  for (const auto &point : clipperPath) {
-    double x = static_cast<double>(point.x) * scale;
-    double y = static_cast<double>(point.y) * scale;
-
-    // Validate coordinates
-    if (std::isfinite(x) && std::isfinite(y)) {
-      path.addPoint(Point2D(x, y));
+    if (pathArea < (options.minFeatureSize * options.minFeatureSize)) {
+      return false;
     }
   }
 
-  return path;
+  return true;
 }
 
-// ================================
-// Helper Methods
-// ================================
-
 double ToolOffset::calculateOffsetAmount(double toolDiameter,
                                          ToolOffsetDirection direction,
                                          bool isClockwise) {
@@ -616,7 +798,7 @@ ToolOffset::OffsetResult ToolOffset::validateOffsetResult(
     validation.minFeatureSize = minSize;
     validation.maxFeatureSize = minSize;  // Simplified for now
 
-    if (minSize < options.minFeatureSize) {
+    if (minSize > 0 && minSize < options.minFeatureSize) {
       addWarning(validation,
                  "Result contains features smaller than minimum size");
     }
@@ -631,13 +813,20 @@ ToolOffset::OffsetResult ToolOffset::validateOffsetResult(
     }
   }
 
-  // Check for self-intersections
+  // Check for self-intersections, keeping the points for display
+  auto &points = validation.selfIntersectionPoints;
   for (const auto &path : offsetPaths) {
-    if (hasSelfIntersections(path)) {
-      validation.hasSelfIntersections = true;
-      addWarning(validation, "Result contains self-intersections");
+    if (points.size() >= kMaxReportedIntersections) {
       break;
     }
+    for (const auto &hit : SegmentIntersector::findSelfIntersections(
+             path, false, kMaxReportedIntersections - points.size())) {
+      points.push_back(hit.point);
+    }
+  }
+  if (!points.empty()) {
+    validation.hasSelfIntersections = true;
+    addWarning(validation, "Result contains self-intersections");
   }
 
   validation.success = validation.errors.empty();
@@ -645,58 +834,9 @@ ToolOffset::OffsetResult ToolOffset::validateOffsetResult(
 }
 
 double ToolOffset::calculatePathLength(const Path &path) {
-  const auto &points = path.getPoints();
-  if (points.size() < 2) {
-    return 0.0;
-  }
-
-  double length = 0.0;
-  for (size_t i = 0; i < points.size() - 1; ++i) {
-    double dx = points[i + 1].x - points[i].x;
-    double dy = points[i + 1].y - points[i].y;
-    length += std::sqrt(dx * dx + dy * dy);
-  }
-
-  return length;
-}
-
-double ToolOffset::calculateActualOffset(const Path &original,
-                                         const Path &offset) {
-  if (original.empty() || offset.empty()) {
-    return 0.0;
-  }
-
-  const auto &origPoints = original.getPoints();
-  const auto &offsetPoints = offset.getPoints();
-
-  if (origPoints.empty() || offsetPoints.empty()) {
-    return 0.0;
-  }
-
-  // For closed paths, calculate the actual offset by finding the minimum
-  // distance between any point on the original path and the offset path
-  double minDistance = std::numeric_limits<double>::max();
-
-  // Sample a few points to estimate the offset
-  size_t sampleCount = std::min<size_t>(5, origPoints.size());
-  for (size_t i = 0; i < sampleCount; ++i) {
-    size_t origIndex = (i * origPoints.size()) / sampleCount;
-    const Point2D &origPoint = origPoints[origIndex];
-
-    // Find closest point on offset path
-    double closestDist = std::numeric_limits<double>::max();
-    for (const auto &offsetPoint : offsetPoints) {
-      double dx = offsetPoint.x - origPoint.x;
-      double dy = offsetPoint.y - origPoint.y;
-      double dist = std::sqrt(dx * dx + dy * dy);
-      closestDist = std::min(closestDist, dist);
-    }
-
-    minDistance = std::min(minDistance, closestDist);
-  }
-
-  return (minDistance == std::numeric_limits<double>::max()) ? 0.0
-                                                             : minDistance;
+  // Cached on the path, so the usability check, the statistics and the
+  // validation of a result share one pass
+  return path.length();
 }
 
 bool ToolOffset::hasValidGeometry(const Path &path) {
@@ -719,39 +859,7 @@ bool ToolOffset::hasValidGeometry(const Path &path) {
 }
 
 bool ToolOffset::hasSelfIntersections(const Path &path) {
-  const auto &points = path.getPoints();
-  if (points.size() < 4) {
-    return false;  // Need at least 4 points to self-intersect
-  }
-
-  // Simple check for self-intersections (could be more sophisticated)
-  for (size_t i = 0; i < points.size() - 1; ++i) {
-    for (size_t j = i + 2; j < points.size() - 1; ++j) {
-      if (j == points.size() - 2 && i == 0) continue;  // Skip adjacent segments
-
-      // Check if segments i and j intersect
-      // This is a simplified check - a full implementation would use line-line
-      // intersection
-      const Point2D &p1 = points[i];
-      const Point2D &p2 = points[i + 1];
-      const Point2D &p3 = points[j];
-      const Point2D &p4 = points[j + 1];
-
-      // Simple bounding box check
-      double minX1 = std::min(p1.x, p2.x), maxX1 = std::max(p1.x, p2.x);
-      double minY1 = std::min(p1.y, p2.y), maxY1 = std::max(p1.y, p2.y);
-      double minX2 = std::min(p3.x, p4.x), maxX2 = std::max(p3.x, p4.x);
-      double minY2 = std::min(p3.y, p4.y), maxY2 = std::max(p3.y, p4.y);
-
-      if (maxX1 >= minX2 && maxX2 >= minX1 && maxY1 >= minY2 &&
-          maxY2 >= minY1) {
-        // Bounding boxes overlap - potential intersection
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return SegmentIntersector::hasSelfIntersections(path, false);
 }
 
 void ToolOffset::addWarning(OffsetResult &result, const std::string &message) {
@@ -0,0 +1,778 @@
+#include "core/toolpath_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "core/box_grid.h"
+#include "core/fixed_point.h"
+#include "core/log.h"
+#include "core/metrics.h"
+
+namespace nwss {
+namespace cnc {
+
+namespace {
+
+// Moves that gain less than this (mm) are not made
+const double kMinGain = 1e-9;
+
+// Longest run of toolpaths an Or-opt move takes along
+const size_t kMaxOrOptRun = 3;
+
+// No tour position
+const size_t kNone = std::numeric_limits<size_t>::max();
+
+// Check if a point is inside a closed ring (crossing number)
+bool ringContains(const PathView &ring, const Point2D &point) {
+  bool inside = false;
+  size_t j = ring.size() - 1;
+  for (size_t i = 0; i < ring.size(); j = i++) {
+    if ((ring[i].y > point.y) != (ring[j].y > point.y) &&
+        point.x < (ring[j].x - ring[i].x) * (point.y - ring[i].y) /
+                          (ring[j].y - ring[i].y) +
+                      ring[i].x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+// Unsigned area of a closed ring
+double ringArea(const PathView &ring) {
+  double area = 0.0;
+  size_t j = ring.size() - 1;
+  for (size_t i = 0; i < ring.size(); j = i++) {
+    area += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+  }
+  return std::fabs(area) / 2.0;
+}
+
+Clipper2Lib::Point64 toFixed(const Point2D &point) {
+  return Clipper2Lib::Point64(
+      std::llround(point.x * FixedPoint::kDefaultScale),
+      std::llround(point.y * FixedPoint::kDefaultScale));
+}
+
+// Index of the k-th point cut by a step through a path of n points
+size_t stepPoint(const ToolpathOptimizer::Step &step, size_t n, size_t k) {
+  if (step.reversed) {
+    return n - 1 - k;
+  }
+  return step.seam == 0 ? k : (step.seam + k) % (n - 1);
+}
+
+// Copy a path turned to the entry of a step
+Path turnedPath(const Path &path, const ToolpathOptimizer::Step &step) {
+  Path turned;
+  turned.reserve(path.size());
+  for (size_t k = 0; k < path.size(); ++k) {
+    size_t i = stepPoint(step, path.size(), k);
+    if (path.hasDepths()) {
+      turned.addPoint(path.getPoint(i), path.getDepth(i));
+    } else {
+      turned.addPoint(path.getPoint(i));
+    }
+  }
+  return turned;
+}
+
+// Rapid travel through paths cut in some order (mm)
+template <typename Paths>
+double orderTravel(const Paths &paths,
+                   const std::vector<ToolpathOptimizer::Step> &steps,
+                   const Point2D &start) {
+  double total = 0.0;
+  Point2D position = start;
+  for (const ToolpathOptimizer::Step &step : steps) {
+    PathView path = paths[step.index];
+    total += position.distanceTo(path[stepPoint(step, path.size(), 0)]);
+    position = path[stepPoint(step, path.size(), path.size() - 1)];
+  }
+  return total;
+}
+
+// Count and log the travel of an ordering
+void reportOrder(size_t count, const ToolpathOrderReport &report) {
+  PipelineProfiler::count(
+      PipelineCounter::RAPID_BEFORE,
+      static_cast<uint64_t>(std::llround(report.rapidBefore * 1000.0)));
+  PipelineProfiler::count(
+      PipelineCounter::RAPID_AFTER,
+      static_cast<uint64_t>(std::llround(report.rapidAfter * 1000.0)));
+  NWSS_LOG_DEBUG("Ordered " << count << " toolpaths: rapid travel "
+                 << report.rapidBefore << " -> " << report.rapidAfter
+                 << " mm (" << report.reversedPaths << " reversed, "
+                 << report.rotatedLoops << " loops re-seamed)");
+}
+
+/**
+ * A tour through one run of toolpaths. Position k cuts toolpath order[k]:
+ * a closed toolpath from its vertex seam[k] back to it, an open one from
+ * its last point if reversed[k] is set and from its first otherwise.
+ */
+class Tour {
+ public:
+  Tour(const std::vector<PathView> &paths, const Point2D &start,
+       const ToolpathOptimizer::Options &options)
+      : m_paths(paths),
+        m_start(start),
+        m_options(options),
+        m_closed(paths.size(), 0),
+        m_later(paths.size()),
+        m_earlier(paths.size()),
+        m_order(paths.size()),
+        m_reversed(paths.size(), 0),
+        m_seam(paths.size(), 0),
+        m_position(paths.size()) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+      const PathView &path = paths[i];
+      m_closed[i] = path.size() >= 4 &&
+                    path.front().distanceTo(path.back()) <=
+                        options.closedTolerance;
+    }
+    if (options.nesting != ToolpathOptimizer::Nesting::ANY) {
+      findNesting();
+    }
+  }
+
+  size_t size() const { return m_order.size(); }
+
+  // Get the travel of the tour (mm)
+  double travel() const {
+    double total = 0.0;
+    for (size_t k = 0; k < size(); ++k) {
+      total += before(k).distanceTo(entry(k));
+    }
+    return total;
+  }
+
+  // Start with the toolpaths in their given order and direction
+  bool useGivenOrder() {
+    for (size_t k = 0; k < size(); ++k) {
+      m_order[k] = k;
+      m_position[k] = k;
+      m_reversed[k] = 0;
+      m_seam[k] = 0;
+    }
+    for (size_t i = 0; i < size(); ++i) {
+      for (size_t later : m_later[i]) {
+        if (later < i) {
+          return false;  // The given order breaks a nesting constraint
+        }
+      }
+    }
+    return true;
+  }
+
+  void buildGreedy();
+  bool twoOptPass();
+  bool orOptPass();
+  void refineSeams();
+
+  // Add the steps of the tour; indices maps its toolpaths to the caller's
+  void getSteps(const std::vector<size_t> &indices,
+                std::vector<ToolpathOptimizer::Step> &steps,
+                ToolpathOrderReport &report) const;
+
+ private:
+  // Entry point of tour position k
+  Point2D entry(size_t k) const {
+    const PathView &path = m_paths[m_order[k]];
+    if (m_closed[m_order[k]]) {
+      return path[m_seam[k]];
+    }
+    return m_reversed[k] ? path.back() : path.front();
+  }
+
+  // Exit point of tour position k
+  Point2D exit(size_t k) const {
+    const PathView &path = m_paths[m_order[k]];
+    if (m_closed[m_order[k]]) {
+      return path[m_seam[k]];
+    }
+    return m_reversed[k] ? path.front() : path.back();
+  }
+
+  // Tool position before tour position k
+  Point2D before(size_t k) const { return k == 0 ? m_start : exit(k - 1); }
+
+  // Tour positions apart that a move may connect
+  size_t window() const {
+    return static_cast<size_t>(std::max(1, m_options.window));
+  }
+
+  // Number of vertices a closed toolpath may start at. Toolpaths cut at
+  // varying depths keep their start, which is where the bit meets the
+  // surface (a V-carve starts at a corner, at zero depth).
+  size_t seamCount(size_t item) const {
+    const PathView &path = m_paths[item];
+    return m_options.rotateLoops && !path.hasDepths() ? path.size() - 1 : 1;
+  }
+
+  // Check if a toolpath can be cut the other way round
+  bool flippable(size_t item) const {
+    return m_closed[item] || m_options.reverseOpenPaths;
+  }
+
+  // Check if tour positions first..last hold a toolpath that must be cut
+  // before a toolpath
+  bool isEarlierAt(size_t item, size_t first, size_t last) const {
+    return isAnyAt(m_earlier[item], first, last);
+  }
+
+  // Check if tour positions first..last hold a toolpath that must be cut
+  // after a toolpath
+  bool isLaterAt(size_t item, size_t first, size_t last) const {
+    return isAnyAt(m_later[item], first, last);
+  }
+
+  // Check if tour positions first..last hold any of some toolpaths
+  bool isAnyAt(const std::vector<size_t> &items, size_t first,
+               size_t last) const {
+    for (size_t item : items) {
+      if (m_position[item] >= first && m_position[item] <= last) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void findNesting();
+  void reverseRange(size_t first, size_t last);
+  void rotateRange(size_t first, size_t middle, size_t last);
+
+  const std::vector<PathView> &m_paths;
+  Point2D m_start;
+  const ToolpathOptimizer::Options &m_options;
+
+  std::vector<char> m_closed;
+  // Nested toolpaths that must be cut after and before each toolpath
+  std::vector<std::vector<size_t>> m_later;
+  std::vector<std::vector<size_t>> m_earlier;
+
+  std::vector<size_t> m_order;
+  std::vector<char> m_reversed;
+  std::vector<size_t> m_seam;
+  std::vector<size_t> m_position;  // Tour position of each toolpath
+};
+
+void Tour::findNesting() {
+  // Inner-first nesting is between closed toolpaths only; kept order is
+  // between any toolpath and those within its bounding box
+  bool keep = m_options.nesting == ToolpathOptimizer::Nesting::KEEP;
+  std::vector<size_t> nested;
+  std::vector<Clipper2Lib::Rect64> boxes;
+  std::vector<double> areas;
+  for (size_t i = 0; i < size(); ++i) {
+    if (!keep && !m_closed[i]) continue;
+    const PathView &points = m_paths[i];
+    Clipper2Lib::Point64 first = toFixed(points[0]);
+    Clipper2Lib::Rect64 box;
+    box.left = box.right = first.x;
+    box.top = box.bottom = first.y;
+    for (const auto &point : points) {
+      Clipper2Lib::Point64 fixed = toFixed(point);
+      box.left = std::min(box.left, fixed.x);
+      box.top = std::min(box.top, fixed.y);
+      box.right = std::max(box.right, fixed.x);
+      box.bottom = std::max(box.bottom, fixed.y);
+    }
+    nested.push_back(i);
+    boxes.push_back(box);
+    areas.push_back(keep ? 0.0 : ringArea(points));
+  }
+  if (nested.size() < 2) {
+    return;
+  }
+
+  BoxGrid grid(boxes);
+  for (size_t a = 0; a < nested.size(); ++a) {
+    Point2D point = m_paths[nested[a]].front();
+    for (size_t c : grid.candidates(toFixed(point))) {
+      if (c == a || !BoxGrid::covers(boxes[c], boxes[a])) continue;
+      size_t first = nested[a];
+      size_t second = nested[c];
+      if (keep) {
+        // Equal boxes: one constraint per pair
+        if (BoxGrid::covers(boxes[a], boxes[c]) && c < a) continue;
+        if (second < first) {
+          std::swap(first, second);
+        }
+      } else if (areas[c] <= areas[a] ||
+                 !ringContains(m_paths[second], point)) {
+        continue;
+      }
+      m_later[first].push_back(second);
+      m_earlier[second].push_back(first);
+    }
+  }
+}
+
+void Tour::buildGreedy() {
+  // Entries: either end of an open toolpath, the vertices of a closed one
+  struct Entry {
+    Point2D point;
+    size_t item;
+    size_t vertex;  // Seam of a closed toolpath, 1 = reversed if open
+  };
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < size(); ++i) {
+    const PathView &points = m_paths[i];
+    if (m_closed[i]) {
+      for (size_t v = 0; v < seamCount(i); ++v) {
+        entries.push_back({points[v], i, v});
+      }
+    } else {
+      entries.push_back({points.front(), i, 0});
+      if (m_options.reverseOpenPaths && points.size() > 1) {
+        entries.push_back({points.back(), i, 1});
+      }
+    }
+  }
+
+  // Square cells, about one per toolpath
+  double minX = std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxX = std::numeric_limits<double>::lowest();
+  double maxY = std::numeric_limits<double>::lowest();
+  for (const auto &entry : entries) {
+    minX = std::min(minX, entry.point.x);
+    minY = std::min(minY, entry.point.y);
+    maxX = std::max(maxX, entry.point.x);
+    maxY = std::max(maxY, entry.point.y);
+  }
+  double cellsPerAxis = std::ceil(std::sqrt(static_cast<double>(size())));
+  double cellSize =
+      std::max(std::max(maxX - minX, maxY - minY) / cellsPerAxis, 1e-6);
+  auto cellOf = [&](double value, double origin, size_t count) {
+    double cell = std::floor((value - origin) / cellSize);
+    return static_cast<size_t>(
+        std::max(0.0, std::min(cell, static_cast<double>(count - 1))));
+  };
+  size_t columns = static_cast<size_t>((maxX - minX) / cellSize) + 1;
+  size_t rows = static_cast<size_t>((maxY - minY) / cellSize) + 1;
+  auto cellIndex = [&](const Point2D &point) {
+    return cellOf(point.y, minY, rows) * columns +
+           cellOf(point.x, minX, columns);
+  };
+
+  std::vector<std::vector<Entry>> cells(columns * rows);
+  std::vector<size_t> live(cells.size(), 0);  // Entries of uncut toolpaths
+  for (const auto &entry : entries) {
+    size_t cell = cellIndex(entry.point);
+    cells[cell].push_back(entry);
+    live[cell]++;
+  }
+  entries.clear();
+
+  std::vector<char> cut(size(), 0);
+  std::vector<size_t> uncutEarlier(size(), 0);
+  for (size_t i = 0; i < size(); ++i) {
+    uncutEarlier[i] = m_earlier[i].size();
+  }
+
+  Point2D position = m_start;
+  for (size_t k = 0; k < size(); ++k) {
+    // Search rings of cells around the position until no closer entry can
+    // be in the next ring
+    size_t cx = cellOf(position.x, minX, columns);
+    size_t cy = cellOf(position.y, minY, rows);
+    size_t reach = std::max(std::max(cx, columns - 1 - cx),
+                            std::max(cy, rows - 1 - cy));
+    const Entry *best = nullptr;
+    double bestDistance = std::numeric_limits<double>::max();
+    auto searchCell = [&](size_t x, size_t y) {
+      size_t cell = y * columns + x;
+      if (live[cell] == 0) {
+        return;
+      }
+      std::vector<Entry> &bucket = cells[cell];
+      if (bucket.size() > 2 * live[cell]) {
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                    [&cut](const Entry &entry) {
+                                      return cut[entry.item] != 0;
+                                    }),
+                     bucket.end());
+      }
+      for (const auto &entry : bucket) {
+        if (cut[entry.item] || uncutEarlier[entry.item] > 0) continue;
+        double distance = position.distanceTo(entry.point);
+        if (distance < bestDistance) {
+          bestDistance = distance;
+          best = &entry;
+        }
+      }
+    };
+    for (size_t r = 0; r <= reach; ++r) {
+      size_t y0 = cy >= r ? cy - r : 0;
+      size_t y1 = std::min(rows - 1, cy + r);
+      size_t x0 = cx >= r ? cx - r : 0;
+      size_t x1 = std::min(columns - 1, cx + r);
+      for (size_t y = y0; y <= y1; ++y) {
+        bool edgeRow = y + r == cy || y == cy + r;
+        for (size_t x = x0; x <= x1; ++x) {
+          if (edgeRow || x + r == cx || x == cx + r) {
+            searchCell(x, y);
+          }
+        }
+      }
+      if (best && bestDistance <= r * cellSize) {
+        break;
+      }
+    }
+
+    // Nesting constraints never form a cycle, so one toolpath is always
+    // free to cut
+    size_t item = best->item;
+    m_order[k] = item;
+    m_position[item] = k;
+    if (m_closed[item]) {
+      m_seam[k] = best->vertex;
+    } else {
+      m_reversed[k] = best->vertex == 1;
+    }
+    position = exit(k);
+
+    cut[item] = 1;
+    for (size_t later : m_later[item]) {
+      uncutEarlier[later]--;
+    }
+    const PathView &points = m_paths[item];
+    if (m_closed[item]) {
+      for (size_t v = 0; v < seamCount(item); ++v) {
+        live[cellIndex(points[v])]--;
+      }
+    } else {
+      live[cellIndex(points.front())]--;
+      if (m_options.reverseOpenPaths && points.size() > 1) {
+        live[cellIndex(points.back())]--;
+      }
+    }
+  }
+}
+
+bool Tour::twoOptPass() {
+  bool improved = false;
+  for (size_t i = 0; i < size(); ++i) {
+    Point2D previous = before(i);
+    size_t last = std::min(size() - 1, i + window());
+    for (size_t j = i; j <= last; ++j) {
+      // Reversing the stretch i..j puts every toolpath in it after the
+      // ones that follow it now
+      size_t item = m_order[j];
+      if (!flippable(item) || (j > i && isEarlierAt(item, i, j - 1))) {
+        break;
+      }
+
+      Point2D first = entry(i);
+      Point2D end = exit(j);
+      double current = previous.distanceTo(first);
+      double reversed = previous.distanceTo(end);
+      if (j + 1 < size()) {
+        Point2D next = entry(j + 1);
+        current += end.distanceTo(next);
+        reversed += first.distanceTo(next);
+      }
+      if (reversed < current - kMinGain) {
+        reverseRange(i, j);
+        improved = true;
+        break;
+      }
+    }
+  }
+  return improved;
+}
+
+bool Tour::orOptPass() {
+  bool improved = false;
+  for (size_t i = 0; i < size(); ++i) {
+    for (size_t length = 1; length <= kMaxOrOptRun && i + length <= size();
+         ++length) {
+      size_t last = i + length - 1;
+
+      // Travel saved by taking the run out
+      Point2D previous = before(i);
+      Point2D runEntry = entry(i);
+      Point2D runExit = exit(last);
+      double removed = previous.distanceTo(runEntry);
+      if (last + 1 < size()) {
+        Point2D next = entry(last + 1);
+        removed += runExit.distanceTo(next) - previous.distanceTo(next);
+      }
+      if (removed <= kMinGain) {
+        continue;
+      }
+
+      // The run can be cut backwards if nothing in it has to be cut before
+      // another toolpath of it
+      bool canFlip = true;
+      for (size_t k = i; k <= last && canFlip; ++k) {
+        canFlip = flippable(m_order[k]) && !isEarlierAt(m_order[k], i, last);
+      }
+
+      // Insert before tour position g, within the window on either side
+      size_t bestGap = kNone;
+      bool bestFlip = false;
+      double bestAdded = removed - kMinGain;
+      size_t firstGap = i > window() ? i - window() : 0;
+      size_t lastGap = std::min(size(), last + 1 + window());
+      for (size_t g = firstGap; g <= lastGap; ++g) {
+        if (g >= i && g <= last + 1) continue;
+        Point2D from = before(g);
+        double added = from.distanceTo(runEntry);
+        double flipped = from.distanceTo(runExit);
+        if (g < size()) {
+          Point2D to = entry(g);
+          double direct = from.distanceTo(to);
+          added += runExit.distanceTo(to) - direct;
+          flipped += runEntry.distanceTo(to) - direct;
+        }
+        bool flip = canFlip && flipped < added;
+        if (flip) {
+          added = flipped;
+        }
+        if (added >= bestAdded) continue;
+
+        // Toolpaths that must be cut before the run stay before it, those
+        // that must be cut after it stay after it
+        bool allowed = true;
+        for (size_t k = i; k <= last && allowed; ++k) {
+          size_t item = m_order[k];
+          allowed = g < i ? !isEarlierAt(item, g, i - 1)
+                          : !isLaterAt(item, last + 1, g - 1);
+        }
+        if (allowed) {
+          bestGap = g;
+          bestFlip = flip;
+          bestAdded = added;
+        }
+      }
+      if (bestGap == kNone) {
+        continue;
+      }
+
+      size_t first;
+      if (bestGap < i) {
+        rotateRange(bestGap, i, last + 1);
+        first = bestGap;
+      } else {
+        rotateRange(i, last + 1, bestGap);
+        first = bestGap - length;
+      }
+      if (bestFlip) {
+        reverseRange(first, first + length - 1);
+      }
+      improved = true;
+      break;
+    }
+  }
+  return improved;
+}
+
+void Tour::refineSeams() {
+  for (size_t k = 0; k < size(); ++k) {
+    size_t item = m_order[k];
+    if (!m_closed[item] || seamCount(item) == 1) continue;
+
+    // The seam is both the entry and the exit
+    Point2D previous = before(k);
+    bool hasNext = k + 1 < size();
+    Point2D next = hasNext ? entry(k + 1) : Point2D();
+    const PathView &points = m_paths[item];
+    auto cost = [&](size_t v) {
+      return previous.distanceTo(points[v]) +
+             (hasNext ? points[v].distanceTo(next) : 0.0);
+    };
+    double bestCost = cost(m_seam[k]) - kMinGain;
+    for (size_t v = 0; v + 1 < points.size(); ++v) {
+      double vertexCost = cost(v);
+      if (vertexCost < bestCost) {
+        bestCost = vertexCost;
+        m_seam[k] = v;
+      }
+    }
+  }
+}
+
+void Tour::getSteps(const std::vector<size_t> &indices,
+                    std::vector<ToolpathOptimizer::Step> &steps,
+                    ToolpathOrderReport &report) const {
+  for (size_t k = 0; k < size(); ++k) {
+    size_t item = m_order[k];
+    ToolpathOptimizer::Step step;
+    step.index = indices[item];
+    if (m_closed[item]) {
+      step.seam = m_seam[k];
+      report.rotatedLoops += step.seam != 0;
+    } else {
+      step.reversed = m_reversed[k] != 0;
+      report.reversedPaths += step.reversed;
+    }
+    steps.push_back(step);
+  }
+}
+
+void Tour::reverseRange(size_t first, size_t last) {
+  std::reverse(m_order.begin() + first, m_order.begin() + last + 1);
+  std::reverse(m_reversed.begin() + first, m_reversed.begin() + last + 1);
+  std::reverse(m_seam.begin() + first, m_seam.begin() + last + 1);
+  for (size_t k = first; k <= last; ++k) {
+    if (!m_closed[m_order[k]]) {
+      m_reversed[k] = !m_reversed[k];
+    }
+    m_position[m_order[k]] = k;
+  }
+}
+
+void Tour::rotateRange(size_t first, size_t middle, size_t last) {
+  std::rotate(m_order.begin() + first, m_order.begin() + middle,
+              m_order.begin() + last);
+  std::rotate(m_reversed.begin() + first, m_reversed.begin() + middle,
+              m_reversed.begin() + last);
+  std::rotate(m_seam.begin() + first, m_seam.begin() + middle,
+              m_seam.begin() + last);
+  for (size_t k = first; k < last; ++k) {
+    m_position[m_order[k]] = k;
+  }
+}
+
+}  // namespace
+
+ToolpathOrderReport ToolpathOptimizer::optimize(
+    std::vector<Path> &toolpaths, const std::vector<int> &groups) const {
+  ScopedStageTimer timer("path_order");
+
+  ToolpathOrderReport report;
+  report.rapidBefore = rapidDistance(toolpaths, m_options.start);
+
+  // Toolpaths past the end of the groups form one more group
+  auto sameGroup = [&groups](size_t a, size_t b) {
+    if (a >= groups.size() || b >= groups.size()) {
+      return a >= groups.size() && b >= groups.size();
+    }
+    return groups[a] == groups[b];
+  };
+
+  std::vector<PathView> views(toolpaths.begin(), toolpaths.end());
+  std::vector<Step> steps;
+  std::vector<Path> ordered;
+  Point2D position = m_options.start;
+  size_t begin = 0;
+  while (begin < toolpaths.size()) {
+    size_t end = begin + 1;
+    while (end < toolpaths.size() && sameGroup(begin, end)) {
+      ++end;
+    }
+    steps.clear();
+    orderRun(views, begin, end, position, steps, report);
+
+    // Empty toolpaths are not cut; they move to the end of the run
+    ordered.clear();
+    for (const Step &step : steps) {
+      Path &path = toolpaths[step.index];
+      if (step.reversed || step.seam != 0) {
+        ordered.push_back(turnedPath(path, step));
+      } else {
+        ordered.push_back(std::move(path));
+      }
+    }
+    ordered.resize(end - begin);
+    std::move(ordered.begin(), ordered.end(), toolpaths.begin() + begin);
+    if (!steps.empty()) {
+      position = toolpaths[begin + steps.size() - 1].getPoints().back();
+    }
+    begin = end;
+  }
+
+  report.rapidAfter = rapidDistance(toolpaths, m_options.start);
+  reportOrder(toolpaths.size(), report);
+  return report;
+}
+
+ToolpathOrderReport ToolpathOptimizer::order(const PathSet &toolpaths,
+                                             std::vector<Step> &steps) const {
+  ScopedStageTimer timer("path_order");
+
+  ToolpathOrderReport report;
+  std::vector<PathView> views(toolpaths.begin(), toolpaths.end());
+  steps.clear();
+  orderRun(views, 0, views.size(), m_options.start, steps, report);
+
+  std::vector<Step> given;
+  for (size_t i = 0; i < views.size(); ++i) {
+    if (!views[i].empty()) {
+      given.push_back(Step{i});
+    }
+  }
+  report.rapidBefore = orderTravel(views, given, m_options.start);
+  report.rapidAfter = orderTravel(views, steps, m_options.start);
+  reportOrder(toolpaths.size(), report);
+  return report;
+}
+
+void ToolpathOptimizer::applyOrder(const PathSet &toolpaths,
+                                   const std::vector<Step> &steps,
+                                   PathSet &output) {
+  output.clear();
+  output.reserve(steps.size(), toolpaths.pointCount());
+  for (const Step &step : steps) {
+    PathView path = toolpaths[step.index];
+    output.beginPath();
+    for (size_t k = 0; k < path.size(); ++k) {
+      output.addPoint(path[stepPoint(step, path.size(), k)]);
+    }
+  }
+}
+
+double ToolpathOptimizer::rapidDistance(const std::vector<Path> &toolpaths,
+                                        const Point2D &start) {
+  double total = 0.0;
+  Point2D position = start;
+  for (const auto &path : toolpaths) {
+    if (path.empty()) continue;
+    total += position.distanceTo(path.getPoints().front());
+    position = path.getPoints().back();
+  }
+  return total;
+}
+
+void ToolpathOptimizer::orderRun(const std::vector<PathView> &toolpaths,
+                                 size_t begin, size_t end,
+                                 const Point2D &start,
+                                 std::vector<Step> &steps,
+                                 ToolpathOrderReport &report) const {
+  // Empty toolpaths are not cut and get no step
+  std::vector<size_t> indices;
+  std::vector<PathView> paths;
+  for (size_t i = begin; i < end; ++i) {
+    if (!toolpaths[i].empty()) {
+      indices.push_back(i);
+      paths.push_back(toolpaths[i]);
+    }
+  }
+  if (paths.empty()) {
+    return;
+  }
+
+  Tour tour(paths, start, m_options);
+  double given = tour.useGivenOrder() ? tour.travel()
+                                      : std::numeric_limits<double>::max();
+  tour.buildGreedy();
+  if (tour.travel() >= given) {
+    tour.useGivenOrder();
+  }
+  for (int pass = 0; pass < m_options.maxPasses; ++pass) {
+    bool improved = tour.twoOptPass();
+    improved = tour.orOptPass() || improved;
+    if (!improved) break;
+  }
+  if (m_options.rotateLoops) {
+    tour.refineSeams();
+  }
+  tour.getSteps(indices, steps, report);
+}
+
+}  // namespace cnc
+}  // namespace nwss
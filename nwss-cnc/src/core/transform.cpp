@@ -5,6 +5,8 @@
 #include <limits>
 #include <sstream>
 
+#include "core/metrics.h"
+
 namespace nwss {
 namespace cnc {
 
@@ -34,9 +36,16 @@ bool Transform::getBounds(const std::vector<Path> &paths, double &minX,
   return (minX <= maxX && minY <= maxY);
 }
 
-bool Transform::fitToMaterial(std::vector<Path> &paths, const CNConfig &config,
-                              bool preserveAspectRatio, bool centerX,
-                              bool centerY, bool flipY, TransformInfo *info) {
+namespace {
+
+// Shared implementation of both fitToMaterial overloads. The scale, centering
+// and flip steps are composed into one transform and applied in a single pass.
+template <typename Paths>
+bool fitPathsToMaterial(Paths &paths, const CNConfig &config,
+                        bool preserveAspectRatio, bool centerX, bool centerY,
+                        bool flipY, TransformInfo *info) {
+  ScopedStageTimer timer("fit_to_material");
+
   // Get material dimensions from config
   double materialWidth = config.getMaterialWidth();
   double materialHeight = config.getMaterialHeight();
@@ -54,7 +63,7 @@ bool Transform::fitToMaterial(std::vector<Path> &paths, const CNConfig &config,
 
   // Get bounds of the original paths
   double minX, minY, maxX, maxY;
-  if (!getBounds(paths, minX, minY, maxX, maxY)) {
+  if (!Transform::getBounds(paths, minX, minY, maxX, maxY)) {
     info->message = "Error: Could not determine bounds of the paths.";
     return false;
   }
@@ -73,153 +82,66 @@ bool Transform::fitToMaterial(std::vector<Path> &paths, const CNConfig &config,
   double scaleX = materialWidth / info->origWidth;
   double scaleY = materialHeight / info->origHeight;
 
-  // If preserving aspect ratio, use the smaller scale factor
-  double scale = 1.0;
+  // First, translate to origin
+  AffineTransform transform = AffineTransform::translation(-minX, -minY);
+  info->offsetX = -minX;
+  info->offsetY = -minY;
+  info->scaleX = info->scaleY = 1.0;
+
   if (exceedsWidth || exceedsHeight) {
     info->wasScaled = true;
 
     if (preserveAspectRatio) {
-      scale = std::min(scaleX, scaleY);
+      // Use the smaller scale factor on both axes
+      info->scaleX = info->scaleY = std::min(scaleX, scaleY);
     } else {
       // Apply different scaling for X and Y
-      for (auto &path : paths) {
-        std::vector<Point2D> &points =
-            const_cast<std::vector<Point2D> &>(path.getPoints());
-        for (auto &point : points) {
-          point.x = (point.x - minX) * scaleX;
-          point.y = (point.y - minY) * scaleY;
-        }
-      }
-
-      // Update info for non-uniform scaling
       info->scaleX = scaleX;
       info->scaleY = scaleY;
       info->offsetX = -minX * scaleX;
       info->offsetY = -minY * scaleY;
-      info->newWidth = info->origWidth * scaleX;
-      info->newHeight = info->origHeight * scaleY;
-      info->newMinX = 0;
-      info->newMinY = 0;
-
-      // Add positioning offset if centering
-      if (centerX) {
-        double offsetX = (materialWidth - info->newWidth) / 2.0;
-        for (auto &path : paths) {
-          std::vector<Point2D> &points =
-              const_cast<std::vector<Point2D> &>(path.getPoints());
-          for (auto &point : points) {
-            point.x += offsetX;
-          }
-        }
-        info->offsetX += offsetX;
-        info->newMinX = offsetX;
-      }
-
-      if (centerY) {
-        double offsetY = (materialHeight - info->newHeight) / 2.0;
-        for (auto &path : paths) {
-          std::vector<Point2D> &points =
-              const_cast<std::vector<Point2D> &>(path.getPoints());
-          for (auto &point : points) {
-            point.y += offsetY;
-          }
-        }
-        info->offsetY += offsetY;
-        info->newMinY = offsetY;
-      }
-
-      // Flip Y coordinates if needed (CNC often has Y=0 at the front)
-      if (flipY) {
-        for (auto &path : paths) {
-          std::vector<Point2D> &points =
-              const_cast<std::vector<Point2D> &>(path.getPoints());
-          for (auto &point : points) {
-            point.y = materialHeight - point.y;
-          }
-        }
-        info->newMinY = materialHeight - info->newMinY - info->newHeight;
-      }
-
-      info->success = true;
-      return true;
-    }
-  }
-
-  // For uniform scaling or no scaling needed
-  // First, translate to origin
-  double offsetX = -minX;
-  double offsetY = -minY;
-
-  // Apply scale if needed
-  if (info->wasScaled) {
-    for (auto &path : paths) {
-      std::vector<Point2D> &points =
-          const_cast<std::vector<Point2D> &>(path.getPoints());
-      for (auto &point : points) {
-        point.x = (point.x + offsetX) * scale;
-        point.y = (point.y + offsetY) * scale;
-      }
-    }
-  } else {
-    // Just translate to origin
-    for (auto &path : paths) {
-      std::vector<Point2D> &points =
-          const_cast<std::vector<Point2D> &>(path.getPoints());
-      for (auto &point : points) {
-        point.x = point.x + offsetX;
-        point.y = point.y + offsetY;
-      }
     }
+    transform =
+        transform.then(AffineTransform::scaling(info->scaleX, info->scaleY));
   }
 
   // Update scaled dimensions
-  info->newWidth = info->origWidth * (info->wasScaled ? scale : 1.0);
-  info->newHeight = info->origHeight * (info->wasScaled ? scale : 1.0);
-  info->scaleX = info->scaleY = (info->wasScaled ? scale : 1.0);
-  info->offsetX = offsetX;
-  info->offsetY = offsetY;
+  info->newWidth = info->origWidth * info->scaleX;
+  info->newHeight = info->origHeight * info->scaleY;
   info->newMinX = 0;
   info->newMinY = 0;
 
   // Add positioning offset if centering
+  double centerOffsetX = 0.0;
+  double centerOffsetY = 0.0;
   if (centerX) {
-    double centerOffsetX = (materialWidth - info->newWidth) / 2.0;
-    for (auto &path : paths) {
-      std::vector<Point2D> &points =
-          const_cast<std::vector<Point2D> &>(path.getPoints());
-      for (auto &point : points) {
-        point.x += centerOffsetX;
-      }
-    }
+    centerOffsetX = (materialWidth - info->newWidth) / 2.0;
     info->offsetX += centerOffsetX;
     info->newMinX = centerOffsetX;
   }
 
   if (centerY) {
-    double centerOffsetY = (materialHeight - info->newHeight) / 2.0;
-    for (auto &path : paths) {
-      std::vector<Point2D> &points =
-          const_cast<std::vector<Point2D> &>(path.getPoints());
-      for (auto &point : points) {
-        point.y += centerOffsetY;
-      }
-    }
+    centerOffsetY = (materialHeight - info->newHeight) / 2.0;
     info->offsetY += centerOffsetY;
     info->newMinY = centerOffsetY;
   }
+  transform = transform.then(
+      AffineTransform::translation(centerOffsetX, centerOffsetY));
 
   // Flip Y coordinates if needed (CNC often has Y=0 at the front)
   if (flipY) {
-    for (auto &path : paths) {
-      std::vector<Point2D> &points =
-          const_cast<std::vector<Point2D> &>(path.getPoints());
-      for (auto &point : points) {
-        point.y = materialHeight - point.y;
-      }
-    }
+    transform = transform.then(AffineTransform::flipY(materialHeight));
     info->newMinY = materialHeight - info->newMinY - info->newHeight;
   }
 
+  Transform::applyTransform(paths, transform);
+
+  // Non-uniform scaling is reported without a summary message
+  if (info->wasScaled && !preserveAspectRatio) {
+    info->success = true;
+    return true;
+  }
+
   // Generate message with transform information
   std::stringstream msgStream;
   if (info->wasScaled) {
@@ -243,6 +165,60 @@ bool Transform::fitToMaterial(std::vector<Path> &paths, const CNConfig &config,
   return true;
 }
 
+}  // namespace
+
+bool Transform::getBounds(const PathSet &paths, double &minX, double &minY,
+                          double &maxX, double &maxY) {
+  size_t count = paths.pointCount();
+  if (count == 0) {
+    return false;
+  }
+
+  const double *xs = paths.xData();
+  const double *ys = paths.yData();
+  minX = maxX = xs[0];
+  minY = maxY = ys[0];
+  for (size_t i = 1; i < count; ++i) {
+    minX = std::min(minX, xs[i]);
+    maxX = std::max(maxX, xs[i]);
+    minY = std::min(minY, ys[i]);
+    maxY = std::max(maxY, ys[i]);
+  }
+
+  return true;
+}
+
+void Transform::applyTransform(std::vector<Path> &paths,
+                               const AffineTransform &transform) {
+  if (transform.isIdentity()) {
+    return;
+  }
+  for (auto &path : paths) {
+    path.transform(transform);
+  }
+}
+
+void Transform::applyTransform(PathSet &paths,
+                               const AffineTransform &transform) {
+  if (!transform.isIdentity()) {
+    paths.transform(transform);
+  }
+}
+
+bool Transform::fitToMaterial(std::vector<Path> &paths, const CNConfig &config,
+                              bool preserveAspectRatio, bool centerX,
+                              bool centerY, bool flipY, TransformInfo *info) {
+  return fitPathsToMaterial(paths, config, preserveAspectRatio, centerX,
+                            centerY, flipY, info);
+}
+
+bool Transform::fitToMaterial(PathSet &paths, const CNConfig &config,
+                              bool preserveAspectRatio, bool centerX,
+                              bool centerY, bool flipY, TransformInfo *info) {
+  return fitPathsToMaterial(paths, config, preserveAspectRatio, centerX,
+                            centerY, flipY, info);
+}
+
 std::string Transform::formatTransformInfo(const TransformInfo &info,
                                            const CNConfig &config) {
   std::stringstream ss;
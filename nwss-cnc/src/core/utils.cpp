@@ -2,10 +2,10 @@
 
 #include <fstream>
 #include <iomanip>
-#include <iostream>
 #include <sstream>
 
 #include "core/config.h"
+#include "core/log.h"
 #include "core/svg_parser.h"
 
 namespace nwss {
@@ -15,8 +15,7 @@ bool Utils::savePathsToCSV(const std::vector<Path> &paths,
                            const std::string &filename) {
   std::ofstream outFile(filename);
   if (!outFile.is_open()) {
-    std::cerr << "Error: Could not open file for writing: " << filename
-              << std::endl;
+    NWSS_LOG_ERROR("Could not open file for writing: " << filename);
     return false;
   }
 
@@ -46,8 +45,7 @@ bool Utils::generateVisualization(const std::string &sourceFile,
   // Parse the original SVG to get dimensions and shapes
   SVGParser parser;
   if (!parser.loadFromFile(sourceFile)) {
-    std::cerr << "Error: Could not load source SVG file for visualization."
-              << std::endl;
+    NWSS_LOG_ERROR("Could not load source SVG file for visualization.");
     return false;
   }
 
@@ -81,8 +79,7 @@ bool Utils::generateVisualization(const std::string &sourceFile,
 
   std::ofstream vizFile(outputFile);
   if (!vizFile.is_open()) {
-    std::cerr << "Error: Could not open file for writing: " << outputFile
-              << std::endl;
+    NWSS_LOG_ERROR("Could not open file for writing: " << outputFile);
     return false;
   }
 
@@ -169,8 +166,7 @@ bool Utils::generateMaterialVisualization(const std::vector<Path> &paths,
   // Create SVG file
   std::ofstream vizFile(outputFile);
   if (!vizFile.is_open()) {
-    std::cerr << "Error: Could not open file for writing: " << outputFile
-              << std::endl;
+    NWSS_LOG_ERROR("Could not open file for writing: " << outputFile);
     return false;
   }
 
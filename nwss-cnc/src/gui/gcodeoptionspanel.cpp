@@ -222,6 +222,7 @@ void GCodeOptionsPanel::setupCuttingTab() {
   cutoutModeComboBox->addItem("Punchout", 1);
   // cutoutModeComboBox->addItem("Pocket", 2);
   // cutoutModeComboBox->addItem("Engrave", 3);
+  cutoutModeComboBox->addItem("Adaptive Clearing", 4);
   cutoutModeComboBox->setCurrentIndex(0);
   cutoutModeLayout->addWidget(cutoutModeComboBox);
   groupLayout->addLayout(cutoutModeLayout);
@@ -598,7 +599,7 @@ double GCodeOptionsPanel::getSafetyHeight() const {
 
 // Cutout mode settings
 int GCodeOptionsPanel::getCutoutMode() const {
-  return cutoutModeComboBox->currentIndex();
+  return cutoutModeComboBox->currentData().toInt();
 }
 
 double GCodeOptionsPanel::getStepover() const {
@@ -27,6 +27,7 @@
 #include "discretizer.h"
 #include "gcode_generator.h"
 #include "gcodeoptionspanel.h"
+#include "metrics.h"
 #include "svg_parser.h"
 #include "transform.h"
 
@@ -634,6 +635,11 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
     settings.setValue("lastSelectedToolId", selectedToolId);
   }
 
+  // Collect stage timings and counters from the core library. The profiler is
+  // paused while modal dialogs wait for the user.
+  nwss::cnc::PipelineProfiler profiler;
+  profiler.start();
+
   try {
     // Step 1: Parse SVG with the design transformation parameters
     nwss::cnc::SVGParser parser;
@@ -735,32 +741,22 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
         qDebug() << "Calculated uniform scale:" << uniformScale;
         qDebug() << "Designer reported scale:" << designScale;
 
-        // Apply the uniform scale and position transformation
-        for (auto &path : paths) {
-          std::vector<nwss::cnc::Point2D> &points =
-              const_cast<std::vector<nwss::cnc::Point2D> &>(path.getPoints());
-          for (auto &point : points) {
-            // Translate to origin
-            point.x -= origMinX;
-            point.y -= origMinY;
-
-            // Apply uniform scale
-            point.x *= uniformScale;
-            point.y *= uniformScale;
-
-            // Calculate centered position within design bounds
-            double scaledWidth = origWidth * uniformScale;
-            double scaledHeight = origHeight * uniformScale;
-
-            // Center the scaled design within the design bounds
-            double centerOffsetX = (designBounds.width() - scaledWidth) / 2.0;
-            double centerOffsetY = (designBounds.height() - scaledHeight) / 2.0;
-
-            // Apply final position
-            point.x += designBounds.left() + centerOffsetX;
-            point.y += designBounds.top() + centerOffsetY;
-          }
-        }
+        // Compose the uniform scale and position transformation; it is
+        // applied in one pass once the bounds checks below have passed
+        double scaledWidth = origWidth * uniformScale;
+        double scaledHeight = origHeight * uniformScale;
+
+        // Center the scaled design within the design bounds
+        double centerOffsetX = (designBounds.width() - scaledWidth) / 2.0;
+        double centerOffsetY = (designBounds.height() - scaledHeight) / 2.0;
+
+        nwss::cnc::AffineTransform designTransform =
+            nwss::cnc::AffineTransform::translation(-origMinX, -origMinY)
+                .then(nwss::cnc::AffineTransform::scaling(uniformScale,
+                                                          uniformScale))
+                .then(nwss::cnc::AffineTransform::translation(
+                    designBounds.left() + centerOffsetX,
+                    designBounds.top() + centerOffsetY));
 
         // Update transform info with correct values
         transformInfo.origWidth = origWidth;
@@ -867,10 +863,12 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
           warningBox.button(QMessageBox::Yes)->setText(tr("Continue Anyway"));
           warningBox.button(QMessageBox::Cancel)->setText(tr("Cancel"));
 
+          profiler.stop();
           int result = warningBox.exec();
           if (result != QMessageBox::Yes) {
             return;  // User cancelled
           }
+          profiler.start();
 
           // User chose to continue, add warnings to transform info
           transformInfo.message += " - WARNING: Design exceeds bounds!";
@@ -879,15 +877,12 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
 
         // Apply Y-flip if requested (after designer transformations)
         if (gcodeOptionsPanel->getFlipY()) {
-          for (auto &path : paths) {
-            std::vector<nwss::cnc::Point2D> &points =
-                const_cast<std::vector<nwss::cnc::Point2D> &>(path.getPoints());
-            for (auto &point : points) {
-              point.y = materialHeight - point.y;
-            }
-          }
+          designTransform = designTransform.then(
+              nwss::cnc::AffineTransform::flipY(materialHeight));
           transformInfo.message += " (Y-flipped)";
         }
+
+        nwss::cnc::Transform::applyTransform(paths, designTransform);
       }
     } else {
       // No meaningful designer transformations, use standard material fitting
@@ -919,6 +914,7 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
     gCodeOptions.optimizePaths = gcodeOptionsPanel->getOptimizePaths();
     gCodeOptions.linearizePaths = gcodeOptionsPanel->getLinearizePaths();
     gCodeOptions.linearizeTolerance = 0.01;
+    gCodeOptions.maxSegmentLength = discretizerConfig.maxPointDistance;
     gCodeOptions.includeComments = false;
     gCodeOptions.includeHeader = true;
     gCodeOptions.returnToOrigin = true;
@@ -950,12 +946,14 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
         }
         warningText += tr("\nContinue with G-code generation?");
 
+        profiler.stop();
         int result = QMessageBox::question(
             this, tr("Tool Validation Warning"), warningText,
             QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
         if (result != QMessageBox::Yes) {
           return;
         }
+        profiler.start();
       }
     }
 
@@ -969,6 +967,10 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
       return;
     }
 
+    profiler.stop();
+    lastPipelineStats = profiler.stats();
+    qDebug().noquote() << QString::fromStdString(lastPipelineStats.summary());
+
     // Step 9: Display the generated G-code
     gCodeEditor->setPlainText(gCode);
     setCurrentFile("");
@@ -980,7 +982,9 @@ void MainWindow::convertSvgToGCode(const QString &svgFile) {
     // Update the time estimate label
     updateTimeEstimateLabel(estimate.totalTime);
 
-    statusBar()->showMessage("Generated successfully.");
+    statusBar()->showMessage(
+        tr("Generated successfully in %1 ms.")
+            .arg(lastPipelineStats.totalMilliseconds, 0, 'f', 0));
   } catch (const std::exception &e) {
     QMessageBox::critical(
         this, tr("Conversion Error"),
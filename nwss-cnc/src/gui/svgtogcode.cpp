@@ -3,7 +3,6 @@
 
 #include <QDateTime>
 #include <QDebug>
-#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 
@@ -28,23 +27,20 @@ QString SvgToGCode::convertSvgToGCode(
     bool flipY, bool optimizePaths, bool closeLoops, bool separateRetract,
     bool linearizePaths, double linearizeTolerance, double toolDiameter,
     int cutoutMode, double stepover, double maxStepover, bool spiralIn) {
-  QElapsedTimer totalTimer;
-  totalTimer.start();
-
   m_lastError.clear();
-  QElapsedTimer stepTimer;
+
+  // Collect stage timings and counters from the core library
+  nwss::cnc::PipelineProfiler profiler;
+  profiler.start();
 
   // Step 1: Load SVG file
-  stepTimer.start();
   nwss::cnc::SVGParser parser;
   if (!parser.loadFromFile(svgFilePath.toStdString(), "mm", 96.0f)) {
     m_lastError = "Failed to load SVG file: " + svgFilePath;
     return QString();
   }
-  qDebug() << "Step 1: SVG loading took" << stepTimer.elapsed() << "ms";
 
   // Step 2: Get dimensions and detect content bounds
-  stepTimer.restart();
   float width, height;
   if (parser.getDimensions(width, height)) {
     qDebug() << "Original SVG Dimensions: " << width << " x " << height
@@ -65,10 +61,8 @@ QString SvgToGCode::convertSvgToGCode(
   } else {
     qDebug() << "No content bounds detected, using original dimensions";
   }
-  qDebug() << "Step 2: Get dimensions took" << stepTimer.elapsed() << "ms";
 
   // Step 3: Configure discretizer
-  stepTimer.restart();
   nwss::cnc::Discretizer discretizer;
   nwss::cnc::DiscretizerConfig discretizerConfig;
   discretizerConfig.bezierSamples = bezierSamples;
@@ -90,27 +84,21 @@ QString SvgToGCode::convertSvgToGCode(
   CNconfig.setCutDepth(passDepth);
   CNconfig.setPassCount(passCount);
   CNconfig.setSafeHeight(safetyHeight);
-  qDebug() << "Step 3: Configuration took" << stepTimer.elapsed() << "ms";
 
   // Step 4: Discretize SVG paths
-  stepTimer.restart();
   std::vector<nwss::cnc::Path> allPaths =
       discretizer.discretizeImage(parser.getRawImage());
-  qDebug() << "Step 4: Path discretization took" << stepTimer.elapsed() << "ms"
-           << "(" << allPaths.size() << " paths)";
+  qDebug() << "Discretized" << allPaths.size() << "paths";
 
   // Step 5: Get bounds for diagnostics
-  stepTimer.restart();
   double minX, minY, maxX, maxY;
   if (nwss::cnc::Transform::getBounds(allPaths, minX, minY, maxX, maxY)) {
     double width = maxX - minX;
     double height = maxY - minY;
     qDebug() << "Paths bounds:" << minX << minY << maxX << maxY;
   }
-  qDebug() << "Step 5: Get bounds took" << stepTimer.elapsed() << "ms";
 
   // Step 6: Transform paths to fit material
-  stepTimer.restart();
   nwss::cnc::TransformInfo transformInfo;
   if (nwss::cnc::Transform::fitToMaterial(
           allPaths, CNconfig, preserveAspectRatio, centerDesign, centerDesign,
@@ -120,10 +108,8 @@ QString SvgToGCode::convertSvgToGCode(
     m_lastError = "Failed to fit paths to material.";
     return QString();
   }
-  qDebug() << "Step 6: Transform paths took" << stepTimer.elapsed() << "ms";
 
   // Step 7: Generate GCode
-  stepTimer.restart();
   nwss::cnc::GCodeGenerator gCodeGen;
   nwss::cnc::GCodeOptions gCodeOptions;
   gCodeOptions.optimizePaths = optimizePaths;
@@ -131,6 +117,7 @@ QString SvgToGCode::convertSvgToGCode(
   gCodeOptions.separateRetract = separateRetract;
   gCodeOptions.linearizePaths = linearizePaths;
   gCodeOptions.linearizeTolerance = linearizeTolerance;
+  gCodeOptions.maxSegmentLength = maxPointDistance;
   // Note: Tool selection should be handled by the GUI, for now disable tool
   // offsets
   gCodeOptions.enableToolOffsets = false;
@@ -151,12 +138,10 @@ QString SvgToGCode::convertSvgToGCode(
     return QString();
   }
   QString gCodeString = QString::fromStdString(gCode);
-  qDebug() << "Step 7: GCode generation took" << stepTimer.elapsed() << "ms"
-           << "(GCode size:" << gCodeString.size() << "bytes)";
 
-  // Total time
-  qDebug() << "Total SVG to GCode conversion took" << totalTimer.elapsed()
-           << "ms";
+  profiler.stop();
+  m_pipelineStats = profiler.stats();
+  qDebug().noquote() << QString::fromStdString(m_pipelineStats.summary());
 
   // Calculate and store time estimate
   m_timeEstimate.rapidTime = 0;
@@ -124,6 +124,12 @@ void ToolManager::setupToolEditor() {
   m_fluteCountSpin->setRange(1, 8);
   m_editorLayout->addRow("Flute Count:", m_fluteCountSpin);
 
+  m_tipAngleSpin = new QDoubleSpinBox(this);
+  m_tipAngleSpin->setRange(0.0, 179.0);
+  m_tipAngleSpin->setDecimals(1);
+  m_tipAngleSpin->setSuffix("°");
+  m_editorLayout->addRow("Tip Angle:", m_tipAngleSpin);
+
   // Material and coating
   m_materialCombo = new QComboBox(this);
   m_materialCombo->addItem("Wood", static_cast<int>(ToolMaterial::WOOD));
@@ -256,6 +262,7 @@ void ToolManager::clearToolEditor() {
   m_lengthSpin->setValue(0.0);
   m_fluteLengthSpin->setValue(0.0);
   m_fluteCountSpin->setValue(2);
+  m_tipAngleSpin->setValue(0.0);
   m_materialCombo->setCurrentIndex(0);
   m_coatingCombo->setCurrentIndex(0);
   m_maxDepthSpin->setValue(0.0);
@@ -274,6 +281,7 @@ void ToolManager::loadToolToEditor(const Tool &tool) {
   m_lengthSpin->setValue(tool.length);
   m_fluteLengthSpin->setValue(tool.fluteLength);
   m_fluteCountSpin->setValue(tool.fluteCount);
+  m_tipAngleSpin->setValue(tool.tipAngle);
   m_materialCombo->setCurrentIndex(
       m_materialCombo->findData(static_cast<int>(tool.material)));
   m_coatingCombo->setCurrentIndex(
@@ -294,6 +302,7 @@ Tool ToolManager::getToolFromEditor() const {
   tool.length = m_lengthSpin->value();
   tool.fluteLength = m_fluteLengthSpin->value();
   tool.fluteCount = m_fluteCountSpin->value();
+  tool.tipAngle = m_tipAngleSpin->value();
   tool.material =
       static_cast<ToolMaterial>(m_materialCombo->currentData().toInt());
   tool.coating =
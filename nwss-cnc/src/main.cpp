@@ -5,6 +5,7 @@
 #include <QStyleFactory>
 #include <QSurfaceFormat>
 
+#include "core/log.h"
 #include "mainwindow.h"
 
 void setBlackOrangeTheme(QApplication &app) {
@@ -95,6 +96,26 @@ int main(int argc, char *argv[]) {
 
   QApplication app(argc, argv);
 
+  // Route core library log messages through the Qt message handler
+  nwss::cnc::Log::setSink(
+      [](nwss::cnc::LogLevel level, const std::string &message) {
+        QString text = QString::fromStdString(message);
+        switch (level) {
+          case nwss::cnc::LogLevel::DEBUG:
+            qDebug().noquote() << text;
+            break;
+          case nwss::cnc::LogLevel::INFO:
+            qInfo().noquote() << text;
+            break;
+          case nwss::cnc::LogLevel::WARN:
+            qWarning().noquote() << text;
+            break;
+          default:
+            qCritical().noquote() << text;
+            break;
+        }
+      });
+
   // Set application information
   app.setApplicationName("NWSS-CNC");
   app.setOrganizationName("NWSS");